@@ -14,12 +14,21 @@
    #define _POSIX_C_SOURCE
  #endif
  #include <string.h>
+ #ifdef LIBAKRYPT_HAVE_PTHREAD
+  #include <pthread.h>
+ #endif
 
 /* ----------------------------------------------------------------------------------------------- */
  int aktool_icode_help( void );
  int aktool_icode_function( const char * , ak_pointer );
  int aktool_icode_check_function( char * , ak_pointer );
  bool_t aktool_create_handle( void );
+ bool_t aktool_icode_queue_create( void );
+ void aktool_icode_queue_flush( void );
+ void aktool_icode_queue_destroy( void );
+ int aktool_icode_index_close( void );
+ int aktool_icode_file( ak_handle , const char * , ak_uint8 * , const size_t ,
+                                                                       const bool_t , size_t * );
 
 
 #if defined(_WIN32) || defined(_WIN64)
@@ -77,8 +86,144 @@
     bool_t tree;
    /*! Флаг совместимости с библиотекой openssl */
     bool_t openssl;
+   /*! \brief Флаг использования дерева хеш-кодов */
+    bool_t tree_flag;
+   /*! \brief Флаг сохранения деревьев хеш-кодов */
+    bool_t save_tree;
+   /*! \brief Размер фрагмента файла, используемого при построении дерева хеш-кодов */
+    size_t chunk_size;
+   /*! \brief Количество потоков, вычисляющих дерево хеш-кодов */
+    size_t threads;
+   /*! \brief Имя функции хеширования, используемой при построении дерева */
+    char tree_algorithm[128];
+   /*! \brief Количество потоков, одновременно вычисляющих контрольные суммы различных файлов */
+    size_t jobs;
+   /*! \brief Имя файла с индексом ранее вычисленных контрольных сумм */
+    char *indexfile;
+   /*! \brief Флаг игнорирования сохраненного индекса (все контрольные суммы вычисляются заново) */
+    bool_t rehash;
 } ic;
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Максимальное количество файлов, помещаемых в очередь до начала их обработки */
+ #define aktool_icode_queue_size   (4096)
+
+/*! \brief Запись индекса: атрибуты файла на момент вычисления его контрольной суммы */
+ typedef struct icode_entry {
+   /*! \brief Имя файла */
+    char *filename;
+   /*! \brief Размер файла */
+    ak_uint64 size;
+   /*! \brief Время последней модификации содержимого файла */
+    ak_uint64 mtime;
+   /*! \brief Время последнего изменения атрибутов файла */
+    ak_uint64 ctime;
+   /*! \brief Номер индексного дескриптора файла */
+    ak_uint64 inode;
+   /*! \brief Время создания записи; нулевое значение означает, что запись недействительна */
+    ak_uint64 stamp;
+   /*! \brief Порядковый номер записи, используемый при упорядочивании записей с одинаковыми
+       именами файлов */
+    size_t number;
+   /*! \brief Контрольная сумма файла */
+    ak_uint8 icode[64];
+} *ak_icode_entry;
+
+/*! \brief Задание на вычисление контрольной суммы одного файла */
+ typedef struct icode_task {
+   /*! \brief Имя файла */
+    char *filename;
+   /*! \brief Вычисленное значение контрольной суммы */
+    ak_uint8 out[127];
+   /*! \brief Код ошибки, возникшей при вычислении контрольной суммы */
+    int error;
+   /*! \brief Флаг того, что контрольная сумма взята из индекса и не должна вычисляться */
+    bool_t indexed;
+   /*! \brief Проверяемое значение контрольной суммы (при проверке) */
+    ak_uint8 icode[64];
+   /*! \brief Количество измененных фрагментов файла (при проверке с помощью дерева хеш-кодов) */
+    size_t wrong;
+   /*! \brief Атрибуты файла, полученные перед вычислением контрольной суммы */
+    struct icode_entry attributes;
+} *ak_icode_task;
+
+/*! \brief Очередь файлов, контрольные суммы которых вычисляются несколькими потоками */
+ static struct icode_queue {
+   /*! \brief Массив дескрипторов алгоритма, каждый поток использует собственный дескриптор */
+    ak_handle *handles;
+   /*! \brief Количество созданных дескрипторов (потоков) */
+    size_t jobs;
+   /*! \brief Массив заданий */
+    struct icode_task *tasks;
+   /*! \brief Количество заданий, помещенных в очередь */
+    size_t count;
+   /*! \brief Индекс первого задания, которое еще не взято на обработку */
+    size_t next;
+   /*! \brief Флаг того, что задания являются проверкой ранее вычисленных контрольных сумм */
+    bool_t check;
+  #ifdef LIBAKRYPT_HAVE_PTHREAD
+   /*! \brief Мьютекс, защищающий индекс следующего задания */
+    pthread_mutex_t mutex;
+  #endif
+} iq;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сигнатура файла с индексом контрольных сумм */
+ #define aktool_icode_index_magic   "akindex2"
+
+/*! \brief Индекс контрольных сумм, позволяющий не вычислять заново суммы неизмененных файлов */
+ static struct icode_index {
+   /*! \brief Массив записей; первые `loaded` записей упорядочены по именам файлов */
+    struct icode_entry *entries;
+   /*! \brief Общее количество записей */
+    size_t count;
+   /*! \brief Количество записей, считанных из файла */
+    size_t loaded;
+   /*! \brief Размер выделенной под записи памяти (в записях) */
+    size_t allocated;
+   /*! \brief Длина контрольной суммы */
+    size_t hsize;
+   /*! \brief Флаг того, что индекс считан (или создан) */
+    bool_t opened;
+   /*! \brief Флаг того, что индекс изменился и должен быть сохранен */
+    bool_t changed;
+   /*! \brief Количество файлов, контрольные суммы которых взяты из индекса */
+    size_t skipped;
+   /*! \brief Имя алгоритма, для которого создан индекс */
+    char algorithm[256];
+} ix;
+
+/* ----------------------------------------------------------------------------------------------- */
+/* разбор строки с размером, допускаются суффиксы K, M и G;
+   для некорректной строки или слишком большого значения возвращается ноль */
+ static size_t aktool_icode_get_size( const char *str )
+{
+  char *end = NULL;
+  unsigned int shift = 0;
+  size_t value = 0;
+
+  if(( *str < '0' ) || ( *str > '9' )) return 0;
+  value = ( size_t ) strtoul( str, &end, 10 );
+  switch( *end ) {
+    case 'k': case 'K': shift = 10; end++; break;
+    case 'm': case 'M': shift = 20; end++; break;
+    case 'g': case 'G': shift = 30; end++; break;
+    default: break;
+  }
+  if( *end != 0 ) return 0;
+  if( value > ((( size_t )-1 ) >> shift )) return 0;
+ return value << shift;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* проверка, является ли заданный файл сохраненным деревом хеш-кодов */
+ static bool_t aktool_icode_is_tree_file( const char *filename )
+{
+  size_t len = strlen( filename );
+  if(( len > 7 ) && !strcmp( filename + len - 7, ".aktree" )) return ak_true;
+ return ak_false;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  int aktool_icode( int argc, TCHAR *argv[] )
 {
@@ -107,6 +252,12 @@
      { "salt",                1, NULL,  245 },
      { "salt-len",            1, NULL,  244 },
      { "key",                 1, NULL,  'k' },
+     { "chunk-size",          1, NULL,  243 },
+     { "threads",             1, NULL,  242 },
+     { "save-tree",           0, NULL,  241 },
+     { "jobs",                1, NULL,  'j' },
+     { "index",               1, NULL,  240 },
+     { "rehash",              0, NULL,  239 },
 
     /* потом общие */
      { "dont-use-colors",     0, NULL,   3 },
@@ -150,10 +301,24 @@
   ic.hexstr = NULL;
   ic.keyfile = NULL;
   ic.openssl = ak_false;
+  ic.tree_flag = ak_false;
+  ic.save_tree = ak_false;
+  ic.chunk_size = 0;
+ #if defined(LIBAKRYPT_HAVE_UNISTD_H) && defined(_SC_NPROCESSORS_ONLN)
+  if(( ic.threads = ( size_t ) sysconf( _SC_NPROCESSORS_ONLN )) < 1 ) ic.threads = 1;
+ #else
+  ic.threads = 1;
+ #endif
+  memset( ic.tree_algorithm, 0, sizeof( ic.tree_algorithm ));
+  ic.jobs = 1;
+  memset( &iq, 0, sizeof( struct icode_queue ));
+  ic.indexfile = NULL;
+  ic.rehash = ak_false;
+  memset( &ix, 0, sizeof( struct icode_index ));
 
  /* разбираем опции командной строки */
   do {
-       next_option = getopt_long( argc, argv, "a:c:t:o:k:rp", long_options, NULL );
+       next_option = getopt_long( argc, argv, "a:c:t:o:k:j:rp", long_options, NULL );
        switch( next_option )
       {
        /* сначала обработка стандартных опций */
@@ -258,6 +423,33 @@
                      ic.keyfile_flag = ak_true;
                      break;
 
+         case 243:  /* размер фрагмента для дерева хеш-кодов */
+                     if(( ic.chunk_size = aktool_icode_get_size( optarg )) == 0 ) {
+                       aktool_error(_("incorrect size of file chunk: %s"), optarg );
+                       goto lab_exit;
+                     }
+                     break;
+
+         case 242:  /* количество потоков */
+                     ic.threads = ak_max( 1, atoi( optarg ));
+                     break;
+
+         case 241:  /* сохранять деревья хеш-кодов */
+                     ic.save_tree = ak_true;
+                     break;
+
+         case 'j':  /* количество одновременно обрабатываемых файлов */
+                     ic.jobs = ak_max( 1, atoi( optarg ));
+                     break;
+
+         case 240:  /* файл с индексом контрольных сумм */
+                     ic.indexfile = optarg;
+                     break;
+
+         case 239:  /* игнорировать сохраненные в индексе значения */
+                     ic.rehash = ak_true;
+                     break;
+
          default:   /* обрабатываем ошибочные параметры */
                      if( next_option != -1 ) work = do_nothing;
                      break;
@@ -285,6 +477,8 @@
       if( optind < argc ) {
        /* создаем дескриптор алгоритма */
         if( !aktool_create_handle( )) goto lab_exit;
+       /* создаем очередь файлов для параллельной обработки */
+        if( !aktool_icode_queue_create( )) goto lab_exit;
        /* перебираем возможные значения */
         while( optind < argc ) {
            char *value = argv[optind++];
@@ -298,6 +492,9 @@
                 break;
            }
         }
+       /* обрабатываем файлы, оставшиеся в очереди */
+        aktool_icode_queue_flush();
+        aktool_icode_queue_destroy();
 
     } else {
         exit_status = EXIT_FAILURE;
@@ -333,6 +530,9 @@
     case do_check: /* проверяем контрольную сумму */
       if(( error = ak_file_read_by_lines( ic.checkfile, aktool_icode_check_function, NULL )) == ak_error_ok )
         exit_status = EXIT_SUCCESS;
+     /* проверяем файлы, оставшиеся в очереди */
+      aktool_icode_queue_flush();
+      aktool_icode_queue_destroy();
       if( !ic.status ) {
         if( !ic.dont_stat_show ) {
           printf(_("\n%s [%lu lines, %lu files, where: correct %lu, wrong %lu]\n"),
@@ -351,6 +551,7 @@
 
  /* корректно завершаем работу */
   lab_exit:
+   aktool_icode_index_close();
    if( ic.outfp != NULL ) fclose( ic.outfp );
    ak_libakrypt_destroy();
 
@@ -383,9 +584,20 @@
     ic.algorithm_ni = (char *)oid.names[0];
   }
    else {
+     char *name = ic.algorithm_ni;
+     size_t len = strlen( ic.algorithm_ni );
+
+    /* имя вида "функция-tree" означает использование дерева хеш-кодов */
+     if(( len > 5 ) && !strcmp( ic.algorithm_ni + len - 5, "-tree" )) {
+       ic.tree_flag = ak_true;
+       memset( ic.tree_algorithm, 0, sizeof( ic.tree_algorithm ));
+       strncpy( ic.tree_algorithm, ic.algorithm_ni,
+                                               ak_min( len - 5, sizeof( ic.tree_algorithm ) -1 ));
+       name = ic.tree_algorithm;
+     }
     /* в альтернативной ветке создаем ключ с нуля:
        дескриптор алгоритма запрошенного пользователем алгоритма */
-     if(( ic.handle = ak_handle_new( ic.algorithm_ni, NULL )) == ak_error_wrong_handle ) {
+     if(( ic.handle = ak_handle_new( name, NULL )) == ak_error_wrong_handle ) {
        aktool_error(_("\"%s\" is incorrect name/identifier for hash or mac function"),
                                                                                  ic.algorithm_ni );
        return ak_false;
@@ -402,6 +614,10 @@
  /* проверяем, что алгоритм допускает использование ключа */
   if( ak_handle_check_secret_key( ic.handle )) {
 
+    if( ic.tree_flag ) {
+      aktool_error(_("hash tree can be used only with keyless hash functions"));
+      return ak_false;
+    }
     if( ic.keyfile_flag ) goto lab_iv; /* уже все создано */
     if( ic.hexkey_flag ) {
        if(( error =
@@ -446,17 +662,561 @@
  return ak_true;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/* целые числа записываются в индекс в формате big endian */
+ static void aktool_icode_index_put( ak_uint8 *buffer, ak_uint64 value, size_t len )
+{
+  while( len-- > 0 ) {
+    buffer[len] = ( ak_uint8 )( value&0xFF );
+    value >>= 8;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_uint64 aktool_icode_index_get( const ak_uint8 *buffer, const size_t len )
+{
+  size_t i = 0;
+  ak_uint64 value = 0;
+
+  for( i = 0; i < len; i++ ) value = ( value << 8 )^buffer[i];
+ return value;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* сравнение записей по именам файлов, используется для поиска записи */
+ static int aktool_icode_index_compare( const void *left, const void *right )
+{
+ return strcmp((( ak_icode_entry )left )->filename, (( ak_icode_entry )right )->filename );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* сравнение записей по именам файлов и порядковым номерам; функция qsort() не является
+   устойчивой, поэтому для записей с одинаковыми именами порядок задается номерами */
+ static int aktool_icode_index_compare_order( const void *left, const void *right )
+{
+  int result = aktool_icode_index_compare( left, right );
+
+  if( result ) return result;
+  if((( ak_icode_entry )left )->number < (( ak_icode_entry )right )->number ) return -1;
+ return (( ak_icode_entry )left )->number > (( ak_icode_entry )right )->number;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* получение атрибутов файла */
+ static bool_t aktool_icode_index_stat( const char *filename, ak_icode_entry entry )
+{
+  struct stat st;
+
+  if( stat( filename, &st )) return ak_false;
+  entry->size = ( ak_uint64 ) st.st_size;
+  entry->mtime = ( ak_uint64 ) st.st_mtime;
+  entry->ctime = ( ak_uint64 ) st.st_ctime;
+  entry->inode = ( ak_uint64 ) st.st_ino;
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* получение атрибутов файла перед вычислением его контрольной суммы; ненулевое значение
+   поля stamp означает, что атрибуты получены */
+ static void aktool_icode_index_prepare( const char *filename, ak_icode_entry attributes )
+{
+  memset( attributes, 0, sizeof( struct icode_entry ));
+  if( ic.indexfile == NULL ) return;
+  if( aktool_icode_index_stat( filename, attributes )) attributes->stamp = 1;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* имитовставка, вычисляемая от сигнатуры, размера фрагмента дерева и всего содержимого индекса;
+   первые 16 октетов массива data заполняются функцией, за ними должно следовать содержимое
+   индекса. Имитовставка связывает индекс с алгоритмом, ключом и размером фрагмента дерева,
+   а также защищает записи индекса от изменения */
+ static int aktool_icode_index_mac( ak_uint8 *data, const size_t size, ak_uint8 *out )
+{
+  memcpy( data, aktool_icode_index_magic, 8 );
+  aktool_icode_index_put( data +8, ic.chunk_size, 8 );
+ return ak_handle_mac_ptr( ic.handle, data, size, out, ix.hsize );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* добавление новой записи в конец массива */
+ static ak_icode_entry aktool_icode_index_append( const char *filename )
+{
+  size_t len = strlen( filename );
+  ak_icode_entry entry = NULL;
+
+  if( ix.count == ix.allocated ) {
+    size_t allocated = ak_max( 1024, ix.allocated << 1 );
+    if(( entry = realloc( ix.entries, allocated*sizeof( struct icode_entry ))) == NULL ) {
+      ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+      return NULL;
+    }
+    ix.entries = entry;
+    ix.allocated = allocated;
+  }
+
+  entry = ix.entries + ix.count;
+  memset( entry, 0, sizeof( struct icode_entry ));
+  if(( entry->filename = malloc( len +1 )) == NULL ) {
+    ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+    return NULL;
+  }
+  memcpy( entry->filename, filename, len +1 );
+  entry->number = ix.count++;
+
+ return entry;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* считывание индекса; если файл отсутствует, поврежден, изменен или создан для другого
+   алгоритма, то индекс считается пустым и будет создан заново */
+ static bool_t aktool_icode_index_open( void )
+{
+  struct stat st;
+  FILE *fp = NULL;
+  size_t i = 0, len = 0, total = 0;
+  ak_icode_entry entry = NULL;
+  ak_uint8 *data = NULL, *ptr = NULL, *end = NULL, check[64], prefix[16];
+  char filename[FILENAME_MAX];
+
+  if( ix.opened ) return ak_true;
+  if(( ic.indexfile == NULL ) || ( ic.handle == ak_error_wrong_handle )) return ak_false;
+  if(( ix.hsize = ak_handle_get_tag_size( ic.handle )) > sizeof( check )) return ak_false;
+  if( strlen( ic.algorithm_ni ) >= sizeof( ix.algorithm )) return ak_false;
+  if( aktool_icode_index_mac( prefix, sizeof( prefix ), check ) != ak_error_ok ) return ak_false;
+  strncpy( ix.algorithm, ic.algorithm_ni, sizeof( ix.algorithm ) -1 );
+  ix.opened = ak_true;
+  if( ic.rehash ) return ak_true;
+
+ /* индекс считывается целиком и принимается, только если совпадает его имитовставка */
+  if( stat( ic.indexfile, &st ) || ( st.st_size < ( off_t )( 14 + ix.hsize )) ||
+                               (( ak_uint64 ) st.st_size > ( ak_uint64 )(( size_t )-1 - 16 )))
+    return ak_true;
+  total = ( size_t ) st.st_size;
+  if(( fp = fopen( ic.indexfile, "rb" )) == NULL ) return ak_true;
+  if(( data = malloc( total +16 )) == NULL ) goto labexit;
+  if( fread( data +16, 1, total, fp ) != total ) goto labexit;
+  total -= ix.hsize;
+  if( aktool_icode_index_mac( data, total +16, check ) != ak_error_ok ) goto labexit;
+  if( memcmp( check, data +16 +total, ix.hsize )) goto labexit;
+
+ /* заголовок: сигнатура, количество записей, длина контрольной суммы и имя алгоритма */
+  ptr = data +16;
+  end = ptr +total;
+  if( memcmp( ptr, aktool_icode_index_magic, 8 ) || ( ptr[12] != ix.hsize )) goto labexit;
+  len = ptr[13];
+  ptr += 14;
+  if(( len > ( size_t )( end - ptr )) || ( len != strlen( ix.algorithm )) ||
+                                                    memcmp( ptr, ix.algorithm, len )) goto labexit;
+  ptr += len;
+
+ /* записи: атрибуты файла, длина имени, имя и контрольная сумма */
+  for( i = 0; i < aktool_icode_index_get( data +16 +8, 4 ); i++ ) {
+     if(( size_t )( end - ptr ) < 42 ) break;
+     len = ( size_t ) aktool_icode_index_get( ptr +40, 2 );
+     if(( len == 0 ) || ( len >= sizeof( filename ))) break;
+     if(( size_t )( end - ptr ) < 42 + len + ix.hsize ) break;
+     memcpy( filename, ptr +42, len );
+     filename[len] = 0;
+     if(( entry = aktool_icode_index_append( filename )) == NULL ) break;
+     entry->size = aktool_icode_index_get( ptr, 8 );
+     entry->mtime = aktool_icode_index_get( ptr +8, 8 );
+     entry->ctime = aktool_icode_index_get( ptr +16, 8 );
+     entry->inode = aktool_icode_index_get( ptr +24, 8 );
+     entry->stamp = aktool_icode_index_get( ptr +32, 8 );
+     memcpy( entry->icode, ptr +42 +len, ix.hsize );
+     ptr += 42 + len + ix.hsize;
+  }
+  ix.loaded = ix.count;
+  qsort( ix.entries, ix.loaded, sizeof( struct icode_entry ), aktool_icode_index_compare_order );
+
+  labexit:
+   if( data != NULL ) free( data );
+   fclose( fp );
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_icode_entry aktool_icode_index_find( const char *filename )
+{
+  struct icode_entry key;
+
+  if( !aktool_icode_index_open( ) || ( ix.loaded == 0 )) return NULL;
+  key.filename = ( char * )filename;
+ return bsearch( &key, ix.entries, ix.loaded, sizeof( struct icode_entry ),
+                                                                     aktool_icode_index_compare );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* получение контрольной суммы из индекса, если атрибуты файла не изменились */
+ static bool_t aktool_icode_index_lookup( const char *filename, ak_uint8 *out )
+{
+  struct icode_entry st;
+  ak_icode_entry entry = NULL;
+
+  if(( entry = aktool_icode_index_find( filename )) == NULL ) return ak_false;
+  if( entry->stamp == 0 ) return ak_false;
+  if( !aktool_icode_index_stat( filename, &st )) return ak_false;
+  if(( st.size != entry->size ) || ( st.mtime != entry->mtime ) ||
+                   ( st.ctime != entry->ctime ) || ( st.inode != entry->inode )) return ak_false;
+ /* файл, измененный в ту же секунду, в которую была создана запись,
+    мог быть изменен еще раз без изменения атрибутов */
+  if(( st.mtime >= entry->stamp ) || ( st.ctime >= entry->stamp )) return ak_false;
+
+  memcpy( out, entry->icode, ix.hsize );
+  ix.skipped++;
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* сохранение в индексе вычисленной контрольной суммы файла; если атрибуты файла,
+   полученные перед вычислением контрольной суммы (attributes), не совпадают с текущими,
+   то файл изменялся во время вычисления и контрольная сумма в индексе не сохраняется */
+ static void aktool_icode_index_update( const char *filename,
+                                              const ak_uint8 *out, ak_icode_entry attributes )
+{
+  ak_icode_entry entry = NULL;
+
+  if( !aktool_icode_index_open( )) return;
+  if(( entry = aktool_icode_index_find( filename )) == NULL )
+    if(( entry = aktool_icode_index_append( filename )) == NULL ) return;
+
+  if( attributes->stamp && aktool_icode_index_stat( filename, entry ) &&
+      ( entry->size == attributes->size ) && ( entry->mtime == attributes->mtime ) &&
+      ( entry->ctime == attributes->ctime ) && ( entry->inode == attributes->inode )) {
+    entry->stamp = ( ak_uint64 ) time( NULL );
+    memcpy( entry->icode, out, ix.hsize );
+  } else entry->stamp = 0;
+  ix.changed = ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* удаление из индекса записи для файла, не прошедшего проверку */
+ static void aktool_icode_index_remove( const char *filename )
+{
+  ak_icode_entry entry = NULL;
+
+  if(( entry = aktool_icode_index_find( filename )) == NULL ) return;
+  if( entry->stamp ) {
+    entry->stamp = 0;
+    ix.changed = ak_true;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* сохранение индекса (если он изменился) и освобождение памяти */
+ int aktool_icode_index_close( void )
+{
+  FILE *fp = NULL;
+  size_t i = 0, count = 0, total = 0, len = strlen( ix.algorithm );
+  int error = ak_error_ok;
+  ak_uint8 *data = NULL, *ptr = NULL;
+  ak_icode_entry entry = NULL;
+
+  if( !ix.opened ) return ak_error_ok;
+  if( ix.skipped ) ak_error_message_fmt( ak_error_ok, __func__,
+     "integrity codes of %lu unchanged files are taken from index", (unsigned long int) ix.skipped );
+  if( !ix.changed ) goto labexit;
+
+ /* упорядочиваем записи и подсчитываем количество и общий объем сохраняемых;
+    из нескольких записей для одного файла сохраняется добавленная последней */
+  qsort( ix.entries, ix.count, sizeof( struct icode_entry ), aktool_icode_index_compare_order );
+  total = 14 + len;
+  for( i = 0; i < ix.count; i++ ) {
+     entry = ix.entries +i;
+     if(( i+1 < ix.count ) && !strcmp( entry->filename, entry[1].filename )) entry->stamp = 0;
+     if( entry->stamp ) {
+       count++;
+       total += 42 + strlen( entry->filename ) + ix.hsize;
+     }
+  }
+
+  if(( count > 0xFFFFFFFF ) || (( data = malloc( 16 + total + ix.hsize )) == NULL )) {
+    error = ak_error_message( ak_error_undefined_value, __func__, "index cannot be stored" );
+    goto labexit;
+  }
+
+ /* формируем содержимое индекса и вычисляем его имитовставку */
+  ptr = data +16;
+  memcpy( ptr, aktool_icode_index_magic, 8 );
+  aktool_icode_index_put( ptr +8, count, 4 );
+  ptr[12] = ( ak_uint8 ) ix.hsize;
+  ptr[13] = ( ak_uint8 ) len;
+  memcpy( ptr +14, ix.algorithm, len );
+  ptr += 14 + len;
+
+  for( i = 0; i < ix.count; i++ ) {
+     entry = ix.entries +i;
+     if( !entry->stamp ) continue;
+     len = strlen( entry->filename );
+     aktool_icode_index_put( ptr, entry->size, 8 );
+     aktool_icode_index_put( ptr +8, entry->mtime, 8 );
+     aktool_icode_index_put( ptr +16, entry->ctime, 8 );
+     aktool_icode_index_put( ptr +24, entry->inode, 8 );
+     aktool_icode_index_put( ptr +32, entry->stamp, 8 );
+     aktool_icode_index_put( ptr +40, len, 2 );
+     memcpy( ptr +42, entry->filename, len );
+     memcpy( ptr +42 +len, entry->icode, ix.hsize );
+     ptr += 42 + len + ix.hsize;
+  }
+  if( aktool_icode_index_mac( data, 16 + total, data +16 +total ) != ak_error_ok ) {
+    error = ak_error_message( ak_error_undefined_value, __func__, "index cannot be stored" );
+    goto labexit;
+  }
+
+  if(( fp = fopen( ic.indexfile, "wb" )) == NULL ) {
+    error = ak_error_message_fmt( ak_error_create_file, __func__,
+                                            "index file \"%s\" cannot be created", ic.indexfile );
+    goto labexit;
+  }
+  fwrite( data +16, 1, total + ix.hsize, fp );
+  if( ferror( fp )) error = ak_error_message_fmt( ak_error_write_data, __func__,
+                                              "wrong writing index file \"%s\"", ic.indexfile );
+  fclose( fp );
+
+  labexit:
+   if( data != NULL ) free( data );
+   for( i = 0; i < ix.count; i++ ) free( ix.entries[i].filename );
+   if( ix.entries != NULL ) free( ix.entries );
+   memset( &ix, 0, sizeof( struct icode_index ));
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* вывод вычисленной контрольной суммы файла или сообщения о невозможности ее вычисления */
+ static int aktool_icode_output( const char *filename, ak_uint8 *out, const int error )
+{
+  if( error != ak_error_ok ) {
+    if( ic.tag ) fprintf( ic.outfp, "%s (%s) = skipped\n", ic.algorithm_ni, filename );
+      else fprintf( ic.outfp, "skipped %s\n", filename );
+    return ak_error_message_fmt( error, __func__,
+                                        "incorrect evaluation mac for \"%s\" file", filename );
+  }
+
+ /* вывод результатов в следующих форматах
+    linux:
+      контрольная_сумма имя_файла
+      контрольная_сумма имя_файла синхропосылка
+
+    bsd:
+      алгоритм (имя_файла) = контрольная_сумма
+      алгоритм (имя_файла) = контрольная_сумма (синхропосылка) */
+
+  if( ic.tag ) { /* вывод bsd */
+    fprintf( ic.outfp, "%s (%s) = %s\n", ic.algorithm_ni, filename,
+                   ak_ptr_to_hexstr( out, ak_handle_get_tag_size( ic.handle ), ic.reverse_order ));
+
+  } else { /* вывод линуксовый */
+      fprintf( ic.outfp, "%s %s\n",
+        ak_ptr_to_hexstr( out, ak_handle_get_tag_size( ic.handle ), ic.reverse_order ), filename );
+    }
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* вывод результата проверки контрольной суммы файла и подсчет статистики */
+ static void aktool_icode_check_output( ak_icode_task task )
+{
+  if( !task->indexed ) {
+    if( task->error != ak_error_ok ) {
+      aktool_icode_index_remove( task->filename );
+      if( !ic.status ) {
+        if( task->wrong ) printf(_("%s Wrong (changed chunks: %lu)\n"),
+                                              task->filename, (unsigned long int) task->wrong );
+          else printf("%s Wrong\n", task->filename );
+      }
+      ak_error_message_fmt( task->error, __func__,
+                         "incorrect evaluation integrity code for \"%s\" file", task->filename );
+      return;
+    }
+    if( ak_ptr_is_equal( task->out, task->icode, ak_handle_get_tag_size( ic.handle )) != ak_true ) {
+      aktool_icode_index_remove( task->filename );
+      if( !ic.status ) {
+        if( ic.quiet ) aktool_error(_("%s"), task->filename );
+          else aktool_error(_("%s Wrong"), task->filename );
+      }
+      return;
+    }
+    aktool_icode_index_update( task->filename, task->out, &task->attributes );
+  }
+
+  if( !ic.status ) {
+    if( ic.quiet ) printf("%s\n", task->filename );
+      else printf("%s Ok\n", task->filename );
+  }
+  ic.stat_successed++;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* создание очереди файлов и дескрипторов алгоритма для потоков, вычисляющих контрольные суммы;
+   ключ, считанный из файла, не может быть скопирован в другой дескриптор,
+   поэтому в этом случае все файлы обрабатываются последовательно */
+ bool_t aktool_icode_queue_create( void )
+{
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  int error = ak_error_ok;
+  ak_handle handle = ak_error_wrong_handle;
+
+  memset( &iq, 0, sizeof( struct icode_queue ));
+  iq.jobs = 1;
+  iq.check = ( ic.checkfile != NULL );
+  if( ic.jobs < 2 ) return ak_true;
+  if( ic.keyfile_flag ) {
+    ak_error_message( ak_error_ok, __func__,
+                              "secret key loaded from file is used by single thread only" );
+    return ak_true;
+  }
+
+  if(( iq.handles = malloc( ic.jobs*sizeof( ak_handle ))) == NULL ) {
+    aktool_error(_("memory allocation error"));
+    return ak_false;
+  }
+  if(( iq.tasks = calloc( aktool_icode_queue_size, sizeof( struct icode_task ))) == NULL ) {
+    free( iq.handles );
+    iq.handles = NULL;
+    aktool_error(_("memory allocation error"));
+    return ak_false;
+  }
+
+ /* первый поток использует основной дескриптор, для остальных создаем новые */
+  iq.handles[0] = ic.handle;
+  for( iq.jobs = 1; iq.jobs < ic.jobs; iq.jobs++ ) {
+     if(( handle = ak_handle_new( ic.tree_flag ? ic.tree_algorithm : ic.algorithm_ni,
+                                                         NULL )) == ak_error_wrong_handle ) break;
+     if( ak_handle_check_secret_key( handle )) {
+       if( ic.hexkey_flag ) error = ak_handle_set_key_from_hexstr( handle, ic.hexstr, ak_false );
+         else error = ak_handle_set_key_from_password( handle, ic.password,
+                                                   strlen( ic.password ), ic.salt, ic.salt_len );
+       if( error != ak_error_ok ) {
+         ak_handle_delete( handle );
+         break;
+       }
+     }
+     iq.handles[iq.jobs] = handle;
+  }
+  pthread_mutex_init( &iq.mutex, NULL );
+#endif
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+/* функция потока: выбирает из очереди очередной файл и вычисляет его контрольную сумму */
+ static void *aktool_icode_queue_thread( void *ptr )
+{
+  size_t idx = 0;
+  ak_icode_task task = NULL;
+  ak_handle handle = *( ak_handle *)ptr;
+
+  do{
+     pthread_mutex_lock( &iq.mutex );
+     idx = iq.next++;
+     pthread_mutex_unlock( &iq.mutex );
+     if( idx >= iq.count ) break;
+
+     task = iq.tasks + idx;
+     if( task->indexed ) continue;
+     aktool_icode_index_prepare( task->filename, &task->attributes );
+     task->error = aktool_icode_file( handle, task->filename,
+                                         task->out, sizeof( task->out ), iq.check, &task->wrong );
+  } while(1);
+
+ return NULL;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/* вычисление контрольных сумм всех файлов, помещенных в очередь, и вывод результатов
+   в том порядке, в котором файлы были помещены в очередь */
+ void aktool_icode_queue_flush( void )
+{
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  size_t i = 0, count = 0;
+  pthread_t *threads = NULL;
+
+  if(( iq.tasks == NULL ) || ( iq.count == 0 )) return;
+
+ /* запускаем дополнительные потоки, основной поток также обрабатывает очередь */
+  iq.next = 0;
+  if(( threads = malloc( iq.jobs*sizeof( pthread_t ))) != NULL ) {
+    for( i = 1; ( i < iq.jobs ) && ( i < iq.count ); i++, count++ )
+       if( pthread_create( threads + count, NULL,
+                                        aktool_icode_queue_thread, iq.handles + i ) != 0 ) break;
+  }
+  aktool_icode_queue_thread( iq.handles );
+  for( i = 0; i < count; i++ ) pthread_join( threads[i], NULL );
+  if( threads != NULL ) free( threads );
+
+ /* выводим результаты и очищаем очередь */
+  for( i = 0; i < iq.count; i++ ) {
+     ak_icode_task task = iq.tasks +i;
+     if( iq.check ) {
+       aktool_icode_check_output( task );
+       free( task->filename );
+       continue;
+     }
+     if(( task->error == ak_error_ok ) && !task->indexed )
+       aktool_icode_index_update( task->filename, task->out, &task->attributes );
+     aktool_icode_output( task->filename, task->out, task->error );
+     free( task->filename );
+  }
+  memset( iq.tasks, 0, iq.count*sizeof( struct icode_task ));
+  iq.count = iq.next = 0;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ void aktool_icode_queue_destroy( void )
+{
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  size_t i = 0;
+
+  if( iq.tasks == NULL ) return;
+  for( i = 0; i < iq.count; i++ ) free( iq.tasks[i].filename );
+  free( iq.tasks );
+  for( i = 1; i < iq.jobs; i++ ) ak_handle_delete( iq.handles[i] );
+  free( iq.handles );
+  pthread_mutex_destroy( &iq.mutex );
+  memset( &iq, 0, sizeof( struct icode_queue ));
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* помещение файла в очередь; при заполнении очереди все файлы обрабатываются;
+   функция возвращает указатель на созданное задание, остальные поля которого заполняются
+   вызывающей функцией */
+ static ak_icode_task aktool_icode_queue_add( const char *filename )
+{
+  size_t len = strlen( filename );
+  ak_icode_task task = NULL;
+
+  if( iq.count == aktool_icode_queue_size ) aktool_icode_queue_flush();
+  task = iq.tasks + iq.count;
+  if(( task->filename = malloc( len +1 )) == NULL ) {
+    ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+    return NULL;
+  }
+  memcpy( task->filename, filename, len +1 );
+  task->error = ak_error_ok;
+  task->indexed = ak_false;
+  task->wrong = 0;
+  iq.count++;
+
+ return task;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  int aktool_icode_function( const char *filename, ak_pointer ptr )
 {
   int error = ak_error_ok;
   char flongname[FILENAME_MAX];
-  ak_uint8 out[127], ivector[31], outiv[64];
+  ak_uint8 out[127];
+  ak_icode_task task = NULL;
+  struct icode_entry attributes;
 
   ( void )ptr;
+  if( ic.tree_flag && aktool_icode_is_tree_file( filename )) return ak_error_ok;
   memset( out, 0, sizeof( out ));
-  memset( ivector, 0, sizeof( ivector ));
-  memset( outiv, 0, sizeof( outiv ));
   ak_error_set_value( ak_error_ok );
 
  /* увеличиваем количество обработанных файлов */
@@ -481,40 +1241,34 @@
                                       "using mac algorithm with large integrity code size");
   }
 
- /* теперь начинаем процесс */
-  if(( error = ak_handle_mac_file( ic.handle, filename, out, sizeof( out ))) != ak_error_ok ) {
-    if( ic.tag ) fprintf( ic.outfp, "%s (%s) = skipped\n", ic.algorithm_ni, filename );
-      else fprintf( ic.outfp, "skipped %s\n", filename );
-    return ak_error_message_fmt( error, __func__,
-                                        "incorrect evaluation mac for \"%s\" file", filename );
+ /* если файл не изменялся, то используем сохраненную в индексе контрольную сумму */
+  if( aktool_icode_index_lookup( filename, out )) {
+    if( iq.tasks == NULL ) return aktool_icode_output( filename, out, ak_error_ok );
+    if(( task = aktool_icode_queue_add( filename )) == NULL ) return ak_error_out_of_memory;
+    memcpy( task->out, out, sizeof( out ));
+    task->indexed = ak_true;
+    return ak_error_ok;
   }
 
- /* вывод результатов в следующих форматах
-    linux:
-      контрольная_сумма имя_файла
-      контрольная_сумма имя_файла синхропосылка
-
-    bsd:
-      алгоритм (имя_файла) = контрольная_сумма
-      алгоритм (имя_файла) = контрольная_сумма (синхропосылка) */
+ /* при параллельной обработке файл только помещается в очередь */
+  if( iq.tasks != NULL )
+    return aktool_icode_queue_add( filename ) == NULL ? ak_error_out_of_memory : ak_error_ok;
 
- /* теперь вывод результата */
-  if( ic.tag ) { /* вывод bsd */
-    fprintf( ic.outfp, "%s (%s) = %s\n", ic.algorithm_ni, filename,
-                   ak_ptr_to_hexstr( out, ak_handle_get_tag_size( ic.handle ), ic.reverse_order ));
-
-  } else { /* вывод линуксовый */
-      fprintf( ic.outfp, "%s %s\n",
-        ak_ptr_to_hexstr( out, ak_handle_get_tag_size( ic.handle ), ic.reverse_order ), filename );
-    }
- return error;
+ /* теперь начинаем процесс */
+  aktool_icode_index_prepare( filename, &attributes );
+  if(( error = aktool_icode_file( ic.handle,
+                                  filename, out, sizeof( out ), ak_false, NULL )) == ak_error_ok )
+    aktool_icode_index_update( filename, out, &attributes );
+ return aktool_icode_output( filename, out, error );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
  int aktool_icode_check_function( char *string, ak_pointer ptr )
 {
   size_t len = 0;
-  ak_uint8 out[64], out2[64];
+  struct icode_task check;
+  ak_icode_task task = &check;
+  ak_uint8 out2[64];
   char *substr = NULL, *filename = NULL, *icode = NULL;
   int error = ak_error_ok, reterrror = ak_error_undefined_value;
 
@@ -568,26 +1322,53 @@
  /* приступаем к проверке*/
   ic.stat_total++;
 
+ /* при первом вызове создаем очередь для параллельной проверки файлов */
+  if( iq.jobs == 0 ) aktool_icode_queue_create();
+  if( iq.tasks != NULL ) {
+    if(( task = aktool_icode_queue_add( filename )) == NULL ) return ak_error_out_of_memory;
+  } else {
+     memset( task, 0, sizeof( struct icode_task ));
+     task->filename = filename;
+    }
+  memcpy( task->icode, out2, sizeof( out2 ));
+
+ /* если атрибуты файла не изменились, а сохраненная в индексе контрольная сумма
+    совпадает с проверяемой, то файл повторно не обрабатывается */
+  if( aktool_icode_index_lookup( filename, task->out ) &&
+       ( ak_ptr_is_equal( task->out, out2, ak_handle_get_tag_size( ic.handle )) == ak_true ))
+    task->indexed = ak_true;
+
+ /* при параллельной обработке проверка выполняется позднее */
+  if( iq.tasks != NULL ) return ak_error_ok;
+
  /* проверяем контрольную сумму */
-  if(( error = ak_handle_mac_file( ic.handle, filename, out, sizeof( out ))) != ak_error_ok ) {
-    if( !ic.status ) printf("%s Wrong\n", filename );
-    ak_error_message_fmt( reterrror, __func__,
-                               "incorrect evaluation integrity code for \"%s\" file", filename );
+  if( !task->indexed ) {
+    aktool_icode_index_prepare( filename, &task->attributes );
+    task->error = aktool_icode_file( ic.handle, filename,
+                                        task->out, sizeof( task->out ), ak_true, &task->wrong );
   }
-  if( ak_ptr_is_equal( out, out2, ak_handle_get_tag_size( ic.handle )) == ak_true ) {
-    if( !ic.status ) {
-      if( ic.quiet ) printf("%s\n", filename );
-        else printf("%s Ok\n", filename );
-    }
-    ic.stat_successed++;
-  } else
-     if( !ic.status ) {
-      if( ic.quiet ) aktool_error(_("%s"), filename );
-       else aktool_error(_("%s Wrong"), filename );
-     }
+  aktool_icode_check_output( task );
  return ak_error_ok;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/* вычисление контрольной суммы файла; при использовании дерева хеш-кодов функция
+   сохраняет дерево (при вычислении) или использует сохраненное ранее дерево (при проверке) */
+ int aktool_icode_file( ak_handle handle, const char *filename, ak_uint8 *out,
+                                               const size_t size, const bool_t check, size_t *wrong )
+{
+  char treefile[FILENAME_MAX];
+
+  if( !ic.tree_flag ) return ak_handle_mac_file( handle, filename, out, size );
+
+  ak_snprintf( treefile, sizeof( treefile ), "%s.aktree", filename );
+  if( check && ( aktool_file_or_directory( treefile ) == DT_REG ))
+    return ak_handle_check_file_tree( handle, filename, treefile, ic.threads, out, size, wrong );
+
+ return ak_handle_mac_file_tree( handle, filename, ic.chunk_size, ic.threads,
+                                                 ( ic.save_tree && !check ) ? treefile : NULL, out, size );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  int aktool_icode_help( void )
 {
@@ -595,10 +1376,14 @@
   printf(_("available options:\n"));
   printf(_(" -a, --algorithm <ni>    set the algorithm, where \"ni\" is name or identifier of mac or hash function\n" ));
   printf(_("                         default algorithm is \"streebog256\" defined by GOST R 34.10-2012\n" ));
+  printf(_("                         the suffix \"-tree\" (e.g. \"streebog512-tree\") enables the parallel hash tree mode\n" ));
+  printf(_("     --chunk-size <n>    set the size of file chunk for hash tree mode (suffixes K, M, G are allowed)\n" ));
   printf(_(" -c, --check <file>      check previously generated macs or integrity codes\n" ));
   printf(_("     --dont-show-stat    don't show a statistical results after checking\n"));
   printf(_("     --hexkey <hex>      set the secret key directly in command line as a string of hexademal digits\n"));
   printf(_("     --ignore-errors     don't breake a check when file is missing or corrupted\n" ));
+  printf(_("     --index <file>      store file attributes and integrity codes in index and skip unchanged files\n" ));
+  printf(_(" -j, --jobs <n>          set the number of files whose integrity codes are calculated simultaneously\n" ));
   printf(_(" -k  --key <file>        use the secret key from a specified file\n" ));
   printf(_("     --openssl-style     use data formats as in openssl library\n"));
   printf(_(" -o, --output <file>     set the output file for generated integrity codes\n" ));
@@ -606,12 +1391,15 @@
   printf(_("     --password <pass>   set the password directly in command line\n"));
   printf(_("     --quiet             don't print OK for each successfully verified file\n"));
   printf(_(" -r, --recursive         recursive search of files\n" ));
+  printf(_("     --rehash            ignore the index given by --index option and recalculate all integrity codes\n" ));
   printf(_("     --reverse-order     output of integrity code in reverse byte order\n" ));
+  printf(_("     --save-tree         store the hash tree of each file into the file with \".aktree\" extension\n" ));
   printf(_("     --salt              set the initial value of PBKDF2 function for key generaton from password\n"));
   printf(_("     --salt-len <int>    change the length of salt buffer, in octets; default value is %u\n"),
                                                                            (unsigned int) sizeof( ic.salt ) >> 1 );
   printf(_("     --status            don't output anything, status code shows success\n" ));
   printf(_("     --tag               create a BSD-style checksum\n" ));
+  printf(_("     --threads <n>       set the number of threads used in hash tree mode\n" ));
   printf(_(" -t, --template <str>    set the pattern which is used to find files\n"));
 
  return aktool_print_common_options();
@@ -212,3 +212,11 @@ check_c_source_compiles("
   }" LIBAKRYPT_HAVE_SIGNAL_H )
 
 # -------------------------------------------------------------------------------------------------- #
+check_c_source_compiles("
+  #include <sys/random.h>
+  int main( void ) {
+     unsigned char buffer[16];
+     return getrandom( buffer, sizeof( buffer ), 0 ) != sizeof( buffer );
+  }" LIBAKRYPT_HAVE_SYSRANDOM_H )
+
+# -------------------------------------------------------------------------------------------------- #
@@ -34,3 +34,29 @@ check_c_source_compiles("
 if( LIBAKRYPT_HAVE_BUILTIN_CLMULEPI64 )
     set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DLIBAKRYPT_HAVE_BUILTIN_CLMULEPI64" )
 endif()
+
+# -------------------------------------------------------------------------------------------------- #
+# -------------------------------------------------------------------------------------------------- #
+check_c_source_compiles("
+  #include <cpuid.h>
+  int main( void ) {
+    #if defined( __x86_64__ )
+      unsigned int a, b, c, d;
+      unsigned long long t[2] = { 0, 0 }, v = 2, u = 3;
+      __get_cpuid_count( 7, 0, &a, &b, &c, &d );
+      __asm__ volatile ( \"xor %%eax, %%eax\\\\n\\\\t\"
+                         \"mulx (%[v]), %%r8, %%r9\\\\n\\\\t\"
+                         \"adcx %%r8, %%r9\\\\n\\\\t\"
+                         \"adox %%r9, %%rax\\\\n\\\\t\"
+                         \"mov %%rax, (%[t])\\\\n\\\\t\"
+                       : : [t] \"r\" (t), [v] \"r\" (&v), \"d\" (u)
+                       : \"rax\", \"r8\", \"r9\", \"cc\", \"memory\" );
+      return ( int )t[0];
+    #else
+      #error Unsupported architecture
+    #endif
+  }" LIBAKRYPT_HAVE_BUILTIN_MULX_ADX )
+
+if( LIBAKRYPT_HAVE_BUILTIN_MULX_ADX )
+    set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DLIBAKRYPT_HAVE_BUILTIN_MULX_ADX" )
+endif()
@@ -60,6 +60,7 @@ else()
   else()
     if( LIBAKRYPT_SHARED_LIB )
       set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DLIBAKRYPT_HAVE_PTHREAD" )
+      set( LIBAKRYPT_LIBS ${LIBAKRYPT_LIBS} pthread )
     endif()
   endif()
 endif()
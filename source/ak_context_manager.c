@@ -187,7 +187,13 @@
   if( manager == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
                                             "using a null pointer to context manager structure" );
  /* инициализируем генератор ключей */
-#if defined(__unix__) || defined(__APPLE__)
+#ifdef LIBAKRYPT_HAVE_SYSRANDOM_H
+ /* генератор разделяется всеми потоками, поэтому используется вариант без буффера */
+  if(( error = ak_random_context_create_getrandom_unbuffered(
+                                                     &manager->key_generator )) != ak_error_ok )
+    return ak_error_message( error, __func__,
+                                "wrong initialization of getrandom() for random number generation" );
+#elif defined(__unix__) || defined(__APPLE__)
   if(( error = ak_random_context_create_urandom( &manager->key_generator )) != ak_error_ok )
     return ak_error_message( error, __func__,
                             "wrong initialization of /dev/urandom for random number generation" );
@@ -0,0 +1,316 @@
+/* ----------------------------------------------------------------------------------------------- */
+/*  Copyright (c) 2019 by Axel Kenzo, axelkenzo@mail.ru                                            */
+/*                                                                                                 */
+/*  Файл ak_ctrrnd.c                                                                               */
+/*  - содержит реализацию генератора псевдо-случайных чисел, основанного на использовании          */
+/*    блочного шифра Кузнечик в режиме гаммирования                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ #include <ak_hash.h>
+ #include <ak_bckey.h>
+
+/* ----------------------------------------------------------------------------------------------- */
+#ifdef LIBAKRYPT_HAVE_STDLIB_H
+ #include <stdlib.h>
+#else
+ #error Library cannot be compiled without stdlib.h header
+#endif
+#ifdef LIBAKRYPT_HAVE_STRING_H
+ #include <string.h>
+#else
+ #error Library cannot be compiled without string.h header
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Размер буффера, заполняемого генератором ctrrnd за одно обращение к функции next. */
+ #define ak_ctrrnd_buffer_size      (4096)
+/*! \brief Количество октетов гаммы, вырабатываемых на одном ключе. */
+ #define ak_ctrrnd_rekey_interval   (65536)
+/*! \brief Количество октетов, после выработки которых генератор ctrrnd повторно
+    инициализируется значениями, полученными от генератора операционной системы. */
+ #define ak_ctrrnd_reseed_interval  (1048576)
+/*! \brief Количество октетов гаммы, используемых для смены ключа и синхропосылки. */
+ #define ak_ctrrnd_seed_size        (40)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Класс для хранения внутренних состояний генератора ctrrnd. */
+/*! Генератор вырабатывает гамму блочного шифра Кузнечик в режиме гаммирования (ГОСТ Р 34.13-2015)
+    блоками по \ref ak_ctrrnd_buffer_size октетов. После выработки \ref ak_ctrrnd_rekey_interval
+    октетов первые \ref ak_ctrrnd_seed_size октетов очередного блока используются в качестве нового
+    ключа и синхропосылки, поэтому значения, выданные до смены ключа, не могут быть восстановлены
+    по текущему состоянию генератора. После выработки
+    \ref ak_ctrrnd_reseed_interval октетов к новому ключу прибавляются значения,
+    полученные от генератора операционной системы.                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct ctrrnd {
+  /*! \brief Ключ блочного шифра Кузнечик */
+   struct bckey key;
+  /*! \brief Текущее значение синхропосылки */
+   ak_uint8 iv[8];
+  /*! \brief Массив выработанных значений */
+   ak_uint8 buffer[ak_ctrrnd_buffer_size];
+  /*! \brief Текущее количество доступных для выдачи октетов */
+   size_t len;
+  /*! \brief Количество октетов, выработанных после последней инициализации */
+   ak_uint64 counter;
+  /*! \brief Количество октетов, выработанных на текущем ключе */
+   size_t rekey;
+  /*! \brief Флаг необходимости периодической инициализации генератора */
+   bool_t reseed;
+ } *ak_ctrrnd;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция получает случайные значения от генератора операционной системы.
+    \param out Указатель на область памяти, в которую помещаются значения.
+    \param size Размер области памяти в октетах.
+    \return В случае успеха, функция возвращает \ref ak_error_ok. В противном случае
+            возвращается код ошибки.                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_context_entropy_ctrrnd( ak_pointer out, const size_t size )
+{
+  struct random generator;
+  int error = ak_error_ok;
+
+ #ifdef LIBAKRYPT_HAVE_SYSRANDOM_H
+  if(( error = ak_random_context_create_getrandom_unbuffered( &generator )) != ak_error_ok )
+ #elif defined(__unix__) || defined(__APPLE__)
+  if(( error = ak_random_context_create_urandom( &generator )) != ak_error_ok )
+ #else
+  #ifdef _WIN32
+  if(( error = ak_random_context_create_winrtl( &generator )) != ak_error_ok )
+  #else
+  if(( error = ak_random_context_create_hashrnd( &generator )) != ak_error_ok )
+  #endif
+ #endif
+    return ak_error_message( error, __func__, "incorrect creation of system random generator" );
+
+  error = ak_random_context_random( &generator, out, ( ssize_t )size );
+  ak_random_context_destroy( &generator );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция устанавливает ключ и синхропосылку генератора.
+    \param crnd Контекст генератора.
+    \param seed Массив из \ref ak_ctrrnd_seed_size октетов: ключ и синхропосылка.
+    \return В случае успеха, функция возвращает \ref ak_error_ok. В противном случае
+            возвращается код ошибки.                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_context_set_seed_ctrrnd( ak_ctrrnd crnd, ak_uint8 *seed )
+{
+  int error = ak_error_ok;
+
+  if(( error = ak_bckey_context_set_key( &crnd->key, seed, 32 )) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect assigning of secret key value" );
+  memcpy( crnd->iv, seed +32, sizeof( crnd->iv ));
+  memset( seed, 0, ak_ctrrnd_seed_size );
+  crnd->rekey = 0;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисяет следующее внутреннее состояние генератора.
+    \param rnd Контекст генератора.
+    \return В случае успеха, функция возвращает \ref ak_error_ok. В противном случае
+            возвращается код ошибки.                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_context_next_ctrrnd( ak_random rnd )
+{
+  size_t i = 0;
+  ak_ctrrnd crnd = NULL;
+  int error = ak_error_ok;
+  ak_uint8 seed[ak_ctrrnd_seed_size], entropy[ak_ctrrnd_seed_size];
+
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                    "use a null pointer to a random generator" );
+  crnd = ( ak_ctrrnd ) rnd->data.ctx;
+
+ /* вырабатываем гамму; синхропосылка образует старшую половину счетчика,
+    поэтому ее увеличение на единицу дает непересекающийся отрезок значений счетчика */
+  memset( crnd->buffer, 0, sizeof( crnd->buffer ));
+  if(( error = ak_bckey_context_ctr( &crnd->key, crnd->buffer, crnd->buffer,
+                              sizeof( crnd->buffer ), crnd->iv, sizeof( crnd->iv ))) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect generation of keystream" );
+  for( i = 0; i < sizeof( crnd->iv ); i++ ) if( ++crnd->iv[i] != 0 ) break;
+  crnd->len = sizeof( crnd->buffer );
+  crnd->counter += sizeof( crnd->buffer );
+  if(( crnd->rekey += sizeof( crnd->buffer )) < ak_ctrrnd_rekey_interval ) return ak_error_ok;
+
+ /* первые октеты гаммы используются в качестве нового ключа и синхропосылки */
+  memcpy( seed, crnd->buffer, ak_ctrrnd_seed_size );
+  memset( crnd->buffer, 0, ak_ctrrnd_seed_size );
+  crnd->len -= ak_ctrrnd_seed_size;
+
+ /* при необходимости добавляем значения, полученные от операционной системы */
+  if( crnd->reseed && ( crnd->counter >= ak_ctrrnd_reseed_interval )) {
+    if(( error = ak_random_context_entropy_ctrrnd( entropy, sizeof( entropy ))) == ak_error_ok ) {
+      for( i = 0; i < sizeof( seed ); i++ ) seed[i] ^= entropy[i];
+      crnd->counter = 0;
+    } else ak_error_message( error, __func__, "generator is not reseeded" );
+    memset( entropy, 0, sizeof( entropy ));
+  }
+
+ return ak_random_context_set_seed_ctrrnd( crnd, seed );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Ключ и синхропосылка генератора вырабатываются из заданных данных с помощью функции
+    хеширования Стрибог512. После вызова данной функции генератор вырабатывает детерминированную
+    последовательность и не использует генератор операционной системы.
+
+    \param rnd Контекст генератора.
+    \param ptr Указатель на область данных, которыми инициалиируется генератор
+    \param size Размер области в байтах
+    \return В случае успеха, функция возвращает \ref ak_error_ok. В противном случае
+            возвращается код ошибки.                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_context_randomize_ctrrnd( ak_random rnd,
+                                                       const ak_pointer ptr, const ssize_t size )
+{
+  struct hash hctx;
+  ak_ctrrnd crnd = NULL;
+  int error = ak_error_ok;
+  ak_uint8 seed[64];
+
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                             "use a null pointer to a random generator context" );
+  if( ptr == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                   "use a null pointer to data" );
+  if( size <= 0 ) return ak_error_message( ak_error_wrong_length, __func__ ,
+                                                                 "use a data with wrong length" );
+  crnd = ( ak_ctrrnd ) rnd->data.ctx;
+
+  if(( error = ak_hash_context_create_streebog512( &hctx )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "incorrect creation of streebog512 context" );
+  error = ak_hash_context_ptr( &hctx, ptr, ( size_t )size, seed, sizeof( seed ));
+  ak_hash_context_destroy( &hctx );
+  if( error != ak_error_ok ) return ak_error_message( error, __func__,
+                                                          "incorrect hashing of initial value" );
+  crnd->reseed = ak_false;
+  crnd->counter = 0;
+  crnd->len = 0;
+  if(( error = ak_random_context_set_seed_ctrrnd( crnd, seed )) != ak_error_ok ) return error;
+  memset( seed, 0, sizeof( seed ));
+
+ return rnd->next( rnd );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \param rnd Контекст генератора.
+    \param ptr Указатель на область памяти, в которую помещаются вырабатываемые значения
+    \param size Размер области в байтах
+    \return В случае успеха, функция возвращает \ref ak_error_ok. В противном случае
+            возвращается код ошибки.                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_context_random_ctrrnd( ak_random rnd,
+                                                          const ak_pointer ptr, const ssize_t size )
+{
+  ak_uint8 *inptr = ptr;
+  ak_ctrrnd crnd = NULL;
+  ssize_t realsize = size;
+  int error = ak_error_ok;
+
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "use a null pointer to a random generator" );
+  if( ptr == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                   "use a null pointer to data" );
+  if( size <= 0 ) return ak_error_message( ak_error_wrong_length, __func__ ,
+                                                                 "use a data with wrong length" );
+  crnd = ( ak_ctrrnd )rnd->data.ctx;
+  while( realsize > 0 ) {
+    size_t offset = ak_min( (size_t)realsize, crnd->len );
+    ak_uint8 *bufptr = crnd->buffer + ( sizeof( crnd->buffer ) - crnd->len );
+
+    memcpy( inptr, bufptr, offset );
+    memset( bufptr, 0, offset );
+    inptr += offset;
+    realsize -= offset;
+   /* вычисляем следующий массив данных */
+    if(( crnd->len -= offset ) == 0 )
+      if(( error = rnd->next( rnd )) != ak_error_ok ) return error;
+  }
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param rnd Контекст генератора.                                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_context_free_ctrrnd( ak_random rnd )
+{
+  int error = ak_error_ok;
+  ak_ctrrnd crnd = NULL;
+
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                            "freeing a null pointer to random generator context" );
+  if(( crnd = ( ak_ctrrnd ) rnd->data.ctx ) == NULL ) return ak_error_ok;
+
+ /* уничтожаем ключ блочного шифра */
+  if(( error = ak_bckey_context_destroy( &crnd->key )) != ak_error_ok )
+    ak_error_message( error, __func__ , "wrong destroying internal block cipher key" );
+ /* теперь уничтожаем собственно структуру ctrrnd */
+  memset( crnd, 0, sizeof( struct ctrrnd ));
+  free( crnd );
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Начальное значение ключа и синхропосылки генератора вырабатывается генератором операционной
+    системы (/dev/urandom или winrtl).
+
+    @param rnd Контекст создаваемого генератора.
+    @return В случае успеха, функция возвращает \ref ak_error_ok. В противном случае
+            возвращается код ошибки.                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_random_context_create_ctrrnd( ak_random rnd )
+{
+  ak_ctrrnd crnd = NULL;
+  int error = ak_error_ok;
+  ak_uint8 seed[ak_ctrrnd_seed_size];
+
+  if(( error = ak_random_context_create( rnd )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "wrong initialization of random generator" );
+
+  if(( rnd->data.ctx = crnd = malloc( sizeof( struct ctrrnd ))) == NULL ) {
+    ak_random_context_destroy( rnd );
+    return ak_error_message( ak_error_out_of_memory, __func__ ,
+                        "incorrect memory allocation for internal variables of random generator" );
+  }
+  memset( crnd, 0, sizeof( struct ctrrnd ));
+
+  if(( error = ak_bckey_context_create_kuznechik( &crnd->key )) != ak_error_ok ) {
+    free( rnd->data.ctx );
+    rnd->data.ctx = NULL;
+    ak_random_context_destroy( rnd );
+    return ak_error_message( error, __func__ , "incorrect creation of kuznechik key context" );
+  }
+  rnd->free = ak_random_context_free_ctrrnd;
+
+  if(( rnd->oid = ak_oid_context_find_by_name( "ctrrnd" )) == NULL ) {
+    ak_random_context_destroy( rnd );
+    return ak_error_message( ak_error_wrong_oid, __func__ ,
+                                      "incorrect search internal identifier fo ctrrnd generator" );
+  }
+
+  rnd->next = ak_random_context_next_ctrrnd;
+  rnd->randomize_ptr = ak_random_context_randomize_ctrrnd;
+  rnd->random = ak_random_context_random_ctrrnd;
+
+ /* начальное значение вырабатывается генератором операционной системы */
+  if(( error = ak_random_context_entropy_ctrrnd( seed, sizeof( seed ))) != ak_error_ok ) {
+    ak_random_context_destroy( rnd );
+    return ak_error_message( error, __func__ , "incorrect generation of initial value" );
+  }
+  crnd->reseed = ak_true;
+  if(( error = ak_random_context_set_seed_ctrrnd( crnd, seed )) == ak_error_ok )
+    error = rnd->next( rnd );
+  if( error != ak_error_ok ) {
+    ak_random_context_destroy( rnd );
+    return ak_error_message( error, __func__ , "incorrect initialization of ctrrnd generator" );
+  }
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                                                                                    ak_ctrrnd.c  */
+/* ----------------------------------------------------------------------------------------------- */
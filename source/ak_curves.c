@@ -15,6 +15,96 @@
 #ifdef LIBAKRYPT_HAVE_STRINGS_H
  #include <strings.h>
 #endif
+#ifdef LIBAKRYPT_HAVE_STDLIB_H
+ #include <stdlib.h>
+#else
+ #error Library cannot be compiled without stdlib.h header
+#endif
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #include <pthread.h>
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция умножает два вычета x и y в представлении Монтгомери по модулю \f$ p \f$
+    эллиптической кривой. Если в контексте кривой определена функция приведения для модуля
+    специального вида (поле redc), то сначала вычисляется произведение x и y как целых чисел,
+    которое затем приводится этой функцией; в противном случае вызывается функция
+    ak_mpzn_mul_montgomery(). Указатель на z может совпадать с одним из указателей на x или y.
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Левый множитель
+    @param y Правый множитель
+    @param ec Эллиптическая кривая, по модулю которой производятся вычисления                      */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wcurve_mul_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y, ak_wcurve ec )
+{
+  ak_uint64 t[2*ak_mpzn512_size];
+
+  if( ec->redc == NULL ) {
+    ak_mpzn_mul_montgomery( z, x, y, ec->p, ec->n, ec->size );
+    return;
+  }
+  ak_mpzn_mul( t, x, y, ec->size );
+  ec->redc( z, t, ec->p, ec->n, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция возводит в квадрат вычет x в представлении Монтгомери по модулю \f$ p \f$
+    эллиптической кривой. Результат совпадает с результатом вызова
+    ak_wcurve_mul_montgomery( z, x, x, ec ). Указатель на z может совпадать с указателем на x.
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Вычет, возводимый в квадрат
+    @param ec Эллиптическая кривая, по модулю которой производятся вычисления                      */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wcurve_sqr_montgomery( ak_uint64 *z, ak_uint64 *x, ak_wcurve ec )
+{
+  ak_uint64 t[2*ak_mpzn512_size];
+
+  if( ec->redc == NULL ) {
+    ak_mpzn_sqr_montgomery( z, x, ec->p, ec->n, ec->size );
+    return;
+  }
+  ak_mpzn_sqr( t, x, ec->size );
+  ec->redc( z, t, ec->p, ec->n, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет вычет \f$ r \equiv u \pmod{q} \f$, где \f$ q \f$ порядок подгруппы
+    точек эллиптической кривой, методом Барретта с использованием величины \f$ \mu \f$,
+    хранящейся в контексте кривой. Время работы функции не зависит от значения u.
+
+    @param r Вычет, в который помещается результат. Указатель на r может совпадать с указателем на u.
+    @param u Приводимый вычет длины ec->size машинных слов
+    @param ec Эллиптическая кривая                                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_rem_q( ak_uint64 *r, ak_uint64 *u, ak_wcurve ec )
+{
+  ak_uint64 t[2*ak_mpzn512_size];
+
+  memcpy( t, u, ec->size*sizeof( ak_uint64 ));
+  memset( t+ec->size, 0, ec->size*sizeof( ak_uint64 ));
+  ak_mpzn_rem_barrett( r, t, ec->q, ec->mu, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет вычет \f$ z \equiv xy \pmod{q} \f$, где \f$ q \f$ порядок подгруппы
+    точек эллиптической кривой. Вычеты x, y и z задаются в обычном представлении (не в
+    представлении Монтгомери); значения x и y могут быть не приведены по модулю \f$ q \f$.
+    Произведение вычисляется функцией ak_mpzn_mul() и приводится методом Барретта.
+
+    @param z Вычет, в который помещается результат
+    @param x Левый множитель
+    @param y Правый множитель
+    @param ec Эллиптическая кривая                                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_mulmod_q( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y, ak_wcurve ec )
+{
+  ak_uint64 t[2*ak_mpzn512_size];
+
+  ak_mpzn_mul( t, x, y, ec->size );
+  ak_mpzn_rem_barrett( z, t, ec->q, ec->mu, ec->size );
+}
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция вычисляет величину \f$\Delta \equiv -16(4a^3 + 27b^2) \pmod{p} \f$, зависящую
@@ -30,27 +120,27 @@
  /* определяем константы 4 и 27 в представлении Монтгомери */
   ak_mpzn_set_ui( d, ec->size, 4 );
   ak_mpzn_set_ui( s, ak_mpznmax_size, 27 );
-  ak_mpzn_mul_montgomery( d, d, ec->r2, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( s, s, ec->r2, ec->p, ec->n, ec->size );
+  ak_wcurve_mul_montgomery( d, d, ec->r2, ec );
+  ak_wcurve_mul_montgomery( s, s, ec->r2, ec );
 
  /* вычисляем 4a^3 (mod p) значение в представлении Монтгомери */
-  ak_mpzn_mul_montgomery( d, d, ec->a, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( d, d, ec->a, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( d, d, ec->a, ec->p, ec->n, ec->size );
+  ak_wcurve_mul_montgomery( d, d, ec->a, ec );
+  ak_wcurve_mul_montgomery( d, d, ec->a, ec );
+  ak_wcurve_mul_montgomery( d, d, ec->a, ec );
 
  /* вычисляем значение 4a^3 + 27b^2 (mod p) в представлении Монтгомери */
-  ak_mpzn_mul_montgomery( s, s, ec->b, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( s, s, ec->b, ec->p, ec->n, ec->size );
+  ak_wcurve_mul_montgomery( s, s, ec->b, ec );
+  ak_wcurve_mul_montgomery( s, s, ec->b, ec );
   ak_mpzn_add_montgomery( d, d, s, ec->p, ec->size );
 
  /* определяем константу -16 в представлении Монтгомери и вычисляем D = -16(4a^3+27b^2) (mod p) */
   ak_mpzn_set_ui( s, ec->size, 16 );
   ak_mpzn_sub( s, ec->p, s, ec->size );
-  ak_mpzn_mul_montgomery( s, s, ec->r2, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( d, d, s, ec->p, ec->n, ec->size );
+  ak_wcurve_mul_montgomery( s, s, ec->r2, ec );
+  ak_wcurve_mul_montgomery( d, d, s, ec );
 
  /* возвращаем результат (в обычном представлении) */
-  ak_mpzn_mul_montgomery( d, d, one, ec->p, ec->n, ec->size );
+  ak_wcurve_mul_montgomery( d, d, one, ec );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -73,7 +163,9 @@
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! Для проведения проверки функция вырабатывает случайное число \f$ t \pmod{q} \f$ и проверяет
-    выполнимость равенства \f$ t \cdot t^{-1} \equiv 1 \pmod{q}\f$.
+    выполнимость равенства \f$ t \cdot t^{-1} \equiv 1 \pmod{q}\f$. Также проверяется, что
+    величина \f$ \mu \f$, используемая методом Барретта, удовлетворяет неравенствам
+    \f$ 0 \leq r^2 - \mu q < q \f$.
 
     @param ec Контекст эллиптической кривой.
 
@@ -82,17 +174,28 @@
 /* ----------------------------------------------------------------------------------------------- */
  int ak_wcurve_check_order_parameters( ak_wcurve ec )
 {
+  size_t i;
   ak_mpzn512 r, s, t;
+  ak_mpznmax v = ak_mpznmax_zero, w, zero = ak_mpznmax_zero;
   struct random generator;
 
+ /* проверяем величину mu: w <- r^2 - mu*q должно удовлетворять неравенствам 0 <= w < q */
+  ak_mpzn_set( v, ec->q, ec->size );
+  ak_mpzn_mul( w, ec->mu, v, ec->size+1 );
+  if( w[2*ec->size] || w[2*ec->size+1] ) return ak_error_curve_order_parameters;
+  ak_mpzn_sub( w, zero, w, 2*ec->size );
+  for( i = ec->size; i < 2*ec->size; i++ )
+     if( w[i] ) return ak_error_curve_order_parameters;
+  if( ak_mpzn_cmp( w, ec->q, ec->size ) >= 0 ) return ak_error_curve_order_parameters;
+
   ak_random_context_create_lcg( &generator );
   ak_mpzn_set_random( t, ec->size, &generator );
-  ak_mpzn_rem( t, t, ec->q, ec->size );
+  ak_mpzn_rem_q( t, t, ec );
   ak_random_context_destroy( &generator );
 
   ak_mpzn_set_ui( r, ec->size, 2 );
   ak_mpzn_sub( r, ec->q, r, ec->size );
-  ak_mpzn_modpow_montgomery( s, t, r, ec->q, ec->nq, ec->size );
+  ak_mpzn_modpow_montgomery( s, t, r, ec->q, ec->nq, ec->size, modpow_sliding_window );
   ak_mpzn_mul_montgomery( t, s, t, ec->q, ec->nq, ec->size );
 
   ak_mpzn_mul_montgomery( t, t, ec->r2q, ec->q, ec->nq, ec->size );
@@ -102,6 +205,128 @@
    else return ak_error_curve_order_parameters;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет единицу в представлении Монтгомери, т.е. вычет \f$ r \pmod{p} \f$. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wcurve_set_montgomery_one( ak_uint64 *one, ak_wcurve ec )
+{
+  ak_mpznmax u = ak_mpznmax_one;
+  ak_wcurve_mul_montgomery( one, ec->r2, u, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для кривой, имеющей искривленную форму Эдвардса, функция проверяет, что параметры
+    \f$ e, d, s, t \f$ удовлетворяют равенствам \f$ 4s \equiv e - d \f$, \f$ 6t \equiv e + d \f$,
+    \f$ a \equiv s^2 - 3t^2 \f$ и \f$ b \equiv 2t^3 - ts^2 \pmod{p} \f$, а также то, что образ
+    образующей точки удовлетворяет уравнениям \f$ ex^2 + y^2 \equiv z^2 + dt^2 \f$
+    и \f$ xy \equiv tz \pmod{p} \f$. Для остальных кривых проверки не выполняются.
+
+    @param ec контекст эллиптической кривой.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается \ref ak_error_curve_order_parameters.                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_wcurve_edwards_is_ok( ak_wcurve ec )
+{
+  struct epoint ep;
+  ak_mpznmax u, v, w;
+
+  if( !ak_wcurve_is_edwards( ec )) return ak_error_ok;
+
+ /* 4s = e - d */
+  ak_mpzn_lshift_montgomery( u, ec->s, ec->p, ec->size );
+  ak_mpzn_lshift_montgomery( u, u, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( v, ec->e, ec->d, ec->p, ec->size );
+  if( ak_mpzn_cmp( u, v, ec->size )) return ak_error_curve_order_parameters;
+ /* 6t = e + d */
+  ak_mpzn_lshift_montgomery( u, ec->t, ec->p, ec->size );
+  ak_mpzn_add_montgomery( v, u, ec->t, ec->p, ec->size );
+  ak_mpzn_lshift_montgomery( u, v, ec->p, ec->size );
+  ak_mpzn_add_montgomery( v, ec->e, ec->d, ec->p, ec->size );
+  if( ak_mpzn_cmp( u, v, ec->size )) return ak_error_curve_order_parameters;
+ /* a = s^2 - 3t^2 */
+  ak_wcurve_sqr_montgomery( u, ec->s, ec );
+  ak_wcurve_sqr_montgomery( v, ec->t, ec );
+  ak_mpzn_lshift_montgomery( w, v, ec->p, ec->size );
+  ak_mpzn_add_montgomery( w, w, v, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( w, u, w, ec->p, ec->size );
+  if( ak_mpzn_cmp( w, ec->a, ec->size )) return ak_error_curve_order_parameters;
+ /* b = t(2t^2 - s^2) */
+  ak_mpzn_lshift_montgomery( w, v, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( w, w, u, ec->p, ec->size );
+  ak_wcurve_mul_montgomery( w, w, ec->t, ec );
+  if( ak_mpzn_cmp( w, ec->b, ec->size )) return ak_error_curve_order_parameters;
+
+ /* образ образующей точки принадлежит кривой в форме Эдвардса */
+  ak_epoint_set_wpoint( &ep, &ec->point, ec );
+  ak_wcurve_sqr_montgomery( u, ep.x, ec );
+  ak_wcurve_mul_montgomery( u, u, ec->e, ec );
+  ak_wcurve_sqr_montgomery( v, ep.y, ec );
+  ak_mpzn_add_montgomery( u, u, v, ec->p, ec->size );
+  ak_wcurve_sqr_montgomery( v, ep.t, ec );
+  ak_wcurve_mul_montgomery( v, v, ec->d, ec );
+  ak_wcurve_sqr_montgomery( w, ep.z, ec );
+  ak_mpzn_add_montgomery( v, v, w, ec->p, ec->size );
+  if( ak_mpzn_cmp( u, v, ec->size )) return ak_error_curve_order_parameters;
+  ak_wcurve_mul_montgomery( u, ep.x, ep.y, ec );
+  ak_wcurve_mul_montgomery( v, ep.t, ep.z, ec );
+  if( ak_mpzn_cmp( u, v, ec->size )) return ak_error_curve_order_parameters;
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция проверяет, что модуль кривой имеет вид, необходимый для функции приведения,
+    указатель на которую содержится в контексте кривой. Для функции
+    ak_mpzn_redc_pseudo_mersenne() модуль должен иметь вид \f$ p = 2^{64size} - c \f$, то есть
+    все слова модуля, кроме младшего, должны состоять из единиц.
+
+    @param ec контекст эллиптической кривой.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_wcurve_redc_is_ok( ak_wcurve ec )
+{
+  size_t i;
+
+  if( ec->redc == ak_mpzn_redc_pseudo_mersenne ) {
+    for( i = 1; i < ec->size; i++ )
+       if( ec->p[i] != 0xffffffffffffffffLL ) return ak_error_curve_prime_modulo;
+  }
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция проверяет, что координаты, выбранные для вычисления кратных точек, могут
+    использоваться для заданной кривой: для координат Якоби с коэффициентом \f$ a = -3 \f$
+    проверяется значение коэффициента, для формы Эдвардса проверяются ее параметры.
+
+    @param ec контекст эллиптической кривой.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_wcurve_coordinates_is_ok( ak_wcurve ec )
+{
+  ak_mpznmax u, v, zero = ak_mpznmax_zero;
+
+  switch( ec->coordinates ) {
+    case projective_coordinates:
+    case jacobian_coordinates:
+      return ak_error_ok;
+
+    case jacobian_a3_coordinates:
+      ak_wcurve_set_montgomery_one( u, ec );
+      ak_mpzn_lshift_montgomery( v, u, ec->p, ec->size );
+      ak_mpzn_add_montgomery( v, v, u, ec->p, ec->size );
+      ak_mpzn_sub_montgomery( v, zero, v, ec->p, ec->size );
+      if( ak_mpzn_cmp( v, ec->a, ec->size )) return ak_error_curve_order_parameters;
+      return ak_error_ok;
+
+    case edwards_coordinates:
+      if( !ak_wcurve_is_edwards( ec )) return ak_error_curve_order_parameters;
+      return ak_wcurve_edwards_is_ok( ec );
+  }
+ return ak_error_undefined_value;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция принимает на вход контекст эллиптической кривой, заданной в короткой форме Вейерштрасса,
     и выполняет следующие математические проверки
@@ -109,7 +334,12 @@
      - проверяется, что модуль кривой (простое число \f$ p \f$) удовлетворяет неравенству
        \f$ 2^{n-32} < p < 2^n \f$, где \f$ n \f$ это либо 256, либо 512 в зависимости от
        параметров кривой,
+     - проверяется, что модуль имеет вид, необходимый для функции приведения, указанной
+       в контексте кривой,
      - проверяется, что дискриминант кривой отличен от нуля по модулю \f$ p \f$,
+     - проверяется, что координаты, выбранные для вычисления кратных точек,
+       могут использоваться для кривой; для кривых, использующих искривленную форму Эдвардса,
+       проверяется корректность параметров этой формы,
      - проверяется, что фиксированная точка кривой, содержащаяся в контексте эллиптической кривой,
        действительно принадлежит эллиптической кривой,
      - проверяется, что порядок этой точки кривой равен простому числу \f$ q \f$,
@@ -150,10 +380,18 @@
   if( ak_mpzn_cmp( temp, ec->p, ec->size ) != 0 )
     return ak_error_message( ak_error_wrong_endian, __func__,
                                                "incorrect convertation string to mpzn integer" );
+ /* проверяем, что модуль имеет вид, необходимый для выбранной функции приведения */
+  if(( error = ak_wcurve_redc_is_ok( ec )) != ak_error_ok )
+    return ak_error_message( error, __func__ ,
+                                 "elliptic curve has wrong modulo for selected reduction function" );
  /* проверяем, что дискриминант кривой отличен от нуля */
   if(( error = ak_wcurve_discriminant_is_ok( ec )) != ak_error_ok )
     return ak_error_message( ak_error_curve_discriminant, __func__ ,
                                        "using elliptic curve parameters with zero discriminant" );
+ /* тестируем параметры, необходимые для выбранных координат */
+  if(( error = ak_wcurve_coordinates_is_ok( ec )) != ak_error_ok )
+    return ak_error_message( error, __func__ ,
+                                  "elliptic curve has wrong parameters for selected coordinates" );
  /* теперь проверяем принадлежность точки кривой */
   if(( error = ak_wpoint_set( &wp, ec )) != ak_error_ok )
     return ak_error_message( error, __func__, "incorect asiigning a temporary point" );
@@ -181,9 +419,9 @@
   if( oid != NULL ) {
     ak_error_message_fmt( error, __func__, "elliptic curve: %s (oid: %s)", oid->names[0], oid->id );
 
-    ak_mpzn_mul_montgomery( tmp, ec->a, one, ec->p, ec->n, ec->size );
+    ak_wcurve_mul_montgomery( tmp, ec->a, one, ec );
     ak_error_message_fmt( error, __func__, " a = %s", ak_mpzn_to_hexstr( tmp, ec->size ));
-    ak_mpzn_mul_montgomery( tmp, ec->b, one, ec->p, ec->n, ec->size );
+    ak_wcurve_mul_montgomery( tmp, ec->b, one, ec );
     ak_error_message_fmt( error, __func__, " b = %s", ak_mpzn_to_hexstr( tmp, ec->size ));
     ak_error_message_fmt( error, __func__, " b = %s", ak_mpzn_to_hexstr( ec->b, ec->size ));
     ak_error_message_fmt( error, __func__, " p = %s", ak_mpzn_to_hexstr( ec->p, ec->size ));
@@ -216,9 +454,9 @@
   ec = oid->data;
   fprintf( fp, "elliptic curve: %s (oid: %s)\n\n", oid->names[0], oid->id );
 
-  ak_mpzn_mul_montgomery( tmp, ec->a, one, ec->p, ec->n, ec->size );
+  ak_wcurve_mul_montgomery( tmp, ec->a, one, ec );
   fprintf( fp, "  a = %s\n", ak_mpzn_to_hexstr( tmp, ec->size ));
-  ak_mpzn_mul_montgomery( tmp, ec->b, one, ec->p, ec->n, ec->size );
+  ak_wcurve_mul_montgomery( tmp, ec->b, one, ec );
   fprintf( fp, "  b = %s\n", ak_mpzn_to_hexstr( tmp, ec->size ));
 
   fprintf( fp, "  p = %s\n", ak_mpzn_to_hexstr( ec->p, ec->size ));
@@ -376,23 +614,23 @@
 
  /* Проверяем принадлежность точки заданной кривой */
   ak_mpzn_set( t, ec->a, ec->size );
-  ak_mpzn_mul_montgomery( t, t, wp->x, ec->p, ec->n, ec->size );
+  ak_wcurve_mul_montgomery( t, t, wp->x, ec );
   ak_mpzn_set( s, ec->b, ec->size );
-  ak_mpzn_mul_montgomery( s, s, wp->z, ec->p, ec->n, ec->size );
+  ak_wcurve_mul_montgomery( s, s, wp->z, ec );
   ak_mpzn_add_montgomery( t, t, s, ec->p, ec->size ); // теперь в t величина (ax+bz)
 
   ak_mpzn_set( s, wp->z, ec->size );
-  ak_mpzn_mul_montgomery( s, s, s, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( t, t, s, ec->p, ec->n, ec->size ); // теперь в t величина (ax+bz)z^2
+  ak_wcurve_sqr_montgomery( s, s, ec );
+  ak_wcurve_mul_montgomery( t, t, s, ec );                   // теперь в t величина (ax+bz)z^2
 
   ak_mpzn_set( s, wp->x, ec->size );
-  ak_mpzn_mul_montgomery( s, s, s, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( s, s, wp->x, ec->p, ec->n, ec->size );
+  ak_wcurve_sqr_montgomery( s, s, ec );
+  ak_wcurve_mul_montgomery( s, s, wp->x, ec );
   ak_mpzn_add_montgomery( t, t, s, ec->p, ec->size ); // теперь в t величина x^3 + (ax+bz)z^2
 
   ak_mpzn_set( s, wp->y, ec->size );
-  ak_mpzn_mul_montgomery( s, s, s, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( s, s, wp->z, ec->p, ec->n, ec->size ); // теперь в s величина x^3 + (ax+bz)z^2
+  ak_wcurve_sqr_montgomery( s, s, ec );
+  ak_wcurve_mul_montgomery( s, s, wp->z, ec );                   // теперь в s величина x^3 + (ax+bz)z^2
 
   if( ak_mpzn_cmp( t, s, ec->size )) return ak_false;
  return ak_true;
@@ -434,30 +672,30 @@
    return;
  }
  // dbl-2007-bl
- ak_mpzn_mul_montgomery( u1, wp->x, wp->x, ec->p, ec->n, ec->size );
- ak_mpzn_mul_montgomery( u2, wp->z, wp->z, ec->p, ec->n, ec->size );
+ ak_wcurve_sqr_montgomery( u1, wp->x, ec );
+ ak_wcurve_sqr_montgomery( u2, wp->z, ec );
  ak_mpzn_lshift_montgomery( u4, u1, ec->p, ec->size );
  ak_mpzn_add_montgomery( u4, u4, u1, ec->p, ec->size );
- ak_mpzn_mul_montgomery( u3, u2, ec->a, ec->p, ec->n, ec->size );
+ ak_wcurve_mul_montgomery( u3, u2, ec->a, ec );
  ak_mpzn_add_montgomery( u3, u3, u4, ec->p, ec->size );  // u3 = az^2 + 3x^2
- ak_mpzn_mul_montgomery( u4, wp->y, wp->z, ec->p, ec->n, ec->size );
+ ak_wcurve_mul_montgomery( u4, wp->y, wp->z, ec );
  ak_mpzn_lshift_montgomery( u4, u4, ec->p, ec->size );   // u4 = 2yz
- ak_mpzn_mul_montgomery( u5, wp->y, u4, ec->p, ec->n, ec->size ); // u5 = 2y^2z
+ ak_wcurve_mul_montgomery( u5, wp->y, u4, ec );                   // u5 = 2y^2z
  ak_mpzn_lshift_montgomery( u6, u5, ec->p, ec->size ); // u6 = 2u5
- ak_mpzn_mul_montgomery( u7, u6, wp->x, ec->p, ec->n, ec->size ); // u7 = 8xy^2z
+ ak_wcurve_mul_montgomery( u7, u6, wp->x, ec );                   // u7 = 8xy^2z
  ak_mpzn_lshift_montgomery( u1, u7, ec->p, ec->size );
  ak_mpzn_sub( u1, ec->p, u1, ec->size );
- ak_mpzn_mul_montgomery( u2, u3, u3, ec->p, ec->n, ec->size );
+ ak_wcurve_sqr_montgomery( u2, u3, ec );
  ak_mpzn_add_montgomery( u2, u2, u1, ec->p, ec->size );
- ak_mpzn_mul_montgomery( wp->x, u2, u4, ec->p, ec->n, ec->size );
- ak_mpzn_mul_montgomery( u6, u6, u5, ec->p, ec->n, ec->size );
+ ak_wcurve_mul_montgomery( wp->x, u2, u4, ec );
+ ak_wcurve_mul_montgomery( u6, u6, u5, ec );
  ak_mpzn_sub( u6, ec->p, u6, ec->size );
  ak_mpzn_sub( u2, ec->p, u2, ec->size );
  ak_mpzn_add_montgomery( u2, u2, u7, ec->p, ec->size );
- ak_mpzn_mul_montgomery( wp->y, u2, u3, ec->p, ec->n, ec->size );
+ ak_wcurve_mul_montgomery( wp->y, u2, u3, ec );
  ak_mpzn_add_montgomery( wp->y, wp->y, u6, ec->p, ec->size );
- ak_mpzn_mul_montgomery( wp->z, u4, u4, ec->p, ec->n, ec->size );
- ak_mpzn_mul_montgomery( wp->z, wp->z, u4, ec->p, ec->n, ec->size );
+ ak_wcurve_sqr_montgomery( wp->z, u4, ec );
+ ak_wcurve_mul_montgomery( wp->z, wp->z, u4, ec );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -505,11 +743,11 @@
   }
   // поскольку удвоение точки с помощью формул сложения дает бесконечно удаленную точку,
   // необходимо выполнить проверку
-  ak_mpzn_mul_montgomery( u1, wp1->x, wp2->z, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u2, wp2->x, wp1->z, ec->p, ec->n, ec->size );
+  ak_wcurve_mul_montgomery( u1, wp1->x, wp2->z, ec );
+  ak_wcurve_mul_montgomery( u2, wp2->x, wp1->z, ec );
   if( ak_mpzn_cmp( u1, u2, ec->size ) == 0 ) { // случай совпадения х-координат точки
-    ak_mpzn_mul_montgomery( u1, wp1->y, wp2->z, ec->p, ec->n, ec->size );
-    ak_mpzn_mul_montgomery( u2, wp2->y, wp1->z, ec->p, ec->n, ec->size );
+    ak_wcurve_mul_montgomery( u1, wp1->y, wp2->z, ec );
+    ak_wcurve_mul_montgomery( u2, wp2->y, wp1->z, ec );
     if( ak_mpzn_cmp( u1, u2, ec->size ) == 0 ) // случай полного совпадения точек
       ak_wpoint_double( wp1, ec );
      else ak_wpoint_set_as_unit( wp1, ec );
@@ -517,31 +755,31 @@
   }
 
   //add-1998-cmo-2
-  ak_mpzn_mul_montgomery( u1, wp1->x, wp2->z, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u2, wp1->y, wp2->z, ec->p, ec->n, ec->size );
+  ak_wcurve_mul_montgomery( u1, wp1->x, wp2->z, ec );
+  ak_wcurve_mul_montgomery( u2, wp1->y, wp2->z, ec );
   ak_mpzn_sub( u2, ec->p, u2, ec->size );
-  ak_mpzn_mul_montgomery( u3, wp1->z, wp2->z, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u4, wp2->y, wp1->z, ec->p, ec->n, ec->size );
+  ak_wcurve_mul_montgomery( u3, wp1->z, wp2->z, ec );
+  ak_wcurve_mul_montgomery( u4, wp2->y, wp1->z, ec );
   ak_mpzn_add_montgomery( u4, u4, u2, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( u5, u4, u4, ec->p, ec->n, ec->size );
+  ak_wcurve_sqr_montgomery( u5, u4, ec );
   ak_mpzn_sub( u7, ec->p, u1, ec->size );
-  ak_mpzn_mul_montgomery( wp1->x, wp2->x, wp1->z, ec->p, ec->n, ec->size );
+  ak_wcurve_mul_montgomery( wp1->x, wp2->x, wp1->z, ec );
   ak_mpzn_add_montgomery( wp1->x, wp1->x, u7, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( u7, wp1->x, wp1->x, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u6, u7, wp1->x, ec->p, ec->n, ec->size);
-  ak_mpzn_mul_montgomery( u1, u7, u1, ec->p, ec->n, ec->size );
+  ak_wcurve_sqr_montgomery( u7, wp1->x, ec );
+  ak_wcurve_mul_montgomery( u6, u7, wp1->x, ec );
+  ak_wcurve_mul_montgomery( u1, u7, u1, ec );
   ak_mpzn_lshift_montgomery( u7, u1, ec->p, ec->size );
   ak_mpzn_add_montgomery( u7, u7, u6, ec->p, ec->size );
   ak_mpzn_sub( u7, ec->p, u7, ec->size );
-  ak_mpzn_mul_montgomery( u5, u5, u3, ec->p, ec->n, ec->size );
+  ak_wcurve_mul_montgomery( u5, u5, u3, ec );
   ak_mpzn_add_montgomery( u5, u5, u7, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( wp1->x, wp1->x, u5, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u2, u2, u6, ec->p, ec->n, ec->size );
+  ak_wcurve_mul_montgomery( wp1->x, wp1->x, u5, ec );
+  ak_wcurve_mul_montgomery( u2, u2, u6, ec );
   ak_mpzn_sub( u5, ec->p, u5, ec->size );
   ak_mpzn_add_montgomery( u1, u1, u5, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( wp1->y, u4, u1, ec->p, ec->n, ec->size );
+  ak_wcurve_mul_montgomery( wp1->y, u4, u1, ec );
   ak_mpzn_add_montgomery( wp1->y, wp1->y, u2, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( wp1->z, u6, u3, ec->p, ec->n, ec->size );
+  ak_wcurve_mul_montgomery( wp1->z, u6, u3, ec );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -554,29 +792,297 @@
 /* ----------------------------------------------------------------------------------------------- */
  void ak_wpoint_reduce( ak_wpoint wp, ak_wcurve ec )
 {
- ak_mpznmax u, one = ak_mpznmax_one;
+ ak_mpznmax u;
  if( ak_mpzn_cmp_ui( wp->z, ec->size, 0 ) == ak_true ) {
    ak_wpoint_set_as_unit( wp, ec );
    return;
  }
 
- ak_mpzn_set_ui( u, ec->size, 2 );
- ak_mpzn_sub( u, ec->p, u, ec->size );
- ak_mpzn_modpow_montgomery( u, wp->z, u, ec->p, ec->n, ec->size ); // u <- z^{p-2} (mod p)
- ak_mpzn_mul_montgomery( u, u, one, ec->p, ec->n, ec->size );
+ ak_mpzn_inverse( u, wp->z, ec->p, ec->size );  // u <- (zr)^{-1} (mod p)
+ ak_wcurve_mul_montgomery( u, u, ec->r2, ec );  // u <- z^{-1} (mod p)
 
- ak_mpzn_mul_montgomery( wp->x, wp->x, u, ec->p, ec->n, ec->size );
- ak_mpzn_mul_montgomery( wp->y, wp->y, u, ec->p, ec->n, ec->size );
+ ak_wcurve_mul_montgomery( wp->x, wp->x, u, ec );
+ ak_wcurve_mul_montgomery( wp->y, wp->y, u, ec );
  ak_mpzn_set_ui( wp->z, ec->size, 1 );
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                   реализация операций с точками эллиптической кривой в координатах Якоби        */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает истину, если для вычисления кратных точек кривой
+    используются координаты Якоби.                                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline bool_t ak_wcurve_is_jacobian( ak_wcurve ec )
+{
+  if( ec->coordinates == projective_coordinates ) return ak_false;
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Переход от проективных координат к координатам Якоби. */
+/*! Точке \f$ (x:y:z) \f$ в проективных координатах соответствует точка \f$ (xz:yz^2:z) \f$
+    в координатах Якоби. Для кривых, использующих проективные координаты, функция
+    не изменяет точку.                                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_set_jacobian( ak_wpoint wp, ak_wcurve ec )
+{
+  ak_mpznmax u;
+
+  if( !ak_wcurve_is_jacobian( ec )) return;
+  if( ak_mpzn_cmp_ui( wp->z, ec->size, 0 ) == ak_true ) {
+    ak_wpoint_set_as_unit( wp, ec );
+    return;
+  }
+  ak_wcurve_mul_montgomery( wp->x, wp->x, wp->z, ec );
+  ak_wcurve_sqr_montgomery( u, wp->z, ec );
+  ak_wcurve_mul_montgomery( wp->y, wp->y, u, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Переход от координат Якоби к проективным координатам. */
+/*! Точке \f$ (x:y:z) \f$ в координатах Якоби соответствует точка \f$ (xz:y:z^3) \f$
+    в проективных координатах. Для кривых, использующих проективные координаты, функция
+    не изменяет точку.                                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_set_projective( ak_wpoint wp, ak_wcurve ec )
+{
+  ak_mpznmax u;
+
+  if( !ak_wcurve_is_jacobian( ec )) return;
+  if( ak_mpzn_cmp_ui( wp->z, ec->size, 0 ) == ak_true ) {
+    ak_wpoint_set_as_unit( wp, ec );
+    return;
+  }
+  ak_wcurve_mul_montgomery( wp->x, wp->x, wp->z, ec );
+  ak_wcurve_sqr_montgomery( u, wp->z, ec );
+  ak_wcurve_mul_montgomery( wp->z, wp->z, u, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Удвоение точки, заданной в координатах Якоби. */
+/*! Для кривых с коэффициентом \f$ a = -3 \f$ используются соотношения,
+    требующие трех умножений и пяти возведений в квадрат (D.Bernstein, 2001)
+
+    \code
+      delta = Z1^2
+      gamma = Y1^2
+      beta = X1*gamma
+      alpha = 3*(X1-delta)*(X1+delta)
+      X3 = alpha^2-8*beta
+      Z3 = (Y1+Z1)^2-gamma-delta
+      Y3 = alpha*(4*beta-X3)-8*gamma^2
+    \endcode
+
+    Для остальных кривых используются соотношения, требующие одного умножения,
+    восьми возведений в квадрат и одного умножения на коэффициент \f$ a \f$ (D.Bernstein,
+    T.Lange, 2007)
+
+    \code
+      XX = X1^2
+      YY = Y1^2
+      YYYY = YY^2
+      ZZ = Z1^2
+      S = 2*((X1+YY)^2-XX-YYYY)
+      M = 3*XX+a*ZZ^2
+      X3 = M^2-2*S
+      Y3 = M*(S-X3)-8*YYYY
+      Z3 = (Y1+Z1)^2-YY-ZZ
+    \endcode
+
+    Для бесконечно удаленной точки и точек второго порядка формулы дают точку с координатой
+    \f$ z = 0 \f$, поэтому дополнительные проверки не требуются.
+
+    @param wp Точка \f$ P \f$, которая удваивается
+    @param ec Эллиптическая кривая, которой принадлежит точка                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_jacobian_double( ak_wpoint wp, ak_wcurve ec )
+{
+  ak_mpznmax u1, u2, u3, u4;
+
+  if( ec->coordinates == jacobian_a3_coordinates ) {
+    ak_wcurve_sqr_montgomery( u1, wp->z, ec );                            // u1 = delta
+    ak_wcurve_sqr_montgomery( u2, wp->y, ec );                            // u2 = gamma
+    ak_wcurve_mul_montgomery( u3, wp->x, u2, ec );                        // u3 = beta
+    ak_mpzn_sub_montgomery( u4, wp->x, u1, ec->p, ec->size );
+    ak_mpzn_add_montgomery( wp->x, wp->x, u1, ec->p, ec->size );
+    ak_wcurve_mul_montgomery( u4, u4, wp->x, ec );
+    ak_mpzn_lshift_montgomery( wp->x, u4, ec->p, ec->size );
+    ak_mpzn_add_montgomery( u4, u4, wp->x, ec->p, ec->size );             // u4 = alpha
+
+    ak_mpzn_add_montgomery( wp->z, wp->y, wp->z, ec->p, ec->size );
+    ak_wcurve_sqr_montgomery( wp->z, wp->z, ec );
+    ak_mpzn_sub_montgomery( wp->z, wp->z, u2, ec->p, ec->size );
+    ak_mpzn_sub_montgomery( wp->z, wp->z, u1, ec->p, ec->size );
+
+    ak_mpzn_lshift_montgomery( u3, u3, ec->p, ec->size );
+    ak_mpzn_lshift_montgomery( u3, u3, ec->p, ec->size );                 // u3 = 4*beta
+    ak_wcurve_sqr_montgomery( wp->x, u4, ec );
+    ak_mpzn_sub_montgomery( wp->x, wp->x, u3, ec->p, ec->size );
+    ak_mpzn_sub_montgomery( wp->x, wp->x, u3, ec->p, ec->size );
+
+    ak_mpzn_sub_montgomery( u3, u3, wp->x, ec->p, ec->size );
+    ak_wcurve_mul_montgomery( u3, u3, u4, ec );
+    ak_wcurve_sqr_montgomery( u2, u2, ec );
+    ak_mpzn_lshift_montgomery( u2, u2, ec->p, ec->size );
+    ak_mpzn_lshift_montgomery( u2, u2, ec->p, ec->size );
+    ak_mpzn_lshift_montgomery( u2, u2, ec->p, ec->size );
+    ak_mpzn_sub_montgomery( wp->y, u3, u2, ec->p, ec->size );
+    return;
+  }
+
+  ak_wcurve_sqr_montgomery( u1, wp->x, ec );                              // u1 = XX
+  ak_wcurve_sqr_montgomery( u2, wp->y, ec );                              // u2 = YY
+  ak_wcurve_sqr_montgomery( u3, wp->z, ec );                              // u3 = ZZ
+  ak_mpzn_add_montgomery( wp->z, wp->y, wp->z, ec->p, ec->size );
+  ak_wcurve_sqr_montgomery( wp->z, wp->z, ec );
+  ak_mpzn_sub_montgomery( wp->z, wp->z, u2, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( wp->z, wp->z, u3, ec->p, ec->size );
+
+  ak_mpzn_add_montgomery( wp->x, wp->x, u2, ec->p, ec->size );
+  ak_wcurve_sqr_montgomery( wp->x, wp->x, ec );
+  ak_wcurve_sqr_montgomery( u2, u2, ec );                                 // u2 = YYYY
+  ak_mpzn_sub_montgomery( wp->x, wp->x, u1, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( wp->x, wp->x, u2, ec->p, ec->size );
+  ak_mpzn_lshift_montgomery( u4, wp->x, ec->p, ec->size );                // u4 = S
+
+  ak_wcurve_sqr_montgomery( u3, u3, ec );
+  ak_wcurve_mul_montgomery( u3, u3, ec->a, ec );
+  ak_mpzn_add_montgomery( u3, u3, u1, ec->p, ec->size );
+  ak_mpzn_lshift_montgomery( u1, u1, ec->p, ec->size );
+  ak_mpzn_add_montgomery( u3, u3, u1, ec->p, ec->size );                  // u3 = M
+
+  ak_wcurve_sqr_montgomery( wp->x, u3, ec );
+  ak_mpzn_sub_montgomery( wp->x, wp->x, u4, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( wp->x, wp->x, u4, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( u4, u4, wp->x, ec->p, ec->size );
+  ak_wcurve_mul_montgomery( u4, u4, u3, ec );
+  ak_mpzn_lshift_montgomery( u2, u2, ec->p, ec->size );
+  ak_mpzn_lshift_montgomery( u2, u2, ec->p, ec->size );
+  ak_mpzn_lshift_montgomery( u2, u2, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( wp->y, u4, u2, ec->p, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сложение двух точек, заданных в координатах Якоби. */
+/*! Для точек \f$ P = (x_1:y_1:z_1) \f$ и \f$ Q = (x_2:y_2:z_2) \f$ вычисляется сумма
+    \f$ P + Q \f$, которая присваивается точке \f$ P \f$. Если вторая точка задана в аффинной
+    форме, то есть \f$ z_2 = 1 \f$ (значение `affine` истинно), то умножения на \f$ z_2 \f$
+    не выполняются. Используются соотношения D.Bernstein, T.Lange, 2007
+
+    \code
+      Z1Z1 = Z1^2
+      Z2Z2 = Z2^2
+      U1 = X1*Z2Z2
+      U2 = X2*Z1Z1
+      S1 = Y1*Z2*Z2Z2
+      S2 = Y2*Z1*Z1Z1
+      H = U2-U1
+      I = (2*H)^2
+      J = H*I
+      r = 2*(S2-S1)
+      V = U1*I
+      X3 = r^2-J-2*V
+      Y3 = r*(V-X3)-2*S1*J
+      Z3 = ((Z1+Z2)^2-Z1Z1-Z2Z2)*H
+    \endcode
+
+    Как и функция ak_wpoint_add(), функция корректно обрабатывает случаи, когда одна из точек
+    является бесконечно удаленной, а также случаи \f$ P = \pm Q\f$.
+
+    @param wp1 Точка \f$ P \f$, в которую помещается результат операции сложения; первое слагаемое
+    @param wp2 Точка \f$ Q \f$, второе слагаемое
+    @param affine Истина, если точка \f$ Q \f$ задана в аффинной форме
+    @param ec Эллиптическая кривая, которой принадлежат складываемые точки                         */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_jacobian_add( ak_wpoint wp1, ak_wpoint wp2, bool_t affine, ak_wcurve ec )
+{
+  ak_mpznmax u1, u2, s1, s2, h, r;
+
+  if( ak_mpzn_cmp_ui( wp2->z, ec->size, 0 ) == ak_true ) return;
+  if( ak_mpzn_cmp_ui( wp1->z, ec->size, 0 ) == ak_true ) {
+    ak_wpoint_set_wpoint( wp1, wp2, ec );
+    return;
+  }
+  if( wp1 == wp2 ) {
+    ak_wpoint_jacobian_double( wp1, ec );
+    return;
+  }
+
+  ak_wcurve_sqr_montgomery( h, wp1->z, ec );                              // h = Z1Z1
+  ak_wcurve_mul_montgomery( u2, wp2->x, h, ec );
+  ak_wcurve_mul_montgomery( s2, wp2->y, wp1->z, ec );
+  ak_wcurve_mul_montgomery( s2, s2, h, ec );
+  if( affine ) {
+    ak_mpzn_set( u1, wp1->x, ec->size );
+    ak_mpzn_set( s1, wp1->y, ec->size );
+    ak_mpzn_add_montgomery( wp1->z, wp1->z, wp1->z, ec->p, ec->size );   // z3 = 2*Z1
+  } else {
+      ak_wcurve_sqr_montgomery( r, wp2->z, ec );                           // r = Z2Z2
+      ak_wcurve_mul_montgomery( u1, wp1->x, r, ec );
+      ak_wcurve_mul_montgomery( s1, wp1->y, wp2->z, ec );
+      ak_wcurve_mul_montgomery( s1, s1, r, ec );
+      ak_mpzn_add_montgomery( wp1->z, wp1->z, wp2->z, ec->p, ec->size );
+      ak_wcurve_sqr_montgomery( wp1->z, wp1->z, ec );
+      ak_mpzn_sub_montgomery( wp1->z, wp1->z, h, ec->p, ec->size );
+      ak_mpzn_sub_montgomery( wp1->z, wp1->z, r, ec->p, ec->size );     // z3 = 2*Z1*Z2
+    }
+  ak_mpzn_sub_montgomery( h, u2, u1, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( r, s2, s1, ec->p, ec->size );
+  if( ak_mpzn_cmp_ui( h, ec->size, 0 ) == ak_true ) {
+    if( ak_mpzn_cmp_ui( r, ec->size, 0 ) == ak_true ) {
+      ak_wpoint_set_wpoint( wp1, wp2, ec );
+      ak_wpoint_jacobian_double( wp1, ec );
+    } else ak_wpoint_set_as_unit( wp1, ec );
+    return;
+  }
+  ak_mpzn_lshift_montgomery( r, r, ec->p, ec->size );
+
+  ak_wcurve_mul_montgomery( wp1->z, wp1->z, h, ec );
+  ak_mpzn_lshift_montgomery( u2, h, ec->p, ec->size );
+  ak_wcurve_sqr_montgomery( u2, u2, ec );                                 // u2 = I
+  ak_wcurve_mul_montgomery( h, h, u2, ec );                               // h = J
+  ak_wcurve_mul_montgomery( u1, u1, u2, ec );                             // u1 = V
+  ak_wcurve_mul_montgomery( s1, s1, h, ec );                              // s1 = S1*J
+
+  ak_wcurve_sqr_montgomery( wp1->x, r, ec );
+  ak_mpzn_sub_montgomery( wp1->x, wp1->x, h, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( wp1->x, wp1->x, u1, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( wp1->x, wp1->x, u1, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( u1, u1, wp1->x, ec->p, ec->size );
+  ak_wcurve_mul_montgomery( wp1->y, r, u1, ec );
+  ak_mpzn_sub_montgomery( wp1->y, wp1->y, s1, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( wp1->y, wp1->y, s1, ec->p, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Удвоение точки в координатах, используемых для вычисления кратных точек кривой. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wpoint_double_internal( ak_wpoint wp, ak_wcurve ec )
+{
+  if( ak_wcurve_is_jacobian( ec )) ak_wpoint_jacobian_double( wp, ec );
+   else ak_wpoint_double( wp, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сложение точек в координатах, используемых для вычисления кратных точек кривой. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wpoint_add_internal( ak_wpoint wp1, ak_wpoint wp2,
+                                                                  bool_t affine, ak_wcurve ec )
+{
+  if( ak_wcurve_is_jacobian( ec )) ak_wpoint_jacobian_add( wp1, wp2, affine, ec );
+   else ak_wpoint_add( wp1, wp2, ec );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Для заданной точки \f$ P = (x:y:z) \f$ и заданного целого числа (вычета) \f$ k \f$
     функция вычисляет кратную точку \f$ Q \f$, удовлетворяющую
     равенству \f$  Q = [k]P = \underbrace{P+ \cdots + P}_{k}\f$.
 
     При вычислении используется метод `лесенки Монтгомери`, выравнивающий время работы алгоритма
-    вне зависимости от вида числа \f$ k \f$.
+    вне зависимости от вида числа \f$ k \f$. Промежуточные вычисления выполняются
+    в координатах Якоби, если они выбраны для кривой (см. \ref wcurve_coordinates_t); для кривых,
+    использующих форму Эдвардса, также используются координаты Якоби, поскольку точка \f$ P \f$
+    может не принадлежать подгруппе порядка \f$ q \f$.
 
     \b Для \b информации:
      \li Функция не приводит результирующую точку \f$ Q \f$ к аффинной форме.
@@ -599,18 +1105,1069 @@
  /* начальные значения для переменных */
   ak_wpoint_set_as_unit( &Q, ec );
   ak_wpoint_set_wpoint( &R, wp, ec );
+  ak_wpoint_set_jacobian( &R, ec );
 
  /* полный цикл по всем(!) битам числа k */
   for( i = size-1; i >= 0; i-- ) {
      uk = k[i];
      for( j = 0; j < 64; j++ ) {
-       if( uk&0x8000000000000000LL ) { ak_wpoint_add( &Q, &R, ec ); ak_wpoint_double( &R, ec ); }
-        else { ak_wpoint_add( &R, &Q, ec ); ak_wpoint_double( &Q, ec ); }
+       if( uk&0x8000000000000000LL ) {
+         ak_wpoint_add_internal( &Q, &R, ak_false, ec );
+         ak_wpoint_double_internal( &R, ec );
+       } else {
+           ak_wpoint_add_internal( &R, &Q, ak_false, ec );
+           ak_wpoint_double_internal( &Q, ec );
+         }
        uk <<= 1;
      }
   }
  /* копируем полученный результат */
+  ak_wpoint_set_projective( &Q, ec );
+  ak_wpoint_set_wpoint( wq, &Q, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*          реализация операций с точками эллиптической кривой в искривленной форме Эдвардса       */
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param ec эллиптическая кривая, заданная в короткой форме Вейерштрасса.
+    @return Функция возвращает \ref ak_true, если в контексте кривой определены параметры
+    искривленной формы Эдвардса. В противном случае возвращается \ref ak_false.                    */
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_wcurve_is_edwards( ak_wcurve ec )
+{
+  if( ec == NULL ) return ak_false;
+  if( ak_mpzn_cmp_ui( ec->d, ec->size, 0 ) == ak_true ) return ak_false;
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Нейтральному элементу группы точек соответствует точка \f$ (0:1:0:1) \f$; единица
+    в представлении Монтгомери вычисляется как \f$ r - p \f$.
+
+    @param ep точка эллиптической кривой, которой присваивается значение нейтрального элемента.
+    @param wc эллиптическая кривая, которой принадлежит точка.
+    @return Функция возвращает \ref ak_error_ok. В случае, когда один  из контекстов
+    равен NULL, то возвращается \ref ak_error_null_pointer.                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_epoint_set_as_unit( ak_epoint ep, ak_wcurve wc )
+{
+  if( ep == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                   "using null pointer to elliptic curve point" );
+  if( wc == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                         "using null pointer to elliptic curve" );
+  ak_mpzn_set_ui( ep->x, wc->size, 0 );
+  ak_wcurve_set_montgomery_one( ep->y, wc );
+  ak_mpzn_set_ui( ep->t, wc->size, 0 );
+  ak_mpzn_set( ep->z, ep->y, wc->size );
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для точки \f$ P = (x:y:z) \f$ кривой, заданной в короткой форме Вейерштрасса, функция
+    вычисляет точку искривленной формы Эдвардса с координатами
+    \f$ u = (x - tz)/y \f$ и \f$ v = (x - tz - sz)/(x - tz + sz) \f$.
+    Обозначим \f$ A = x - tz \f$, \f$ U = A(A + sz) \f$, \f$ V = (A - sz)y \f$,
+    \f$ W = (A + sz)y \f$, тогда в расширенных координатах результат
+    равен \f$ (UW:VW:UV:W^2) \f$. Бесконечно удаленная точка переводится в нейтральный элемент.
+
+    @param ep точка, в которую помещается результат преобразования.
+    @param wp точка кривой, заданной в короткой форме Вейерштрасса.
+    @param wc эллиптическая кривая, имеющая искривленную форму Эдвардса.
+    @return Функция возвращает \ref ak_error_ok. В случае, когда кривая не имеет
+    формы Эдвардса, возвращается \ref ak_error_curve_not_supported.                                */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_epoint_set_wpoint( ak_epoint ep, ak_wpoint wp, ak_wcurve wc )
+{
+  ak_mpznmax a, b, c, u;
+
+  if( ep == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                   "using null pointer to elliptic curve point" );
+  if( wp == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                   "using null pointer to elliptic curve point" );
+  if( !ak_wcurve_is_edwards( wc )) return ak_error_message( ak_error_curve_not_supported,
+                                     __func__ , "using elliptic curve without Edwards form" );
+  if( ak_mpzn_cmp_ui( wp->z, wc->size, 0 ) == ak_true ) return ak_epoint_set_as_unit( ep, wc );
+
+  ak_wcurve_mul_montgomery( u, wc->t, wp->z, wc );
+  ak_mpzn_sub_montgomery( a, wp->x, u, wc->p, wc->size );          // a = x - tz
+  ak_wcurve_mul_montgomery( u, wc->s, wp->z, wc );
+  ak_mpzn_add_montgomery( b, a, u, wc->p, wc->size );              // b = a + sz
+  ak_mpzn_sub_montgomery( c, a, u, wc->p, wc->size );              // c = a - sz
+  ak_wcurve_mul_montgomery( u, wp->y, b, wc );                     // W = by
+  ak_wcurve_mul_montgomery( a, a, b, wc );                         // U = ab
+  ak_wcurve_mul_montgomery( c, c, wp->y, wc );                     // V = cy
+
+  ak_wcurve_mul_montgomery( ep->x, a, u, wc );
+  ak_wcurve_mul_montgomery( ep->y, c, u, wc );
+  ak_wcurve_mul_montgomery( ep->t, a, c, wc );
+  ak_wcurve_sqr_montgomery( ep->z, u, wc );
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для точки \f$ P = (x:y:t:z) \f$ кривой в искривленной форме Эдвардса функция вычисляет
+    точку кривой в короткой форме Вейерштрасса, используя замену переменных
+    \f$ x_w = s(1+v)/(1-v) + t \f$, \f$ y_w = s(1+v)/((1-v)u) \f$. В проективных
+    координатах результат равен \f$ ((s(z+y) + t(z-y))x : s(z+y)z : (z-y)x) \f$.
+    Нейтральный элемент переводится в бесконечно удаленную точку.
+
+    @param wp точка, в которую помещается результат преобразования.
+    @param ep точка кривой в искривленной форме Эдвардса.
+    @param wc эллиптическая кривая, имеющая искривленную форму Эдвардса.
+    @return Функция возвращает \ref ak_error_ok. В случае, когда кривая не имеет
+    формы Эдвардса, возвращается \ref ak_error_curve_not_supported.                                */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_wpoint_set_epoint( ak_wpoint wp, ak_epoint ep, ak_wcurve wc )
+{
+  ak_mpznmax pz, mz, u;
+
+  if( wp == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                   "using null pointer to elliptic curve point" );
+  if( ep == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                   "using null pointer to elliptic curve point" );
+  if( !ak_wcurve_is_edwards( wc )) return ak_error_message( ak_error_curve_not_supported,
+                                     __func__ , "using elliptic curve without Edwards form" );
+  if( ak_mpzn_cmp_ui( ep->x, wc->size, 0 ) == ak_true ) return ak_wpoint_set_as_unit( wp, wc );
+
+  ak_mpzn_add_montgomery( pz, ep->z, ep->y, wc->p, wc->size );     // pz = z + y
+  ak_mpzn_sub_montgomery( mz, ep->z, ep->y, wc->p, wc->size );     // mz = z - y
+  ak_wcurve_mul_montgomery( pz, pz, wc->s, wc );
+  ak_wcurve_mul_montgomery( u, mz, wc->t, wc );
+  ak_mpzn_add_montgomery( u, u, pz, wc->p, wc->size );
+
+  ak_wcurve_mul_montgomery( wp->x, u, ep->x, wc );
+  ak_wcurve_mul_montgomery( wp->y, pz, ep->z, wc );
+  ak_wcurve_mul_montgomery( wp->z, mz, ep->x, wc );
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для точки \f$ P = (x:y:t:z) \f$ вычисляется точка \f$ [2]P \f$, которая присваивается
+    точке \f$ P \f$. Для вычислений используются соотношения из работы
+    H.Hisil, K.Wong, G.Carter, E.Dawson
+    <a href=https://eprint.iacr.org/2008/522>Twisted Edwards curves revisited</a>, 2008.
+
+    \code
+      A = X1^2
+      B = Y1^2
+      C = 2*Z1^2
+      D = e*A
+      E = (X1+Y1)^2-A-B
+      G = D+B
+      F = G-C
+      H = D-B
+      X3 = E*F
+      Y3 = G*H
+      T3 = E*H
+      Z3 = F*G
+    \endcode
+
+    @param ep Точка \f$ P \f$, которая удваивается
+    @param ec Эллиптическая кривая, которой принадлежит точка                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_epoint_double( ak_epoint ep, ak_wcurve ec )
+{
+  ak_mpznmax a, b, c, d, e;
+
+  ak_wcurve_sqr_montgomery( a, ep->x, ec );
+  ak_wcurve_sqr_montgomery( b, ep->y, ec );
+  ak_wcurve_sqr_montgomery( c, ep->z, ec );
+  ak_mpzn_lshift_montgomery( c, c, ec->p, ec->size );
+  ak_wcurve_mul_montgomery( d, ec->e, a, ec );
+  ak_mpzn_add_montgomery( e, ep->x, ep->y, ec->p, ec->size );
+  ak_wcurve_sqr_montgomery( e, e, ec );
+  ak_mpzn_sub_montgomery( e, e, a, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( e, e, b, ec->p, ec->size );      // e = 2xy
+  ak_mpzn_add_montgomery( a, d, b, ec->p, ec->size );      // a <- G
+  ak_mpzn_sub_montgomery( c, a, c, ec->p, ec->size );      // c <- F
+  ak_mpzn_sub_montgomery( b, d, b, ec->p, ec->size );      // b <- H
+
+  ak_wcurve_mul_montgomery( ep->x, e, c, ec );
+  ak_wcurve_mul_montgomery( ep->y, a, b, ec );
+  ak_wcurve_mul_montgomery( ep->t, e, b, ec );
+  ak_wcurve_mul_montgomery( ep->z, c, a, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для двух точек \f$ P = (x_1:y_1:t_1:z_1) \f$ и \f$ Q = (x_2:y_2:t_2:z_2)\f$ вычисляется
+    сумма \f$ P+Q \f$, которая присваивается точке \f$ P\f$. Для вычислений используются
+    соотношения из работы H.Hisil, K.Wong, G.Carter, E.Dawson
+    <a href=https://eprint.iacr.org/2008/522>Twisted Edwards curves revisited</a>, 2008.
+
+    \code
+      A = X1*X2
+      B = Y1*Y2
+      C = d*T1*T2
+      D = Z1*Z2
+      E = (X1+Y1)*(X2+Y2)-A-B
+      F = D-C
+      G = D+C
+      H = B-e*A
+      X3 = E*F
+      Y3 = G*H
+      T3 = E*H
+      Z3 = F*G
+    \endcode
+
+    Поскольку параметр \f$ e \f$ является квадратом, а параметр \f$ d \f$ квадратом не является,
+    формулы сложения корректны для любых точек кривой, в том числе для совпадающих точек и
+    нейтрального элемента. Поэтому, в отличие от функции ak_wpoint_add(), проверки
+    значений координат не требуются.
+
+    @param ep1 Точка \f$ P \f$, в которую помещается результат операции сложения; первое слагаемое
+    @param ep2 Точка \f$ Q \f$, второе слагаемое
+    @param ec Эллиптическая кривая, которой принадлежат складываемые точки                         */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_epoint_add( ak_epoint ep1, ak_epoint ep2, ak_wcurve ec )
+{
+  ak_mpznmax a, b, c, d, e, f;
+
+  ak_wcurve_mul_montgomery( a, ep1->x, ep2->x, ec );
+  ak_wcurve_mul_montgomery( b, ep1->y, ep2->y, ec );
+  ak_wcurve_mul_montgomery( c, ep1->t, ep2->t, ec );
+  ak_wcurve_mul_montgomery( c, c, ec->d, ec );
+  ak_wcurve_mul_montgomery( d, ep1->z, ep2->z, ec );
+  ak_mpzn_add_montgomery( e, ep1->x, ep1->y, ec->p, ec->size );
+  ak_mpzn_add_montgomery( f, ep2->x, ep2->y, ec->p, ec->size );
+  ak_wcurve_mul_montgomery( e, e, f, ec );
+  ak_mpzn_sub_montgomery( e, e, a, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( e, e, b, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( f, d, c, ec->p, ec->size );
+  ak_mpzn_add_montgomery( d, d, c, ec->p, ec->size );      // d <- G
+  ak_wcurve_mul_montgomery( a, ec->e, a, ec );
+  ak_mpzn_sub_montgomery( b, b, a, ec->p, ec->size );      // b <- H
+
+  ak_wcurve_mul_montgomery( ep1->x, e, f, ec );
+  ak_wcurve_mul_montgomery( ep1->y, d, b, ec );
+  ak_wcurve_mul_montgomery( ep1->t, e, b, ec );
+  ak_wcurve_mul_montgomery( ep1->z, f, d, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Прибавление к точке кривой в форме Эдвардса точки, заданной в аффинной форме. */
+/*! Точка \f$ Q \f$ задается массивом из трех вычетов \f$ (u, v, duv) \f$, где \f$ (u, v) \f$
+    аффинные координаты точки; координата \f$ z \f$ полагается равной единице, что позволяет
+    сократить количество умножений. Формулы сложения совпадают с формулами,
+    используемыми функцией ak_epoint_add().
+
+    @param ep Точка \f$ P \f$, в которую помещается результат операции сложения.
+    @param pt Массив, содержащий значения \f$ u, v, duv \f$ (по `ec->size` слов каждое).
+    @param ec Эллиптическая кривая, которой принадлежат складываемые точки                         */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_epoint_add_affine( ak_epoint ep, ak_uint64 *pt, ak_wcurve ec )
+{
+  ak_mpznmax a, b, c, e, f;
+  const size_t size = ec->size;
+
+  ak_wcurve_mul_montgomery( a, ep->x, pt, ec );
+  ak_wcurve_mul_montgomery( b, ep->y, pt+size, ec );
+  ak_wcurve_mul_montgomery( c, ep->t, pt+2*size, ec );
+  ak_mpzn_add_montgomery( e, ep->x, ep->y, ec->p, size );
+  ak_mpzn_add_montgomery( f, pt, pt+size, ec->p, size );
+  ak_wcurve_mul_montgomery( e, e, f, ec );
+  ak_mpzn_sub_montgomery( e, e, a, ec->p, size );
+  ak_mpzn_sub_montgomery( e, e, b, ec->p, size );
+  ak_mpzn_sub_montgomery( f, ep->z, c, ec->p, size );
+  ak_mpzn_add_montgomery( c, ep->z, c, ec->p, size );      // c <- G
+  ak_wcurve_mul_montgomery( a, ec->e, a, ec );
+  ak_mpzn_sub_montgomery( b, b, a, ec->p, size );          // b <- H
+
+  ak_wcurve_mul_montgomery( ep->x, e, f, ec );
+  ak_wcurve_mul_montgomery( ep->y, c, b, ec );
+  ak_wcurve_mul_montgomery( ep->t, e, b, ec );
+  ak_wcurve_mul_montgomery( ep->z, f, c, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Приведение набора точек кривой в форме Эдвардса к аффинной форме. */
+/*! Для каждой точки \f$ (x:y:t:z) \f$ вычисляются значения \f$ u = x/z \f$, \f$ v = y/z \f$
+    и \f$ duv \f$, которые последовательно помещаются в массив `table`.
+    Обратные к координатам \f$ z \f$ вычисляются функцией ak_mpzn_inverse_montgomery_batch().
+
+    @param table Массив, в который помещаются значения; должен содержать `3*count*ec->size` слов.
+    @param points Массив точек кривой.
+    @param count Количество точек.
+    @param ec Эллиптическая кривая, которой принадлежат точки.
+    @return Функция возвращает \ref ak_true. В случае нехватки памяти возвращается \ref ak_false.  */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_epoint_set_affine_table( ak_uint64 *table, ak_epoint points,
+                                                                 size_t count, ak_wcurve ec )
+{
+  size_t i;
+  ak_uint64 *z = NULL, *pt = NULL;
+  const size_t size = ec->size;
+
+  if(( z = malloc( 2*count*size*sizeof( ak_uint64 ))) == NULL ) return ak_false;
+  for( i = 0; i < count; i++ ) ak_mpzn_set( z+i*size, points[i].z, size );
+  ak_mpzn_inverse_montgomery_batch( z, z+count*size, count, ec->p, ec->n, ec->r2, size );
+
+  for( i = 0, pt = table; i < count; i++, pt += 3*size ) {
+     ak_wcurve_mul_montgomery( pt, points[i].x, z+i*size, ec );
+     ak_wcurve_mul_montgomery( pt+size, points[i].y, z+i*size, ec );
+     ak_wcurve_mul_montgomery( pt+2*size, pt, pt+size, ec );
+     ak_wcurve_mul_montgomery( pt+2*size, pt+2*size, ec->d, ec );
+  }
+  free( z );
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Ширина окна, используемая при вычислении суммы кратных точек. */
+ #define ak_wpoint_wnaf_width          (5)
+/*! \brief Количество нечетных кратных точки, вычисляемых заранее: \f$ P, [3]P, \ldots, [15]P \f$. */
+ #define ak_wpoint_wnaf_count          (8)
+/*! \brief Количество 64-х битных слов, занимаемых точкой \f$ (x:y:z) \f$ в компактной форме. */
+ #define ak_wpoint_compact_len( size ) ( 3*( size ))
+/*! \brief Количество 64-х битных слов, занимаемых точкой \f$ (x:y:t:z) \f$ в компактной форме. */
+ #define ak_epoint_compact_len( size ) ( 4*( size ))
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция присваивает точке значение, хранящееся в компактной форме. */
+/*! В компактной форме координаты точки занимают по `size` 64-х битных слов и следуют
+    непосредственно друг за другом, поэтому для 256-ти битных кривых точка занимает 96 байт,
+    а не sizeof( struct wpoint ) байт. Таблицы кратных точек, хранящиеся в такой форме,
+    занимают в кэше вдвое меньше места.
+
+    @param wp Точка, которой присваивается значение.
+    @param pt Указатель на координаты точки в компактной форме.
+    @param affine Если значение истинно, то копируются только координаты \f$ x, y \f$,
+    а координата \f$ z \f$ точки `wp` не изменяется.
+    @param size Размер координат в 64-х битных словах.                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wpoint_set_compact( ak_wpoint wp, const ak_uint64 *pt,
+                                                            bool_t affine, const size_t size )
+{
+  memcpy( wp->x, pt, size*sizeof( ak_uint64 ));
+  memcpy( wp->y, pt+size, size*sizeof( ak_uint64 ));
+  if( !affine ) memcpy( wp->z, pt+2*size, size*sizeof( ak_uint64 ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция помещает координаты точки в массив в компактной форме. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wpoint_to_compact( ak_uint64 *pt, ak_wpoint wp, const size_t size )
+{
+  memcpy( pt, wp->x, size*sizeof( ak_uint64 ));
+  memcpy( pt+size, wp->y, size*sizeof( ak_uint64 ));
+  memcpy( pt+2*size, wp->z, size*sizeof( ak_uint64 ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция присваивает точке в форме Эдвардса значение, хранящееся в компактной форме. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_epoint_set_compact( ak_epoint ep, const ak_uint64 *pt, const size_t size )
+{
+  memcpy( ep->x, pt, size*sizeof( ak_uint64 ));
+  memcpy( ep->y, pt+size, size*sizeof( ak_uint64 ));
+  memcpy( ep->t, pt+2*size, size*sizeof( ak_uint64 ));
+  memcpy( ep->z, pt+3*size, size*sizeof( ak_uint64 ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция помещает координаты точки в форме Эдвардса в массив в компактной форме. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_epoint_to_compact( ak_uint64 *pt, ak_epoint ep, const size_t size )
+{
+  memcpy( pt, ep->x, size*sizeof( ak_uint64 ));
+  memcpy( pt+size, ep->y, size*sizeof( ak_uint64 ));
+  memcpy( pt+2*size, ep->t, size*sizeof( ak_uint64 ));
+  memcpy( pt+3*size, ep->z, size*sizeof( ak_uint64 ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет несмежную форму числа с окном ширины 5 (wNAF). */
+/*! Число \f$ k \f$ представляется в виде \f$ k = \sum_i d_i 2^i \f$, где каждая цифра \f$ d_i \f$
+    либо равна нулю, либо нечетна и удовлетворяет неравенству \f$ |d_i| < 16 \f$, при этом
+    среди любых пяти последовательных цифр не более одной отлично от нуля.
+
+    @param naf массив, в который помещаются цифры (младшая цифра помещается первой);
+    массив должен содержать не менее `64*size + 1` элементов.
+    @param k число, для которого вычисляется представление.
+    @param size размер числа \f$ k \f$ в 64-х битных словах.
+    @return Функция возвращает количество вычисленных цифр.                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ static size_t ak_mpzn_to_wnaf( signed char *naf, ak_uint64 *k, size_t size )
+{
+  int digit;
+  size_t i, len = 0, top = size;
+  ak_uint64 t[ak_mpzn512_size+1];
+
+  ak_mpzn_set( t, k, size );
+  t[size] = 0;
+  while( top > 0 ) {
+    if( t[0]&1 ) {
+      digit = ( int )( t[0]&(( 1 << ak_wpoint_wnaf_width ) - 1 ));
+      if( digit >= ( 1 << ( ak_wpoint_wnaf_width - 1 ))) {
+        digit -= ( 1 << ak_wpoint_wnaf_width );
+        /* t <- t + |digit| */
+        if(( t[0] += ( ak_uint64 )( -digit )) < ( ak_uint64 )( -digit ))
+          for( i = 1; i <= size; i++ ) if( ++t[i] != 0 ) break;
+      } else t[0] -= ( ak_uint64 )digit; /* младшие биты t совпадают с digit, заема нет */
+      naf[len++] = ( signed char )digit;
+    } else naf[len++] = 0;
+
+   /* t <- t/2 */
+    for( i = 0; i < size; i++ ) t[i] = ( t[i] >> 1 )|( t[i+1] << 63 );
+    t[size] >>= 1;
+    while(( top > 0 ) && ( t[top-1] == 0 ) && ( t[top] == 0 )) top--;
+  }
+ return len;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет нечетные кратные точки \f$ P, [3]P, \ldots, [15]P \f$ и
+    противоположные им точки.                                                                      */
+/*! Точка \f$ P \f$ и результаты задаются в координатах, используемых кривой
+    для вычисления кратных точек; в проективных координатах и координатах Якоби
+    противоположная точка получается заменой \f$ y \f$ на \f$ -y \f$.
+
+    @param odd Массив, в который последовательно помещаются точки \f$ P, \ldots, [15]P \f$
+    и \f$ -P, \ldots, -[15]P \f$ в компактной форме; должен содержать
+    `2*ak_wpoint_wnaf_count*ak_wpoint_compact_len( ec->size )` слов.
+    @param wp Точка \f$ P \f$.
+    @param ec Эллиптическая кривая                                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_set_odd_multiples( ak_uint64 *odd, ak_wpoint wp, ak_wcurve ec )
+{
+  size_t i;
+  struct wpoint dbl, R;
+  const size_t size = ec->size, len = ak_wpoint_compact_len( ec->size );
+  ak_uint64 *neg = odd + ak_wpoint_wnaf_count*len;
+
+  ak_wpoint_set_wpoint( &dbl, wp, ec );
+  ak_wpoint_double_internal( &dbl, ec );
+  ak_wpoint_set_wpoint( &R, wp, ec );
+  for( i = 0; i < ak_wpoint_wnaf_count; i++ ) {
+     if( i > 0 ) ak_wpoint_add_internal( &R, &dbl, ak_false, ec );
+     ak_wpoint_to_compact( odd+i*len, &R, size );
+     ak_wpoint_to_compact( neg+i*len, &R, size );
+     if( ak_mpzn_cmp_ui( R.y, size, 0 ) != ak_true )
+       ak_mpzn_sub( neg+i*len+size, ec->p, R.y, size );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет нечетные кратные точки кривой в форме Эдвардса
+    \f$ P, [3]P, \ldots, [15]P \f$ и противоположные им точки.                                     */
+/*! Точки помещаются в массив `odd` в компактной форме, при этом противоположные точки
+    следуют за точками \f$ P, \ldots, [15]P \f$; массив должен содержать
+    `2*ak_wpoint_wnaf_count*ak_epoint_compact_len( ec->size )` слов.                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_epoint_set_odd_multiples( ak_uint64 *odd, ak_epoint ep, ak_wcurve ec )
+{
+  size_t i;
+  struct epoint dbl, R;
+  ak_mpznmax zero = ak_mpznmax_zero;
+  const size_t size = ec->size, len = ak_epoint_compact_len( ec->size );
+  ak_uint64 *neg = odd + ak_wpoint_wnaf_count*len;
+
+  memcpy( &dbl, ep, sizeof( struct epoint ));
+  ak_epoint_double( &dbl, ec );
+  memcpy( &R, ep, sizeof( struct epoint ));
+  for( i = 0; i < ak_wpoint_wnaf_count; i++ ) {
+     if( i > 0 ) ak_epoint_add( &R, &dbl, ec );
+     ak_epoint_to_compact( odd+i*len, &R, size );
+    /* для точки (x:y:t:z) противоположной является точка (-x:y:-t:z) */
+     ak_epoint_to_compact( neg+i*len, &R, size );
+     ak_mpzn_sub_montgomery( neg+i*len, zero, R.x, ec->p, size );
+     ak_mpzn_sub_montgomery( neg+i*len+2*size, zero, R.t, ec->p, size );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                  вычисление кратных точек для образующей точки эллиптической кривой             */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество бит степени, обрабатываемых за одно обращение к таблице кратных точек. */
+ #define ak_wcurve_base_window         (4)
+/*! \brief Количество ненулевых точек в одной строке таблицы кратных точек. */
+ #define ak_wcurve_base_row           (15)
+/*! \brief Максимальное количество эллиптических кривых, для которых хранятся таблицы. */
+ #define ak_wcurve_base_tables_count  (16)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Таблица кратных образующей точки эллиптической кривой. */
+/*! \details Строка таблицы с номером \f$ i \f$ содержит точки \f$ [j\cdot 16^i]P \f$,
+    где \f$ j = 1, \ldots, 15 \f$. Точки хранятся в аффинной форме, формат хранения зависит
+    от формы кривой:
+     - для кривых в форме Вейерштрасса для каждой точки хранятся только координаты
+       \f$ x \f$ и \f$ y \f$ (по `size` 64-х битных слов, то есть `2size` слов на точку),
+       координата \f$ z \f$ полагается равной единице; нечетные кратные хранятся в поле `odd`,
+       а поле `eodd` равно NULL;
+     - для кривых, имеющих форму Эдвардса, для каждой точки хранятся значения
+       \f$ u, v, duv \f$ (по `size` 64-х битных слов, то есть `3size` слов на точку);
+       нечетные кратные в том же формате хранятся в поле `eodd`, а поле `odd` равно NULL.          */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct wcurve_base_table {
+  /*! \brief Эллиптическая кривая, для образующей точки которой вычислена таблица */
+   ak_wcurve wc;
+  /*! \brief Координаты точек таблицы (`2size` или `3size` слов на точку, см. выше) */
+   ak_uint64 *table;
+  /*! \brief Нечетные кратные образующей точки \f$ P, [3]P, \ldots, [15]P \f$
+      и противоположные им точки, используемые функцией ak_wpoint_pow_sum(); хранятся
+      в аффинной форме (по 2size слов на точку) сразу после точек таблицы */
+   ak_uint64 *odd;
+  /*! \brief Нечетные кратные образующей точки и противоположные им точки в аффинной форме
+      Эдвардса (по 3size слов на точку \f$ (u, v, duv) \f$); хранятся сразу после точек
+      таблицы и используются вместо `odd` для кривых, имеющих форму Эдвардса */
+   ak_uint64 *eodd;
+ } *ak_wcurve_base_table;
+
+/*! \brief Таблицы кратных точек, вычисленные в ходе работы библиотеки. */
+ static struct wcurve_base_table wcurve_base_tables[ak_wcurve_base_tables_count];
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ static pthread_mutex_t wcurve_base_tables_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет таблицу кратных образующей точки кривой, имеющей форму Эдвардса. */
+/*! Точки таблицы и нечетные кратные образующей точки вычисляются в форме Эдвардса и
+    одновременно приводятся к аффинной форме: для каждой точки хранятся значения
+    \f$ u, v, duv \f$ (по `size` 64-х битных слов). Нечетные кратные хранятся
+    в той же области памяти, что и таблица, сразу после нее.
+
+    @param bt контекст таблицы, в который помещаются вычисленные значения.
+    @param ec эллиптическая кривая, для образующей точки которой вычисляется таблица.
+    @return Функция возвращает \ref ak_true, если таблица создана. В случае нехватки памяти
+    возвращается \ref ak_false.                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_wcurve_base_table_new_edwards( ak_wcurve_base_table bt, ak_wcurve ec )
+{
+  struct epoint ep;
+  ak_uint64 *table = NULL, *pt = NULL;
+  ak_epoint points = NULL;
+  ak_mpznmax zero = ak_mpznmax_zero;
+  const size_t size = ec->size, len = 3*ec->size,
+               count = ak_wcurve_base_row*ec->size*( 64/ak_wcurve_base_window );
+  size_t i, j;
+
+  if(( table = malloc(( count + 2*ak_wpoint_wnaf_count )*len*sizeof( ak_uint64 ))) == NULL )
+    return ak_false;
+  if(( points = malloc(( count + ak_wpoint_wnaf_count )*sizeof( struct epoint ))) == NULL ) {
+    free( table );
+    return ak_false;
+  }
+
+ /* вычисляем точки [j*16^i]P, а также нечетные кратные P */
+  ak_epoint_set_wpoint( &ep, &ec->point, ec );
+  for( i = 0; i < count; i += ak_wcurve_base_row ) {
+     memcpy( points+i, &ep, sizeof( struct epoint ));
+     for( j = 1; j < ak_wcurve_base_row; j++ ) {
+        memcpy( points+i+j, points+i+j-1, sizeof( struct epoint ));
+        ak_epoint_add( points+i+j, &ep, ec );
+     }
+     for( j = 0; j < ak_wcurve_base_window; j++ ) ak_epoint_double( &ep, ec );
+  }
+  ak_epoint_set_wpoint( &ep, &ec->point, ec );
+  memcpy( points+count, &ep, sizeof( struct epoint ));
+  ak_epoint_double( &ep, ec );
+  for( i = 1; i < ak_wpoint_wnaf_count; i++ ) {
+     memcpy( points+count+i, points+count+i-1, sizeof( struct epoint ));
+     ak_epoint_add( points+count+i, &ep, ec );
+  }
+
+ /* приводим точки к аффинной форме и вычисляем противоположные к нечетным кратным */
+  if( !ak_epoint_set_affine_table( table, points, count + ak_wpoint_wnaf_count, ec )) {
+    free( points );
+    free( table );
+    return ak_false;
+  }
+  free( points );
+  for( i = 0, pt = table+count*len; i < ak_wpoint_wnaf_count; i++ ) {
+     ak_mpzn_sub_montgomery( pt+( i+ak_wpoint_wnaf_count )*len, zero, pt+i*len, ec->p, size );
+     ak_mpzn_set( pt+( i+ak_wpoint_wnaf_count )*len+size, pt+i*len+size, size );
+     ak_mpzn_sub_montgomery( pt+( i+ak_wpoint_wnaf_count )*len+2*size,
+                                                          zero, pt+i*len+2*size, ec->p, size );
+  }
+
+  bt->wc = ec;
+  bt->table = table;
+  bt->odd = NULL;
+  bt->eodd = table+count*len;
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет таблицу кратных образующей точки эллиптической кривой. */
+/*! Точки таблицы и нечетные кратные образующей точки вычисляются в координатах, используемых
+    кривой, после чего все они одновременно приводятся к аффинной форме: обратные элементы
+    к координатам \f$ z \f$ вычисляются функцией ak_mpzn_inverse_montgomery_batch().
+    Аффинные координаты хранятся в представлении Монтгомери, а координата \f$ z \f$
+    нечетных кратных полагается равной единице, поэтому они могут использоваться
+    как в проективных координатах, так и в координатах Якоби.
+
+    @param bt контекст таблицы, в который помещаются вычисленные значения.
+    @param ec эллиптическая кривая, для образующей точки которой вычисляется таблица.
+    @return Функция возвращает \ref ak_true, если таблица создана. В случае нехватки памяти
+    возвращается \ref ak_false.                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_wcurve_base_table_new( ak_wcurve_base_table bt, ak_wcurve ec )
+{
+  struct wpoint wp;
+  ak_uint64 *table = NULL, *z = NULL, *pt = NULL;
+  ak_wpoint points = NULL;
+  ak_mpznmax u, zero = ak_mpznmax_zero;
+  const size_t size = ec->size, len = 2*ec->size,
+               count = ak_wcurve_base_row*ec->size*( 64/ak_wcurve_base_window ),
+               total = count + ak_wpoint_wnaf_count;
+  size_t i, j;
+
+  if( ec->coordinates == edwards_coordinates ) return ak_wcurve_base_table_new_edwards( bt, ec );
+  table = malloc(( count + 2*ak_wpoint_wnaf_count )*len*sizeof( ak_uint64 ));
+  points = malloc( total*sizeof( struct wpoint ));
+  z = malloc( 2*total*size*sizeof( ak_uint64 ));
+  if(( table == NULL ) || ( points == NULL ) || ( z == NULL )) {
+    if( table != NULL ) free( table );
+    if( points != NULL ) free( points );
+    if( z != NULL ) free( z );
+    return ak_false;
+  }
+
+ /* вычисляем точки [j*16^i]P */
+  ak_wpoint_set( &wp, ec );
+  ak_wpoint_set_jacobian( &wp, ec );
+  for( i = 0; i < count; i += ak_wcurve_base_row ) {
+     ak_wpoint_set_wpoint( points+i, &wp, ec );
+     for( j = 1; j < ak_wcurve_base_row; j++ ) {
+        ak_wpoint_set_wpoint( points+i+j, points+i+j-1, ec );
+        ak_wpoint_add_internal( points+i+j, &wp, ak_false, ec );
+     }
+     for( j = 0; j < ak_wcurve_base_window; j++ ) ak_wpoint_double_internal( &wp, ec );
+  }
+ /* вычисляем нечетные кратные P */
+  ak_wpoint_set( &wp, ec );
+  ak_wpoint_set_jacobian( &wp, ec );
+  ak_wpoint_set_wpoint( points+count, &wp, ec );
+  ak_wpoint_double_internal( &wp, ec );
+  for( i = 1; i < ak_wpoint_wnaf_count; i++ ) {
+     ak_wpoint_set_wpoint( points+count+i, points+count+i-1, ec );
+     ak_wpoint_add_internal( points+count+i, &wp, ak_false, ec );
+  }
+
+ /* приводим все точки к аффинной форме */
+  for( i = 0; i < total; i++ ) ak_mpzn_set( z+i*size, points[i].z, size );
+  ak_mpzn_inverse_montgomery_batch( z, z+total*size, total, ec->p, ec->n, ec->r2, size );
+  ak_wcurve_set_montgomery_one( u, ec );
+  for( i = 0; i < total; i++ ) {
+     if( ak_wcurve_is_jacobian( ec )) {
+       ak_wcurve_sqr_montgomery( points[i].z, z+i*size, ec );
+       ak_wcurve_mul_montgomery( points[i].x, points[i].x, points[i].z, ec );
+       ak_wcurve_mul_montgomery( points[i].z, points[i].z, z+i*size, ec );
+       ak_wcurve_mul_montgomery( points[i].y, points[i].y, points[i].z, ec );
+     } else {
+         ak_wcurve_mul_montgomery( points[i].x, points[i].x, z+i*size, ec );
+         ak_wcurve_mul_montgomery( points[i].y, points[i].y, z+i*size, ec );
+       }
+     ak_mpzn_set( points[i].z, u, size );
+  }
+  for( i = 0; i < total; i++ ) {
+     ak_mpzn_set( table+i*len, points[i].x, size );
+     ak_mpzn_set( table+i*len+size, points[i].y, size );
+  }
+ /* вычисляем точки, противоположные нечетным кратным */
+  for( i = 0, pt = table+count*len; i < ak_wpoint_wnaf_count; i++ ) {
+     ak_mpzn_set( pt+( i+ak_wpoint_wnaf_count )*len, pt+i*len, size );
+     ak_mpzn_sub_montgomery( pt+( i+ak_wpoint_wnaf_count )*len+size,
+                                                               zero, pt+i*len+size, ec->p, size );
+  }
+  free( points );
+  free( z );
+
+  bt->wc = ec;
+  bt->table = table;
+  bt->odd = table+count*len;
+  bt->eodd = NULL;
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает таблицу кратных образующей точки, вычисляя ее при первом обращении. */
+/*! @param ec эллиптическая кривая.
+    @return Функция возвращает указатель на контекст таблицы. Если таблица не может быть создана,
+    то возвращается NULL.                                                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_wcurve_base_table ak_wcurve_base_table_get( ak_wcurve ec )
+{
+  size_t i;
+  ak_wcurve_base_table table = NULL;
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_lock( &wcurve_base_tables_mutex );
+#endif
+  for( i = 0; i < ak_wcurve_base_tables_count; i++ ) {
+     if( wcurve_base_tables[i].wc == ec ) {
+       table = wcurve_base_tables+i;
+       break;
+     }
+     if( wcurve_base_tables[i].wc == NULL ) {
+       if( ak_wcurve_base_table_new( wcurve_base_tables+i, ec )) table = wcurve_base_tables+i;
+       break;
+     }
+  }
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_unlock( &wcurve_base_tables_mutex );
+#endif
+ return table;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция удаляет все таблицы кратных точек, созданные функцией ak_wpoint_pow_base().
+    Функция вызывается при завершении работы с библиотекой.                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wcurve_base_tables_destroy( void )
+{
+  size_t i;
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_lock( &wcurve_base_tables_mutex );
+#endif
+  for( i = 0; i < ak_wcurve_base_tables_count; i++ ) {
+     if( wcurve_base_tables[i].table != NULL ) free( wcurve_base_tables[i].table );
+     wcurve_base_tables[i].table = NULL;
+     wcurve_base_tables[i].odd = NULL;
+     wcurve_base_tables[i].eodd = NULL;
+     wcurve_base_tables[i].wc = NULL;
+  }
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_unlock( &wcurve_base_tables_mutex );
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Полное сложение двух точек, заданных в проективных координатах. */
+/*! Для точек \f$ P = (x_1:y_1:z_1) \f$ и \f$ Q = (x_2:y_2:z_2) \f$ вычисляется сумма
+    \f$ P + Q \f$, которая присваивается точке \f$ P \f$. Используются полные формулы
+    сложения J.Renes, C.Costello, L.Batina
+    <a href="http://eprint.iacr.org/2015/1060">Complete addition formulas for prime order
+    elliptic curves</a>, 2016 (алгоритм 1), где \f$ b_3 = 3b \f$.
+
+    \code
+      t0 = X1*X2, t1 = Y1*Y2, t2 = Z1*Z2
+      t3 = (X1+Y1)*(X2+Y2)-t0-t1
+      t4 = (X1+Z1)*(X2+Z2)-t0-t2
+      t5 = (Y1+Z1)*(Y2+Z2)-t1-t2
+      Z3 = a*t4+b3*t2, X3 = t1-Z3, Z3 = t1+Z3, Y3 = X3*Z3
+      t1 = 3*t0+a*t2, t4 = b3*t4+a*(t0-a*t2)
+      X3 = t3*X3-t5*t4
+      Y3 = Y3+t1*t4
+      Z3 = t5*Z3+t3*t1
+    \endcode
+
+    Формулы корректны для любых точек подгруппы нечетного порядка, в том числе для
+    бесконечно удаленной точки и совпадающих точек, и не содержат ветвлений, поэтому
+    время сложения не зависит от значений складываемых точек.
+
+    @param wp1 Точка \f$ P \f$, в которую помещается результат операции сложения; первое слагаемое
+    @param wp2 Точка \f$ Q \f$, второе слагаемое
+    @param b3 Значение \f$ 3b \f$ в представлении Монтгомери
+    @param ec Эллиптическая кривая, которой принадлежат складываемые точки                         */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_add_complete( ak_wpoint wp1, ak_wpoint wp2, ak_uint64 *b3, ak_wcurve ec )
+{
+  ak_mpznmax t0, t1, t2, t3, t4, t5, u;
+  const size_t size = ec->size;
+
+  ak_wcurve_mul_montgomery( t0, wp1->x, wp2->x, ec );
+  ak_wcurve_mul_montgomery( t1, wp1->y, wp2->y, ec );
+  ak_wcurve_mul_montgomery( t2, wp1->z, wp2->z, ec );
+
+  ak_mpzn_add_montgomery( t3, wp1->x, wp1->y, ec->p, size );
+  ak_mpzn_add_montgomery( u, wp2->x, wp2->y, ec->p, size );
+  ak_wcurve_mul_montgomery( t3, t3, u, ec );
+  ak_mpzn_add_montgomery( u, t0, t1, ec->p, size );
+  ak_mpzn_sub_montgomery( t3, t3, u, ec->p, size );                       // t3 = X1Y2+X2Y1
+
+  ak_mpzn_add_montgomery( t4, wp1->x, wp1->z, ec->p, size );
+  ak_mpzn_add_montgomery( u, wp2->x, wp2->z, ec->p, size );
+  ak_wcurve_mul_montgomery( t4, t4, u, ec );
+  ak_mpzn_add_montgomery( u, t0, t2, ec->p, size );
+  ak_mpzn_sub_montgomery( t4, t4, u, ec->p, size );                       // t4 = X1Z2+X2Z1
+
+  ak_mpzn_add_montgomery( t5, wp1->y, wp1->z, ec->p, size );
+  ak_mpzn_add_montgomery( u, wp2->y, wp2->z, ec->p, size );
+  ak_wcurve_mul_montgomery( t5, t5, u, ec );
+  ak_mpzn_add_montgomery( u, t1, t2, ec->p, size );
+  ak_mpzn_sub_montgomery( t5, t5, u, ec->p, size );                       // t5 = Y1Z2+Y2Z1
+
+  ak_wcurve_mul_montgomery( wp1->z, ec->a, t4, ec );
+  ak_wcurve_mul_montgomery( u, b3, t2, ec );
+  ak_mpzn_add_montgomery( wp1->z, wp1->z, u, ec->p, size );
+  ak_mpzn_sub_montgomery( wp1->x, t1, wp1->z, ec->p, size );
+  ak_mpzn_add_montgomery( wp1->z, t1, wp1->z, ec->p, size );
+  ak_wcurve_mul_montgomery( wp1->y, wp1->x, wp1->z, ec );
+
+  ak_mpzn_lshift_montgomery( t1, t0, ec->p, size );
+  ak_mpzn_add_montgomery( t1, t1, t0, ec->p, size );                      // t1 = 3*t0
+  ak_wcurve_mul_montgomery( t2, ec->a, t2, ec );
+  ak_wcurve_mul_montgomery( t4, b3, t4, ec );
+  ak_mpzn_add_montgomery( t1, t1, t2, ec->p, size );
+  ak_mpzn_sub_montgomery( t2, t0, t2, ec->p, size );
+  ak_wcurve_mul_montgomery( t2, ec->a, t2, ec );
+  ak_mpzn_add_montgomery( t4, t4, t2, ec->p, size );
+
+  ak_wcurve_mul_montgomery( t0, t1, t4, ec );
+  ak_mpzn_add_montgomery( wp1->y, wp1->y, t0, ec->p, size );
+  ak_wcurve_mul_montgomery( t0, t5, t4, ec );
+  ak_wcurve_mul_montgomery( wp1->x, t3, wp1->x, ec );
+  ak_mpzn_sub_montgomery( wp1->x, wp1->x, t0, ec->p, size );
+  ak_wcurve_mul_montgomery( t0, t3, t1, ec );
+  ak_wcurve_mul_montgomery( wp1->z, t5, wp1->z, ec );
+  ak_mpzn_add_montgomery( wp1->z, wp1->z, t0, ec->p, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление кратной точки для образующей точки кривой, имеющей форму Эдвардса. */
+/*! Функция реализует метод, используемый функцией ak_wpoint_pow_base(), однако все вычисления
+    выполняются в форме Эдвардса. Нулевой цифре степени соответствует нейтральный элемент
+    \f$ (0, 1, 0) \f$, который выбирается с наложением маски; поскольку формулы сложения
+    корректны для любых точек, время вычислений не зависит от значения степени.
+
+    @param wq Точка \f$ Q \f$, в которую помещается результат.
+    @param k Степень кратности; вычет, занимающий `ec->size` машинных слов.
+    @param bt Таблица кратных образующей точки.
+    @param ec Эллиптическая кривая, на которой происходят вычисления                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_epoint_pow_base( ak_wpoint wq, ak_uint64 *k,
+                                                      ak_wcurve_base_table bt, ak_wcurve ec )
+{
+  struct epoint Q;
+  ak_uint64 T[3*ak_mpzn512_size], one[ak_mpzn512_size];
+  size_t i, j, l, size = ec->size, len = 3*ec->size;
+  ak_uint64 digit, mask, *row = bt->table;
+
+  ak_epoint_set_as_unit( &Q, ec );
+  ak_mpzn_set( one, Q.y, size );
+  for( i = 0; i < size*( 64/ak_wcurve_base_window ); i++, row += len*ak_wcurve_base_row ) {
+    /* выделяем очередную цифру степени */
+     digit = ( k[i/( 64/ak_wcurve_base_window )] >>
+                 ( ak_wcurve_base_window*( i%( 64/ak_wcurve_base_window ))))&ak_wcurve_base_row;
+
+    /* выбираем точку из таблицы, просматривая всю строку */
+     memset( T, 0, sizeof( T ));
+     for( j = 0; j < ak_wcurve_base_row; j++ ) {
+        mask = ( ak_uint64 )0 - ((( digit^( j+1 )) - 1 ) >> 63 );
+        for( l = 0; l < len; l++ ) T[l] |= row[j*len + l]&mask;
+     }
+    /* для нулевой цифры получаем нейтральный элемент */
+     mask = ( ak_uint64 )0 - (( digit - 1 ) >> 63 );
+     for( l = 0; l < size; l++ ) T[size+l] |= one[l]&mask;
+     ak_epoint_add_affine( &Q, T, ec );
+  }
+
+  ak_wpoint_set_epoint( wq, &Q, ec );
+  memset( &Q, 0, sizeof( struct epoint ));
+  memset( T, 0, sizeof( T ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление суммы кратных двух точек кривой, имеющей форму Эдвардса. */
+/*! Функция реализует метод Штрауса, используемый функцией ak_wpoint_pow_sum(), для точек,
+    предварительно переведенных в форму Эдвардса. Кратные образующей точки берутся из таблицы
+    в аффинной форме, что позволяет использовать более быстрое сложение.
+
+    @param wr Точка \f$ R \f$, в которую помещается результат.
+    @param wp Точка \f$ P \f$.
+    @param nafk Несмежная форма степени кратности точки \f$ P \f$.
+    @param lenk Количество цифр в несмежной форме `nafk`.
+    @param wq Точка \f$ Q \f$.
+    @param nafl Несмежная форма степени кратности точки \f$ Q \f$.
+    @param lenl Количество цифр в несмежной форме `nafl`.
+    @param ec Эллиптическая кривая, на которой происходят вычисления                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_epoint_pow_sum( ak_wpoint wr, ak_wpoint wp, signed char *nafk, size_t lenk,
+                                    ak_wpoint wq, signed char *nafl, size_t lenl, ak_wcurve ec )
+{
+  struct epoint R, ep;
+  ak_uint64 op[2*ak_wpoint_wnaf_count*ak_epoint_compact_len( ak_mpzn512_size )],
+            oq[2*ak_wpoint_wnaf_count*ak_epoint_compact_len( ak_mpzn512_size )];
+  size_t i, len = 3*ec->size, elen = ak_epoint_compact_len( ec->size );
+  ak_uint64 *table = NULL;
+  ak_wcurve_base_table bt = NULL;
+
+  if(( wp == &ec->point ) && (( bt = ak_wcurve_base_table_get( ec )) != NULL )) table = bt->eodd;
+   else {
+     ak_epoint_set_wpoint( &ep, wp, ec );
+     ak_epoint_set_odd_multiples( op, &ep, ec );
+   }
+  ak_epoint_set_wpoint( &ep, wq, ec );
+  ak_epoint_set_odd_multiples( oq, &ep, ec );
+
+  ak_epoint_set_as_unit( &R, ec );
+  for( i = ( lenk > lenl ? lenk : lenl ); i > 0; i-- ) {
+     ak_epoint_double( &R, ec );
+     if(( i <= lenk ) && nafk[i-1] ) {
+       if( table != NULL ) ak_epoint_add_affine( &R, table + len*( nafk[i-1] > 0 ?
+                     ( nafk[i-1] >> 1 ) : ak_wpoint_wnaf_count + (( -nafk[i-1] ) >> 1 )), ec );
+        else {
+          ak_epoint_set_compact( &ep, op + elen*( nafk[i-1] > 0 ?
+                  ( nafk[i-1] >> 1 ) : ak_wpoint_wnaf_count + (( -nafk[i-1] ) >> 1 )), ec->size );
+          ak_epoint_add( &R, &ep, ec );
+        }
+     }
+     if(( i <= lenl ) && nafl[i-1] ) {
+       ak_epoint_set_compact( &ep, oq + elen*( nafl[i-1] > 0 ?
+                  ( nafl[i-1] >> 1 ) : ak_wpoint_wnaf_count + (( -nafl[i-1] ) >> 1 )), ec->size );
+       ak_epoint_add( &R, &ep, ec );
+     }
+  }
+  ak_wpoint_set_epoint( wr, &R, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для образующей точки \f$ P \f$ эллиптической кривой и заданного целого числа (вычета) \f$ k \f$
+    функция вычисляет кратную точку \f$ Q = [k]P \f$.
+
+    Число \f$ k \f$ представляется в виде \f$ k = \sum_i k_i 16^i \f$, где \f$ 0 \leq k_i < 16\f$,
+    после чего вычисляется сумма \f$ Q = \sum_i [k_i 16^i]P \f$, все слагаемые которой
+    берутся из заранее вычисленной таблицы. Таблица вычисляется один раз для каждой кривой
+    при первом вызове функции и далее используется всеми потоками. В отличие от функции
+    ak_wpoint_pow() удвоения точек не требуются, а количество сложений точек
+    сокращается в восемь раз.
+
+    Для выбора точки из таблицы выполняется просмотр всей строки таблицы с наложением маски,
+    а нулевой цифре соответствует бесконечно удаленная точка \f$ (0:1:0) \f$, также выбираемая
+    с наложением маски. Сложение точек выполняется по полным формулам (функция
+    ak_wpoint_add_complete(), для кривых, имеющих искривленную форму Эдвардса, сложение
+    выполняется в этой форме), не содержащим ветвлений. Поэтому и последовательность
+    обращений к памяти, и последовательность выполняемых операций не зависят
+    от значения \f$ k \f$. Если таблица не может быть создана, вычисление выполняется
+    функцией ak_wpoint_pow(), время работы которой от значения \f$ k \f$ зависит.
+
+    \b Для \b информации: функция не приводит результирующую точку \f$ Q \f$ к аффинной форме.
+
+    @param wq Точка \f$ Q \f$, в которую помещается результат.
+    @param k Степень кратности; вычет, занимающий `ec->size` машинных слов.
+    @param ec Эллиптическая кривая, на которой происходят вычисления                               */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_pow_base( ak_wpoint wq, ak_uint64 *k, ak_wcurve ec )
+{
+  struct wpoint Q, T;
+  size_t i, j, l, size = ec->size;
+  ak_uint64 digit, mask, *row = NULL;
+  ak_mpznmax one, b3;
+  ak_wcurve_base_table bt = NULL;
+
+  if(( bt = ak_wcurve_base_table_get( ec )) == NULL ) {
+    ak_wpoint_pow( wq, &ec->point, k, size, ec );
+    return;
+  }
+  if( bt->eodd != NULL ) {
+    ak_epoint_pow_base( wq, k, bt, ec );
+    return;
+  }
+  row = bt->table;
+
+  ak_wcurve_set_montgomery_one( one, ec );
+  ak_mpzn_lshift_montgomery( b3, ec->b, ec->p, size );
+  ak_mpzn_add_montgomery( b3, b3, ec->b, ec->p, size );
+  ak_wpoint_set_as_unit( &Q, ec );
+  ak_mpzn_set( Q.y, one, size );
+  for( i = 0; i < size*( 64/ak_wcurve_base_window ); i++, row += 2*ak_wcurve_base_row*size ) {
+    /* выделяем очередную цифру степени */
+     digit = ( k[i/( 64/ak_wcurve_base_window )] >>
+                 ( ak_wcurve_base_window*( i%( 64/ak_wcurve_base_window ))))&ak_wcurve_base_row;
+
+    /* выбираем точку из таблицы, просматривая всю строку */
+     memset( &T, 0, sizeof( struct wpoint ));
+     for( j = 0; j < ak_wcurve_base_row; j++ ) {
+        mask = ( ak_uint64 )0 - ((( digit^( j+1 )) - 1 ) >> 63 );
+        for( l = 0; l < size; l++ ) {
+           T.x[l] |= row[2*j*size + l]&mask;
+           T.y[l] |= row[(2*j+1)*size + l]&mask;
+        }
+     }
+    /* для нулевой цифры получаем бесконечно удаленную точку (0:1:0) */
+     mask = (( digit - 1 ) >> 63 ) - 1;
+     for( l = 0; l < size; l++ ) {
+        T.y[l] |= one[l]&~mask;
+        T.z[l] = one[l]&mask;
+     }
+     ak_wpoint_add_complete( &Q, &T, b3, ec );
+  }
+
   ak_wpoint_set_wpoint( wq, &Q, ec );
+  memset( &Q, 0, sizeof( struct wpoint ));
+  memset( &T, 0, sizeof( struct wpoint ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для заданных точек \f$ P, Q \f$ и целых чисел (вычетов) \f$ k, l \f$
+    функция вычисляет точку \f$ R = [k]P + [l]Q \f$.
+
+    При вычислении используется метод Штрауса: числа \f$ k \f$ и \f$ l \f$ представляются
+    в несмежной форме с окном ширины 5 (wNAF), после чего обе кратные точки вычисляются
+    одновременно с использованием одной общей последовательности удвоений. Для каждой
+    из точек \f$ P \f$ и \f$ Q \f$ заранее вычисляются кратные
+    \f$ \pm P, \pm[3]P, \ldots, \pm[15]P \f$; если \f$ P \f$ является образующей точкой кривой,
+    то ее кратные берутся из таблицы, вычисленной один раз для каждой кривой.
+    По сравнению с двумя вызовами функции ak_wpoint_pow() количество удвоений сокращается
+    вдвое, а количество сложений -- примерно в шесть раз. Вычисления выполняются
+    в координатах, выбранных для кривой (см. \ref wcurve_coordinates_t); для кривых,
+    использующих форму Эдвардса, точки \f$ P \f$ и \f$ Q \f$ переводятся в эту форму.
+
+    \warning Время работы функции зависит от значений \f$ k \f$ и \f$ l \f$, поэтому функция
+    может использоваться только для вычислений с открытыми данными, например,
+    при проверке электронной подписи.
+
+    \b Для \b информации: функция не приводит результирующую точку \f$ R \f$ к аффинной форме.
+
+    @param wr Точка \f$ R \f$, в которую помещается результат.
+    @param wp Точка \f$ P \f$.
+    @param k Степень кратности точки \f$ P \f$.
+    @param wq Точка \f$ Q \f$.
+    @param l Степень кратности точки \f$ Q \f$.
+    @param size Размер степеней \f$ k \f$ и \f$ l \f$ в машинных словах, не более
+    \ref ak_mpzn512_size.
+    @param ec Эллиптическая кривая, на которой происходят вычисления                               */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_pow_sum( ak_wpoint wr, ak_wpoint wp, ak_uint64 *k,
+                                           ak_wpoint wq, ak_uint64 *l, size_t size, ak_wcurve ec )
+{
+  struct wpoint R, T, S;
+  ak_uint64 op[2*ak_wpoint_wnaf_count*ak_wpoint_compact_len( ak_mpzn512_size )],
+            oq[2*ak_wpoint_wnaf_count*ak_wpoint_compact_len( ak_mpzn512_size )], *pp = op;
+  signed char nafk[64*ak_mpzn512_size+1], nafl[64*ak_mpzn512_size+1];
+  size_t i, j, lenk, lenl, plen = ak_wpoint_compact_len( ec->size ),
+                           qlen = ak_wpoint_compact_len( ec->size );
+  ak_wcurve_base_table bt = NULL;
+  bool_t affine = ak_false;
+
+  lenk = ak_mpzn_to_wnaf( nafk, k, size );
+  lenl = ak_mpzn_to_wnaf( nafl, l, size );
+  if( ec->coordinates == edwards_coordinates ) {
+    ak_epoint_pow_sum( wr, wp, nafk, lenk, wq, nafl, lenl, ec );
+    return;
+  }
+  if(( wp == &ec->point ) && (( bt = ak_wcurve_base_table_get( ec )) != NULL )) {
+   /* точки таблицы хранятся в аффинной форме, координата z полагается равной единице */
+    pp = bt->odd;
+    plen = 2*ec->size;
+    affine = ak_true;
+    ak_wcurve_set_montgomery_one( T.z, ec );
+  } else {
+     ak_wpoint_set_wpoint( &R, wp, ec );
+     ak_wpoint_set_jacobian( &R, ec );
+     ak_wpoint_set_odd_multiples( op, &R, ec );
+    }
+  ak_wpoint_set_wpoint( &R, wq, ec );
+  ak_wpoint_set_jacobian( &R, ec );
+  ak_wpoint_set_odd_multiples( oq, &R, ec );
+
+  ak_wpoint_set_as_unit( &R, ec );
+  for( i = ( lenk > lenl ? lenk : lenl ); i > 0; i-- ) {
+     ak_wpoint_double_internal( &R, ec );
+     if(( i <= lenk ) && nafk[i-1] ) {
+       j = nafk[i-1] > 0 ? ( nafk[i-1] >> 1 ) : ak_wpoint_wnaf_count + (( -nafk[i-1] ) >> 1 );
+       ak_wpoint_set_compact( &T, pp + plen*j, affine, ec->size );
+       ak_wpoint_add_internal( &R, &T, affine, ec );
+     }
+     if(( i <= lenl ) && nafl[i-1] ) {
+       j = nafl[i-1] > 0 ? ( nafl[i-1] >> 1 ) : ak_wpoint_wnaf_count + (( -nafl[i-1] ) >> 1 );
+       ak_wpoint_set_compact( &S, oq + qlen*j, ak_false, ec->size );
+       ak_wpoint_add_internal( &R, &S, ak_false, ec );
+     }
+  }
+  ak_wpoint_set_projective( &R, ec );
+  ak_wpoint_set_wpoint( wr, &R, ec );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
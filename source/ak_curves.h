@@ -57,6 +57,66 @@
  void ak_wpoint_reduce( ak_wpoint , ak_wcurve );
 /*! \brief Вычисление кратной точки эллиптической кривой. */
  void ak_wpoint_pow( ak_wpoint , ak_wpoint , ak_uint64 *, size_t , ak_wcurve );
+/*! \brief Вычисление кратной точки для образующей точки эллиптической кривой. */
+ void ak_wpoint_pow_base( ak_wpoint , ak_uint64 *, ak_wcurve );
+/*! \brief Вычисление суммы кратных двух точек эллиптической кривой. */
+ void ak_wpoint_pow_sum( ak_wpoint , ak_wpoint , ak_uint64 *, ak_wpoint , ak_uint64 *,
+                                                                             size_t , ak_wcurve );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Класс, реализующий точку эллиптической кривой в искривленной форме Эдвардса.
+
+    Класс представляет собой точку \f$ P \f$ эллиптической кривой, заданной в искривленной
+    форме Эдвардса \f$ eu^2 + v^2 \equiv 1 + du^2v^2 \pmod{p} \f$, в расширенных
+    проективных координатах, т.е. точка представляется в виде вектора \f$ P=(x:y:t:z) \f$,
+    для которого \f$ u = x/z \f$, \f$ v = y/z \f$ и \f$ xy = tz \f$.
+    Нейтральным элементом группы точек является точка \f$ (0:1:0:1) \f$.
+    Для координат точки используется представление Монтгомери.                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ struct epoint
+{
+/*! \brief x-координата точки эллиптической кривой */
+ ak_uint64 x[ak_mpzn512_size];
+/*! \brief y-координата точки эллиптической кривой */
+ ak_uint64 y[ak_mpzn512_size];
+/*! \brief t-координата точки эллиптической кривой */
+ ak_uint64 t[ak_mpzn512_size];
+/*! \brief z-координата точки эллиптической кривой */
+ ak_uint64 z[ak_mpzn512_size];
+};
+/*! \brief Контекст точки эллиптической кривой в искривленной форме Эдвардса */
+ typedef struct epoint *ak_epoint;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Проверка наличия у эллиптической кривой искривленной формы Эдвардса. */
+ bool_t ak_wcurve_is_edwards( ak_wcurve );
+/*! \brief Присвоение контексту значения нейтрального элемента группы точек в форме Эдвардса. */
+ int ak_epoint_set_as_unit( ak_epoint , ak_wcurve );
+/*! \brief Преобразование точки из формы Вейерштрасса в искривленную форму Эдвардса. */
+ int ak_epoint_set_wpoint( ak_epoint , ak_wpoint , ak_wcurve );
+/*! \brief Преобразование точки из искривленной формы Эдвардса в форму Вейерштрасса. */
+ int ak_wpoint_set_epoint( ak_wpoint , ak_epoint , ak_wcurve );
+/*! \brief Удвоение точки эллиптической кривой в искривленной форме Эдвардса. */
+ void ak_epoint_double( ak_epoint , ak_wcurve );
+/*! \brief Сложение двух точек эллиптической кривой в искривленной форме Эдвардса. */
+ void ak_epoint_add( ak_epoint , ak_epoint , ak_wcurve );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Координаты, используемые при вычислении кратных точек эллиптической кривой. */
+/*! Вне зависимости от выбранного варианта функции, вычисляющие кратные точки, получают
+    на вход и возвращают точки в проективных координатах \f$ (x:y:z) \f$; выбор
+    координат влияет только на промежуточные вычисления.                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef enum {
+  /*! \brief Проективные координаты \f$ (x:y:z) \f$, для которых \f$ x_0 = x/z, y_0 = y/z \f$. */
+   projective_coordinates,
+  /*! \brief Координаты Якоби \f$ (x:y:z) \f$, для которых \f$ x_0 = x/z^2, y_0 = y/z^3 \f$. */
+   jacobian_coordinates,
+  /*! \brief Координаты Якоби для кривых с коэффициентом \f$ a = -3 \f$. */
+   jacobian_a3_coordinates,
+  /*! \brief Расширенные координаты искривленной формы Эдвардса. */
+   edwards_coordinates
+} wcurve_coordinates_t;
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Класс, реализующий эллиптическую кривую, заданную в короткой форме Вейерштрасса
@@ -72,7 +132,15 @@
     или \f$ r=2^{512}\f$, тогда \f$ n \equiv n_0 \pmod{2^{64}}\f$,
     где \f$ n_0 \equiv -p^{-1} \pmod{r}\f$.
 
-    Величина \f$ r_2 \f$ удовлетворяет сравнению \f$ r_2 \equiv r^2 \pmod{p}\f$.                   */
+    Величина \f$ r_2 \f$ удовлетворяет сравнению \f$ r_2 \equiv r^2 \pmod{p}\f$, величина
+    \f$ \mu = \lfloor r^2/q \rfloor \f$ используется для приведения по модулю \f$ q \f$.
+
+    Если кривая имеет искривленную форму Эдвардса \f$ eu^2 + v^2 \equiv 1 + du^2v^2 \pmod{p} \f$,
+    то контекст содержит параметры \f$ e, d \f$, а также величины
+    \f$ s = (e-d)/4 \f$ и \f$ t = (e+d)/6 \f$, задающие замену переменных
+    \f$ x = s(1+v)/(1-v) + t \f$, \f$ y = s(1+v)/((1-v)u) \f$. В этом случае
+    \f$ a = s^2 - 3t^2 \f$ и \f$ b = 2t^3 - ts^2 \f$. Для остальных кривых
+    эти параметры равны нулю.                                                                      */
 /* ----------------------------------------------------------------------------------------------- */
  struct wcurve
 {
@@ -80,6 +148,11 @@
   ak_uint32 size;
  /*! \brief Кофактор эллиптической кривой - делитель порядка группы точек. */
   ak_uint32 cofactor;
+ /*! \brief Координаты, используемые при вычислении кратных точек. */
+  wcurve_coordinates_t coordinates;
+ /*! \brief Функция приведения в представлении Монтгомери для модуля специального вида.
+     \details Если указатель равен NULL, используется умножение Монтгомери общего вида. */
+  ak_function_mpzn_redc *redc;
  /*! \brief Коэффициент \f$ a \f$ эллиптической кривой (в представлении Монтгомери) */
   ak_uint64 a[ak_mpzn512_size];
  /*! \brief Коэффициент \f$ b \f$ эллиптической кривой (в представлении Монтгомери). */
@@ -92,6 +165,9 @@
   ak_uint64 q[ak_mpzn512_size];
  /*! \brief Величина \f$ r^2\f$, взятая по модулю \f$ q \f$ и используемая в арифметике Монтгомери. */
   ak_uint64 r2q[ak_mpzn512_size];
+ /*! \brief Величина \f$ \mu = \lfloor r^2/q \rfloor \f$, используемая при приведении по модулю \f$ q \f$
+     методом Барретта. */
+  ak_uint64 mu[ak_mpzn512_size+1];
  /*! \brief Точка \f$ P \f$ эллиптической кривой, порождающая подгруппу порядка \f$ q \f$. */
   struct wpoint point;
  /*! \brief Константа \f$ n \f$, используемая в арифметике Монтгомери по модулю \f$ p \f$. */
@@ -101,6 +177,14 @@
  /*! \brief Строка, содержащая символьную запись модуля \f$ p \f$.
      \details Используется для проверки корректного хранения параметров кривой в памяти. */
   const char *pchar;
+ /*! \brief Параметр \f$ e \f$ кривой в искривленной форме Эдвардса (в представлении Монтгомери). */
+  ak_uint64 e[ak_mpzn512_size];
+ /*! \brief Параметр \f$ d \f$ кривой в искривленной форме Эдвардса (в представлении Монтгомери). */
+  ak_uint64 d[ak_mpzn512_size];
+ /*! \brief Величина \f$ s = (e-d)/4 \f$ (в представлении Монтгомери). */
+  ak_uint64 s[ak_mpzn512_size];
+ /*! \brief Величина \f$ t = (e+d)/6 \f$ (в представлении Монтгомери). */
+  ak_uint64 t[ak_mpzn512_size];
 };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -110,11 +194,21 @@
  int ak_wcurve_discriminant_is_ok( ak_wcurve );
 /*! \brief Проверка корректности параметров, необходимых для вычисления по модулю q. */
  int ak_wcurve_check_order_parameters( ak_wcurve );
+/*! \brief Умножение вычетов в представлении Монтгомери по модулю эллиптической кривой. */
+ void ak_wcurve_mul_montgomery( ak_uint64 *, ak_uint64 *, ak_uint64 *, ak_wcurve );
+/*! \brief Возведение в квадрат в представлении Монтгомери по модулю эллиптической кривой. */
+ void ak_wcurve_sqr_montgomery( ak_uint64 *, ak_uint64 *, ak_wcurve );
+/*! \brief Приведение вычета по модулю порядка подгруппы точек эллиптической кривой. */
+ void ak_mpzn_rem_q( ak_uint64 *, ak_uint64 *, ak_wcurve );
+/*! \brief Умножение вычетов по модулю порядка подгруппы точек эллиптической кривой. */
+ void ak_mpzn_mulmod_q( ak_uint64 *, ak_uint64 *, ak_uint64 *, ak_wcurve );
 /*! \brief Проверка набора параметров эллиптической кривой, заданной в форме Вейерштрасса. */
  int ak_wcurve_is_ok( ak_wcurve );
 /*! \brief Функция тестирует все определяемые библиотекой параметры эллиптических кривых,
     заданных в короткой форме Вейерштрасса. */
  bool_t ak_wcurve_test( void );
+/*! \brief Удаление таблиц кратных точек, вычисленных для образующих точек эллиптических кривых. */
+ void ak_wcurve_base_tables_destroy( void );
 
 #endif
 /* ----------------------------------------------------------------------------------------------- */
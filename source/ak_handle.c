@@ -679,6 +679,90 @@
   }
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция строит для заданного файла дерево хеш-кодов (см. \ref hash_tree) и возвращает
+    значение его корня. Хеш-коды фрагментов файла вычисляются параллельно. Функция может быть
+    использована только для бесключевых функций хеширования.
+
+    \param handle Дескриптор бесключевой функции хеширования.
+    \param filename Имя файла, для которого вычисляется контрольная сумма.
+    \param chunk Размер фрагмента файла в октетах; нулевое значение означает использование
+    размера фрагмента по-умолчанию.
+    \param threads Количество используемых потоков.
+    \param treefile Имя файла, в который сохраняется построенное дерево; если значение
+    равно NULL, то дерево не сохраняется.
+    \param out Область памяти, куда будет помещен корень дерева.
+    \param out_size Размер области памяти (в октетах).
+
+    \return В случае успеха функция возвращает ноль (\ref ak_error_ok). В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_handle_mac_file_tree( ak_handle handle, const char *filename, const size_t chunk,
+                const size_t threads, const char *treefile, ak_pointer out, const size_t out_size )
+{
+  ak_oid oid = NULL;
+  struct hash_tree tree;
+  int error = ak_error_ok;
+
+  if( ak_handle_get_context( handle, &oid, NULL ) == NULL )
+    return ak_error_message( ak_error_get_value(), __func__, "incorrect handle value" );
+  if(( oid->mode != algorithm ) || ( oid->engine != hash_function ))
+    return ak_error_message( ak_error_oid_engine, __func__, "using handle with wrong engine" );
+
+  if(( error = ak_hash_tree_context_create_file( &tree,
+                                               oid, filename, chunk, threads )) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect creation of hash tree" );
+  if(( error = ak_hash_tree_context_get_root( &tree, out, out_size )) == ak_error_ok )
+    if( treefile != NULL ) error = ak_hash_tree_context_export_to_file( &tree, treefile );
+  ak_hash_tree_context_destroy( &tree );
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция считывает сохраненное ранее дерево хеш-кодов, проверяет соответствие ему
+    заданного файла и возвращает значение корня дерева, которое должно сравниваться
+    с контрольной суммой файла. Если файл был искажен, то функция возвращает
+    \ref ak_error_not_equal_data, а в переменную `wrong` помещается количество
+    измененных фрагментов файла.
+
+    \param handle Дескриптор бесключевой функции хеширования.
+    \param filename Имя проверяемого файла.
+    \param treefile Имя файла, содержащего дерево хеш-кодов.
+    \param threads Количество используемых потоков.
+    \param out Область памяти, куда будет помещен корень дерева.
+    \param out_size Размер области памяти (в октетах).
+    \param wrong Указатель на переменную, в которую помещается количество искаженных
+    фрагментов (указатель может быть равен NULL).
+
+    \return В случае успеха функция возвращает ноль (\ref ak_error_ok). В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_handle_check_file_tree( ak_handle handle, const char *filename, const char *treefile,
+                         const size_t threads, ak_pointer out, const size_t out_size, size_t *wrong )
+{
+  ak_oid oid = NULL;
+  struct hash_tree tree;
+  int error = ak_error_ok;
+
+  if( ak_handle_get_context( handle, &oid, NULL ) == NULL )
+    return ak_error_message( ak_error_get_value(), __func__, "incorrect handle value" );
+  if(( oid->mode != algorithm ) || ( oid->engine != hash_function ))
+    return ak_error_message( ak_error_oid_engine, __func__, "using handle with wrong engine" );
+
+  if(( error = ak_hash_tree_context_import_from_file( &tree, treefile )) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect loading of hash tree" );
+  if( tree.oid != oid ) error = ak_error_message( ak_error_wrong_oid, __func__,
+                                              "hash tree was created by another hash function" );
+  if( error == ak_error_ok )
+    error = ak_hash_tree_context_get_root( &tree, out, out_size );
+  if( error == ak_error_ok )
+    error = ak_hash_tree_context_check_file( &tree, filename, 0, 0, threads, wrong );
+  ak_hash_tree_context_destroy( &tree );
+
+ return error;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция позволяет вычислить значение хэш-кода (контрольную сумму) для бесключевых функций
     хэширования или значение имитовставки - для ключевых функций хэширования.
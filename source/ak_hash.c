@@ -207,6 +207,170 @@
  return result;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                  Одновременная обработка нескольких независимых состояний                       */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Преобразование G, применяемое одновременно к нескольким независимым состояниям.
+    \details Вычисления для различных состояний чередуются на каждом шаге преобразования,
+    что позволяет процессору совмещать выполнение независимых цепочек обращений к таблицам.
+    \note Если указатель n[i] равен NULL, то для i-го состояния вычисляется \f$ g_0 \f$.           */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_hash_context_streebog_g_lanes( ak_streebog *ctx, ak_uint64 **n,
+                                                           const ak_uint64 **m, const size_t lanes )
+{
+   int idx = 0;
+   size_t ldx = 0;
+   ak_uint64 K[ak_hash_streebog_max_lanes][8], T[ak_hash_streebog_max_lanes][8],
+                                                                 B[ak_hash_streebog_max_lanes][8];
+   for( ldx = 0; ldx < lanes; ldx++ ) {
+      if( n[ldx] != NULL ) {
+        ak_hash_context_streebog_x( B[ldx], ctx[ldx]->h, n[ldx] );
+        ak_hash_context_streebog_lps( K[ldx], B[ldx] );
+      } else ak_hash_context_streebog_lps( K[ldx], ctx[ldx]->h );
+      memcpy( T[ldx], m[ldx], 64 );
+   }
+   for( idx = 0; idx < 12; idx++ ) {
+      for( ldx = 0; ldx < lanes; ldx++ ) {
+         ak_hash_context_streebog_x( B[ldx], T[ldx], K[ldx] );
+         ak_hash_context_streebog_lps( T[ldx], B[ldx] );
+      }
+      for( ldx = 0; ldx < lanes; ldx++ ) {
+         ak_hash_context_streebog_x( B[ldx], K[ldx], streebog_c[idx] );
+         ak_hash_context_streebog_lps( K[ldx], B[ldx] );
+      }
+   }
+   for( ldx = 0; ldx < lanes; ldx++ )
+      for ( idx = 0; idx < 8; idx++ ) ctx[ldx]->h[idx] ^= T[ldx][idx] ^ K[ldx][idx] ^ m[ldx][idx];
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Преобразование G для нескольких состояний с одинаковыми значениями h и n.
+    \details Поскольку ключи раундов зависят только от h и n, они вычисляются однократно
+    и используются для всех состояний.                                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_hash_context_streebog_g_lanes_shared( ak_streebog *ctx, ak_uint64 *n,
+                                                           const ak_uint64 **m, const size_t lanes )
+{
+   int idx = 0;
+   size_t ldx = 0;
+   ak_uint64 K[8], B[8], T[ak_hash_streebog_max_lanes][8];
+
+   ak_hash_context_streebog_x( B, ctx[0]->h, n );
+   ak_hash_context_streebog_lps( K, B );
+   for( ldx = 0; ldx < lanes; ldx++ ) memcpy( T[ldx], m[ldx], 64 );
+   for( idx = 0; idx < 12; idx++ ) {
+      for( ldx = 0; ldx < lanes; ldx++ ) {
+         ak_hash_context_streebog_x( B, T[ldx], K );
+         ak_hash_context_streebog_lps( T[ldx], B );
+      }
+      ak_hash_context_streebog_x( B, K, streebog_c[idx] );
+      ak_hash_context_streebog_lps( K, B );
+   }
+   for( ldx = 0; ldx < lanes; ldx++ )
+      for ( idx = 0; idx < 8; idx++ ) ctx[ldx]->h[idx] ^= T[ldx][idx] ^ K[idx] ^ m[ldx][idx];
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция обрабатывает по одному блоку данных длины 64 октета для каждого из `lanes`
+    независимых внутренних состояний функции хеширования Стрибог.
+
+    @param sctx Массив указателей на внутренние состояния (struct streebog).
+    @param in Массив указателей на блоки данных; длина каждого блока равна 64 октетам.
+    @param lanes Количество состояний, не более \ref ak_hash_streebog_max_lanes.
+
+    \note Если все состояния совпадают (например, обрабатываются первые блоки различных сообщений),
+    то ключи раундов преобразования G вычисляются однократно.
+
+    @return В случае успеха функция возвращает ноль (\ref ak_error_ok). В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_context_update_streebog_lanes( ak_pointer *sctx, const ak_pointer *in,
+                                                                              const size_t lanes )
+{
+  size_t ldx = 0;
+  bool_t shared = ( lanes > 1 );
+  ak_streebog cx[ak_hash_streebog_max_lanes];
+  ak_uint64 *n[ak_hash_streebog_max_lanes];
+
+  if(( sctx == NULL ) || ( in == NULL )) return ak_error_message( ak_error_null_pointer,
+                                    __func__, "using null pointer to internal streebog contexts" );
+  if( lanes > ak_hash_streebog_max_lanes ) return ak_error_message( ak_error_wrong_length,
+                                                   __func__, "using a huge number of contexts" );
+  for( ldx = 0; ldx < lanes; ldx++ ) {
+     n[ldx] = ( cx[ldx] = ( ak_streebog ) sctx[ldx] )->n;
+     if( shared && ldx ) shared = !memcmp( cx[ldx]->h, cx[0]->h, 64 ) &&
+                                                              !memcmp( cx[ldx]->n, cx[0]->n, 64 );
+  }
+
+  if( shared )
+    ak_hash_context_streebog_g_lanes_shared( cx, n[0], ( const ak_uint64 ** ) in, lanes );
+   else ak_hash_context_streebog_g_lanes( cx, n, ( const ak_uint64 ** ) in, lanes );
+  for( ldx = 0; ldx < lanes; ldx++ ) {
+     ak_hash_context_streebog_add( cx[ldx], 512 );
+     ak_hash_context_streebog_sadd( cx[ldx], ( const ak_uint64 * ) in[ldx] );
+  }
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция завершает вычисления для каждого из `lanes` независимых внутренних состояний
+    функции хеширования Стрибог. Как и в функции ak_hash_context_finalize_streebog(),
+    сами состояния не изменяются.
+
+    @param sctx Массив указателей на внутренние состояния (struct streebog).
+    @param in Массив указателей на последние (неполные) блоки данных; указатель может быть
+    равен NULL, в этом случае соответствующий блок считается пустым.
+    @param size Массив длин последних блоков; каждая длина должна быть меньше 64 октетов.
+    @param out Массив указателей на области памяти, в которые помещаются результаты.
+    @param out_size Размер каждой из областей памяти, в которые помещаются результаты.
+    @param lanes Количество состояний, не более \ref ak_hash_streebog_max_lanes.
+    @return В случае успеха функция возвращает ноль (\ref ak_error_ok). В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_context_finalize_streebog_lanes( ak_pointer *sctx, const ak_pointer *in,
+            const size_t *size, ak_pointer *out, const size_t out_size, const size_t lanes )
+{
+  size_t ldx = 0;
+  struct streebog sx[ak_hash_streebog_max_lanes];
+  ak_streebog cx[ak_hash_streebog_max_lanes];
+  ak_uint64 m[ak_hash_streebog_max_lanes][8], *n[ak_hash_streebog_max_lanes];
+  const ak_uint64 *ptr[ak_hash_streebog_max_lanes];
+
+  if(( sctx == NULL ) || ( in == NULL ) || ( size == NULL ) || ( out == NULL ))
+    return ak_error_message( ak_error_null_pointer, __func__, "using null pointer to arrays" );
+  if( lanes > ak_hash_streebog_max_lanes ) return ak_error_message( ak_error_wrong_length,
+                                                   __func__, "using a huge number of contexts" );
+  for( ldx = 0; ldx < lanes; ldx++ ) {
+     if( size[ldx] >= 64 ) return ak_error_message( ak_error_wrong_length, __func__,
+                                                                      "input length is too huge" );
+     memset( m[ldx], 0, 64 );
+     if( in[ldx] != NULL ) memcpy( m[ldx], in[ldx], ( ak_uint32 )size[ldx] );
+     (( ak_uint8 * )m[ldx])[size[ldx]] = 1; /* дополнение */
+     memcpy( sx+ldx, sctx[ldx], sizeof( struct streebog ));
+     n[ldx] = sx[ldx].n;
+     ptr[ldx] = m[ldx];
+     cx[ldx] = sx+ldx;
+  }
+
+  ak_hash_context_streebog_g_lanes( cx, n, ptr, lanes );
+  for( ldx = 0; ldx < lanes; ldx++ ) {
+     ak_hash_context_streebog_add( cx[ldx], size[ldx] << 3 );
+     ak_hash_context_streebog_sadd( cx[ldx], m[ldx] );
+     n[ldx] = NULL;
+     ptr[ldx] = sx[ldx].n;
+  }
+  ak_hash_context_streebog_g_lanes( cx, n, ptr, lanes );
+  for( ldx = 0; ldx < lanes; ldx++ ) ptr[ldx] = sx[ldx].sigma;
+  ak_hash_context_streebog_g_lanes( cx, n, ptr, lanes );
+
+  for( ldx = 0; ldx < lanes; ldx++ ) {
+     if( sx[ldx].hsize == 64 ) memcpy( out[ldx], sx[ldx].h, ak_min( 64, out_size ));
+       else memcpy( out[ldx], sx[ldx].h+4, ak_min( 32, out_size ));
+  }
+ return ak_error_ok;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*                               Реализация функция класса hash                                    */
 /* ----------------------------------------------------------------------------------------------- */
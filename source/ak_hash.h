@@ -83,6 +83,74 @@
 /*! \brief Хеширование заданного файла. */
  int ak_hash_context_file( ak_hash , const char*, ak_pointer , const size_t );
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Очистка внутреннего состояния функции хеширования Стрибог. */
+ int ak_hash_context_clean_streebog( ak_pointer );
+/*! \brief Обработка последовательности блоков, длина которой кратна 64 октетам. */
+ int ak_hash_context_update_streebog( ak_pointer , const ak_pointer , const size_t );
+/*! \brief Завершение вычислений для заданного внутреннего состояния функции хеширования Стрибог. */
+ int ak_hash_context_finalize_streebog( ak_pointer , const ak_pointer , const size_t ,
+                                                                       ak_pointer , const size_t );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Максимальное количество независимых состояний функции хеширования Стрибог,
+    обрабатываемых одновременно. */
+ #define ak_hash_streebog_max_lanes   (4)
+
+/*! \brief Одновременная обработка блоков данных для нескольких независимых состояний. */
+ int ak_hash_context_update_streebog_lanes( ak_pointer * , const ak_pointer * , const size_t );
+/*! \brief Одновременное завершение вычислений для нескольких независимых состояний. */
+ int ak_hash_context_finalize_streebog_lanes( ak_pointer * , const ak_pointer * ,
+                                      const size_t * , ak_pointer * , const size_t , const size_t );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Размер фрагмента файла, используемый по-умолчанию при построении дерева хеш-кодов. */
+ #define ak_hash_tree_default_chunk_size   (1048576)
+/*! \brief Максимально допустимый размер фрагмента файла при построении дерева хеш-кодов. */
+ #define ak_hash_tree_max_chunk_size       (1073741824)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Дерево хеш-кодов (дерево Меркла) для контроля целостности больших файлов. */
+/*! \details Файл разбивается на фрагменты фиксированной длины `chunk`; листьями дерева являются
+    хеш-коды \f$ H( 0x00 || M_i ) \f$ фрагментов \f$ M_i \f$, внутренние узлы вычисляются как
+    \f$ H( 0x01 || L || R ) \f$, где \f$ L, R \f$ хеш-коды дочерних узлов. Узел, не имеющий пары,
+    переносится на следующий уровень без изменений. Корень дерева является кодом целостности файла.
+
+    Узлы хранятся в массиве `nodes` последовательно по уровням: сначала листья, затем
+    узлы следующего уровня и т.д.; последним элементом массива является корень дерева.             */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct hash_tree {
+  /*! \brief OID используемой бесключевой функции хеширования. */
+   ak_oid oid;
+  /*! \brief Размер фрагмента файла (в октетах). */
+   ak_uint64 chunk;
+  /*! \brief Размер файла (в октетах). */
+   ak_uint64 fsize;
+  /*! \brief Количество листьев дерева. */
+   size_t leaves;
+  /*! \brief Общее количество узлов дерева. */
+   size_t count;
+  /*! \brief Длина хеш-кода (в октетах). */
+   size_t hsize;
+  /*! \brief Массив узлов дерева. */
+   ak_uint8 *nodes;
+ } *ak_hash_tree;
+
+/*! \brief Построение дерева хеш-кодов для заданного файла. */
+ int ak_hash_tree_context_create_file( ak_hash_tree , ak_oid , const char * ,
+                                                                    const size_t , const size_t );
+/*! \brief Уничтожение дерева хеш-кодов. */
+ int ak_hash_tree_context_destroy( ak_hash_tree );
+/*! \brief Получение значения корня дерева хеш-кодов. */
+ int ak_hash_tree_context_get_root( ak_hash_tree , ak_pointer , const size_t );
+/*! \brief Проверка заданного диапазона фрагментов файла с помощью дерева хеш-кодов. */
+ int ak_hash_tree_context_check_file( ak_hash_tree , const char * ,
+                                          const size_t , const size_t , const size_t , size_t * );
+/*! \brief Сохранение дерева хеш-кодов в файл. */
+ int ak_hash_tree_context_export_to_file( ak_hash_tree , const char * );
+/*! \brief Создание дерева хеш-кодов из файла, сформированного ранее. */
+ int ak_hash_tree_context_import_from_file( ak_hash_tree , const char * );
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Проверка корректной работы функции хеширования Стрибог-256 */
  bool_t ak_hash_test_streebog256( void );
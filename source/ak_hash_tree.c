@@ -0,0 +1,589 @@
+/* ----------------------------------------------------------------------------------------------- */
+/*  Copyright (c) 2019 by Axel Kenzo, axelkenzo@mail.ru                                            */
+/*                                                                                                 */
+/*  Файл ak_hash_tree.c                                                                            */
+/*  - содержит реализацию деревьев хеш-кодов, используемых для контроля целостности файлов         */
+/* ----------------------------------------------------------------------------------------------- */
+ #include <ak_hash.h>
+ #include <ak_tools.h>
+
+/* ----------------------------------------------------------------------------------------------- */
+#ifdef LIBAKRYPT_HAVE_STDLIB_H
+ #include <stdlib.h>
+#else
+ #error Library cannot be compiled without stdlib.h header
+#endif
+#ifdef LIBAKRYPT_HAVE_STRING_H
+ #include <string.h>
+#else
+ #error Library cannot be compiled without string.h header
+#endif
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #include <pthread.h>
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сигнатура файла, содержащего сохраненное дерево хеш-кодов. */
+ static const char *ak_hash_tree_magic = "akhtree1";
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Задание для потока, вычисляющего листья дерева хеш-кодов. */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct hash_tree_task {
+  /*! \brief Дерево, для которого вычисляются листья. */
+   ak_hash_tree tree;
+  /*! \brief Имя обрабатываемого файла. */
+   const char *filename;
+  /*! \brief Номер первого обрабатываемого фрагмента. */
+   size_t first;
+  /*! \brief Номер фрагмента, следующего за последним обрабатываемым. */
+   size_t last;
+  /*! \brief Массив, в который помещаются хеш-коды фрагментов (с номерами от first до last). */
+   ak_uint8 *out;
+  /*! \brief Код ошибки, возникшей при обработке фрагментов. */
+   int error;
+ } *ak_hash_tree_task;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет общее количество узлов дерева с заданным количеством листьев. */
+/* ----------------------------------------------------------------------------------------------- */
+ static size_t ak_hash_tree_context_count( size_t leaves )
+{
+  size_t count = leaves;
+  while( leaves > 1 ) {
+    leaves = ( leaves + 1 ) >> 1;
+    count += leaves;
+  }
+ return count;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет внутренние узлы дерева по известным значениям листьев.
+    \param hctx Контекст функции хеширования.
+    \param nodes Массив узлов дерева, в начале которого расположены листья.
+    \param leaves Количество листьев.
+    \param hsize Длина хеш-кода в октетах.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hash_tree_context_levels( ak_hash hctx, ak_uint8 *nodes,
+                                                          size_t leaves, const size_t hsize )
+{
+  size_t idx = 0;
+  int error = ak_error_ok;
+  ak_uint8 buffer[1 + 2*64], *in = nodes, *out = nodes + leaves*hsize;
+
+  buffer[0] = 0x01;
+  while( leaves > 1 ) {
+    for( idx = 0; idx + 1 < leaves; idx += 2 ) {
+       memcpy( buffer+1, in + idx*hsize, 2*hsize );
+       if(( error = ak_hash_context_ptr( hctx, buffer, 1 + 2*hsize, out, hsize )) != ak_error_ok )
+         return ak_error_message( error, __func__, "incorrect evaluation of tree node" );
+       out += hsize;
+    }
+    if( leaves&1 ) { /* узел без пары переносится на следующий уровень */
+      memcpy( out, in + ( leaves - 1 )*hsize, hsize );
+      out += hsize;
+    }
+    in += leaves*hsize;
+    leaves = ( leaves + 1 ) >> 1;
+  }
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет хеш-коды последовательных фрагментов файла.
+    \details Каждый вызов функции использует собственные контекст функции хеширования
+    и дескриптор файла, что позволяет одновременно выполнять ее в нескольких потоках.              */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_hash_tree_context_leaves_thread( void *ptr )
+{
+  struct hash ctx;
+  struct file fp;
+  size_t idx = 0, len = 0, done = 0;
+  ssize_t rb = 0;
+  ak_uint8 *buffer = NULL;
+  ak_hash_tree_task task = ( ak_hash_tree_task ) ptr;
+  ak_hash_tree tree = task->tree;
+
+  if( task->first >= task->last ) return NULL;
+  if(( task->error = ak_hash_context_create_oid( &ctx, tree->oid )) != ak_error_ok ) {
+    ak_error_message( task->error, __func__, "incorrect creation of hash function context" );
+    return NULL;
+  }
+  if(( task->error = ak_file_open_to_read( &fp, task->filename )) != ak_error_ok ) {
+    ak_error_message_fmt( task->error, __func__, "incorrect access to file %s", task->filename );
+    goto labexit;
+  }
+  if(( buffer = malloc( tree->chunk + 1 )) == NULL ) {
+    ak_error_message( task->error = ak_error_out_of_memory, __func__,
+                                                            "incorrect memory allocation" );
+    goto labclose;
+  }
+  if(( task->error = ak_file_seek( &fp, ( ak_int64 )( task->first*tree->chunk ))) != ak_error_ok )
+    goto labclose;
+
+ /* первый октет буффера отделяет листья от внутренних узлов дерева */
+  buffer[0] = 0x00;
+  for( idx = task->first; idx < task->last; idx++ ) {
+     len = ( size_t ) ak_min( tree->chunk, tree->fsize - idx*tree->chunk );
+     for( done = 0; done < len; done += ( size_t ) rb ) {
+        if(( rb = ak_file_read( &fp, buffer + 1 + done, len - done )) <= 0 ) {
+          ak_error_message_fmt( task->error = ak_error_read_data, __func__,
+                                               "unexpected end of file %s", task->filename );
+          goto labclose;
+        }
+     }
+     if(( task->error = ak_hash_context_ptr( &ctx, buffer, len + 1,
+                       task->out + ( idx - task->first )*tree->hsize, tree->hsize )) != ak_error_ok )
+       goto labclose;
+  }
+
+  labclose:
+   if( buffer != NULL ) free( buffer );
+   ak_file_close( &fp );
+  labexit:
+   ak_hash_context_destroy( &ctx );
+ return NULL;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет хеш-коды фрагментов файла с номерами от `first` до `last`,
+    распределяя фрагменты между `threads` потоками; каждый поток обрабатывает
+    последовательный участок файла.                                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hash_tree_context_leaves( ak_hash_tree tree, const char *filename,
+                          const size_t first, const size_t last, size_t threads, ak_uint8 *out )
+{
+  size_t idx = 0;
+  int error = ak_error_ok;
+  struct hash_tree_task single, *tasks = NULL;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_t *tid = NULL;
+  bool_t *started = NULL;
+#endif
+
+  if(( threads = ak_min( threads, last - first )) < 2 ) threads = 1;
+  if(( threads == 1 ) || (( tasks = malloc( threads*sizeof( struct hash_tree_task ))) == NULL )) {
+    threads = 1;
+    tasks = &single;
+  }
+  for( idx = 0; idx < threads; idx++ ) {
+     tasks[idx].tree = tree;
+     tasks[idx].filename = filename;
+     tasks[idx].first = first + (( last - first )*idx )/threads;
+     tasks[idx].last = first + (( last - first )*( idx + 1 ))/threads;
+     tasks[idx].out = out + ( tasks[idx].first - first )*tree->hsize;
+     tasks[idx].error = ak_error_ok;
+  }
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  if( threads > 1 ) {
+    tid = malloc( threads*sizeof( pthread_t ));
+    started = calloc( threads, sizeof( bool_t ));
+    if(( tid != NULL ) && ( started != NULL )) {
+      for( idx = 1; idx < threads; idx++ )
+         if( pthread_create( tid+idx, NULL, ak_hash_tree_context_leaves_thread, tasks+idx ) == 0 )
+           started[idx] = ak_true;
+    }
+   /* задания, для которых не удалось создать поток, выполняются в текущем потоке */
+    for( idx = 0; idx < threads; idx++ )
+       if(( started == NULL ) || !started[idx] ) ak_hash_tree_context_leaves_thread( tasks+idx );
+    for( idx = 1; idx < threads; idx++ )
+       if(( started != NULL ) && started[idx] ) pthread_join( tid[idx], NULL );
+    if( tid != NULL ) free( tid );
+    if( started != NULL ) free( started );
+  } else
+#endif
+  for( idx = 0; idx < threads; idx++ ) ak_hash_tree_context_leaves_thread( tasks+idx );
+
+  for( idx = 0; idx < threads; idx++ )
+     if( tasks[idx].error != ak_error_ok ) { error = tasks[idx].error; break; }
+  if( tasks != &single ) free( tasks );
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция инициализирует поля дерева, не выделяя память под его узлы.
+    \details Функция проверяет, что размер фрагмента отличен от нуля и не превосходит
+    \ref ak_hash_tree_max_chunk_size, а объем памяти, необходимой для хранения узлов дерева,
+    может быть представлен значением типа `size_t`.                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hash_tree_context_set_sizes( ak_hash_tree tree, ak_oid oid,
+                                                    const ak_uint64 chunk, const ak_uint64 fsize )
+{
+  struct hash ctx;
+  ak_uint64 leaves = 0;
+  int error = ak_error_ok;
+
+  memset( tree, 0, sizeof( struct hash_tree ));
+  if(( chunk == 0 ) || ( chunk > ak_hash_tree_max_chunk_size ))
+    return ak_error_message( ak_error_wrong_length, __func__, "using wrong length of chunk" );
+  if(( error = ak_hash_context_create_oid( &ctx, oid )) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect creation of hash function context" );
+  tree->hsize = ak_hash_context_get_tag_size( &ctx );
+  ak_hash_context_destroy( &ctx );
+
+ /* количество узлов не превосходит удвоенного количества листьев */
+  if(( leaves = fsize/chunk + ( fsize%chunk != 0 )) == 0 ) leaves = 1;
+  if(( tree->hsize == 0 ) || ( leaves > ((( size_t )-1 ) >> 1 )/tree->hsize ))
+    return ak_error_message( ak_error_wrong_length, __func__, "using very large hash tree" );
+
+  tree->oid = oid;
+  tree->chunk = chunk;
+  tree->fsize = fsize;
+  tree->leaves = ( size_t ) leaves;
+  tree->count = ak_hash_tree_context_count( tree->leaves );
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция инициализирует поля дерева и выделяет память под его узлы. */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hash_tree_context_alloc( ak_hash_tree tree, ak_oid oid,
+                                                    const ak_uint64 chunk, const ak_uint64 fsize )
+{
+  int error = ak_error_ok;
+
+  if(( error = ak_hash_tree_context_set_sizes( tree, oid, chunk, fsize )) != ak_error_ok )
+    return error;
+  if(( tree->nodes = malloc( tree->count*tree->hsize )) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция разбивает файл на фрагменты длины `chunk` октетов и строит для него дерево
+    хеш-кодов. Хеш-коды фрагментов (листья дерева) вычисляются `threads` потоками, каждый из которых
+    обрабатывает свой последовательный участок файла; внутренние узлы вычисляются
+    в текущем потоке. Результат не зависит от количества используемых потоков.
+
+    @param tree Контекст дерева хеш-кодов.
+    @param oid OID бесключевой функции хеширования.
+    @param filename Имя обрабатываемого файла.
+    @param chunk Размер фрагмента файла в октетах; если значение равно нулю, то используется
+    значение \ref ak_hash_tree_default_chunk_size.
+    @param threads Количество потоков; значения 0 и 1 означают обработку в текущем потоке.
+
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_tree_context_create_file( ak_hash_tree tree, ak_oid oid, const char *filename,
+                                                         const size_t chunk, const size_t threads )
+{
+  struct file fp;
+  struct hash ctx;
+  ak_uint64 fsize = 0;
+  int error = ak_error_ok;
+
+  if( tree == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                                "using null pointer to hash tree" );
+  if( oid == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                       "using null pointer to hash function OID" );
+  if( filename == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                                 "using null pointer to filename" );
+  if(( error = ak_file_open_to_read( &fp, filename )) != ak_error_ok )
+    return ak_error_message_fmt( error, __func__, "incorrect access to file %s", filename );
+  fsize = ( ak_uint64 ) fp.size;
+  ak_file_close( &fp );
+
+  if(( error = ak_hash_tree_context_alloc( tree, oid,
+              chunk ? chunk : ak_hash_tree_default_chunk_size, fsize )) != ak_error_ok ) {
+    ak_hash_tree_context_destroy( tree );
+    return ak_error_message( error, __func__, "incorrect creation of hash tree" );
+  }
+
+ /* вычисляем листья, а потом внутренние узлы */
+  if(( error = ak_hash_tree_context_leaves( tree, filename,
+                                         0, tree->leaves, threads, tree->nodes )) != ak_error_ok ) {
+    ak_hash_tree_context_destroy( tree );
+    return ak_error_message_fmt( error, __func__, "incorrect hashing of file %s", filename );
+  }
+  if(( error = ak_hash_context_create_oid( &ctx, oid )) == ak_error_ok ) {
+    error = ak_hash_tree_context_levels( &ctx, tree->nodes, tree->leaves, tree->hsize );
+    ak_hash_context_destroy( &ctx );
+  }
+  if( error != ak_error_ok ) {
+    ak_hash_tree_context_destroy( tree );
+    return ak_error_message( error, __func__, "incorrect evaluation of internal nodes" );
+  }
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param tree Контекст дерева хеш-кодов.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_tree_context_destroy( ak_hash_tree tree )
+{
+  if( tree == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                                "using null pointer to hash tree" );
+  if( tree->nodes != NULL ) free( tree->nodes );
+  memset( tree, 0, sizeof( struct hash_tree ));
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param tree Контекст дерева хеш-кодов.
+    @param out Область памяти, в которую помещается значение корня дерева.
+    @param out_size Размер области памяти; должен быть не меньше длины хеш-кода.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_tree_context_get_root( ak_hash_tree tree, ak_pointer out, const size_t out_size )
+{
+  if(( tree == NULL ) || ( tree->nodes == NULL )) return ak_error_message( ak_error_null_pointer,
+                                                      __func__, "using null pointer to hash tree" );
+  if( out == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                                   "using null pointer to output" );
+  if( out_size < tree->hsize ) return ak_error_message( ak_error_wrong_length, __func__,
+                                                              "using small size of output buffer" );
+  memcpy( out, tree->nodes + ( tree->count - 1 )*tree->hsize, tree->hsize );
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция заново вычисляет хеш-коды фрагментов файла с номерами
+    `first`, `first` + 1, ..., `first` + `count` - 1 и сравнивает их с листьями дерева.
+    Таким образом, при известном множестве измененных участков файла проверке подвергаются
+    только они, а при обнаружении искажений дерево позволяет указать поврежденные фрагменты.
+
+    @param tree Контекст дерева хеш-кодов.
+    @param filename Имя проверяемого файла.
+    @param first Номер первого проверяемого фрагмента (нумерация с нуля).
+    @param count Количество проверяемых фрагментов; нулевое значение означает проверку
+    всех фрагментов, начиная с `first`.
+    @param threads Количество потоков; значения 0 и 1 означают обработку в текущем потоке.
+    @param wrong Указатель на переменную, в которую помещается количество искаженных
+    фрагментов (указатель может быть равен NULL).
+
+    @return Функция возвращает \ref ak_error_ok, если все проверенные фрагменты совпадают
+    с листьями дерева, и \ref ak_error_not_equal_data, если обнаружены искажения или размер файла
+    изменился. В остальных случаях возвращается код ошибки.                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_tree_context_check_file( ak_hash_tree tree, const char *filename,
+                 const size_t first, const size_t count, const size_t threads, size_t *wrong )
+{
+  struct file fp;
+  ak_uint64 fsize = 0;
+  size_t idx = 0, last = 0, cnt = 0;
+  ak_uint8 *leaves = NULL;
+  int error = ak_error_ok;
+
+  if( wrong != NULL ) *wrong = 0;
+  if(( tree == NULL ) || ( tree->nodes == NULL )) return ak_error_message( ak_error_null_pointer,
+                                                      __func__, "using null pointer to hash tree" );
+  if( filename == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                                 "using null pointer to filename" );
+  if( first >= tree->leaves ) return ak_error_message( ak_error_wrong_index, __func__,
+                                                               "using wrong index of file chunk" );
+  if(( error = ak_file_open_to_read( &fp, filename )) != ak_error_ok )
+    return ak_error_message_fmt( error, __func__, "incorrect access to file %s", filename );
+  fsize = ( ak_uint64 ) fp.size;
+  ak_file_close( &fp );
+  if( fsize != tree->fsize ) {
+    if( wrong != NULL ) *wrong = tree->leaves;
+    return ak_error_message_fmt( ak_error_not_equal_data, __func__,
+                                                          "the size of file %s changed", filename );
+  }
+
+  if(( count == 0 ) || ( count > tree->leaves - first )) last = tree->leaves;
+    else last = first + count;
+  if(( leaves = malloc(( last - first )*tree->hsize )) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+  if(( error = ak_hash_tree_context_leaves( tree, filename,
+                                                first, last, threads, leaves )) != ak_error_ok ) {
+    ak_error_message_fmt( error, __func__, "incorrect hashing of file %s", filename );
+    goto labexit;
+  }
+  for( idx = first; idx < last; idx++ )
+     if( !ak_ptr_is_equal( leaves + ( idx - first )*tree->hsize,
+                                      tree->nodes + idx*tree->hsize, tree->hsize )) cnt++;
+  if( wrong != NULL ) *wrong = cnt;
+  if( cnt ) error = ak_error_not_equal_data;
+
+  labexit:
+   free( leaves );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Запись 64-х битного целого числа в буффер в порядке big-endian. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_hash_tree_context_put_uint64( ak_uint8 *buffer, ak_uint64 value )
+{
+  int idx = 0;
+  for( idx = 7; idx >= 0; idx-- ) { buffer[idx] = ( ak_uint8 )value; value >>= 8; }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Чтение 64-х битного целого числа, записанного в порядке big-endian. */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_uint64 ak_hash_tree_context_get_uint64( const ak_uint8 *buffer )
+{
+  int idx = 0;
+  ak_uint64 value = 0;
+  for( idx = 0; idx < 8; idx++ ) value = ( value << 8 )^buffer[idx];
+ return value;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Чтение из файла заданного количества октетов. */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_hash_tree_context_read( ak_file fp, ak_pointer buffer, const size_t size )
+{
+  ssize_t rb = 0;
+  size_t done = 0;
+
+  for( done = 0; done < size; done += ( size_t ) rb )
+     if(( rb = ak_file_read( fp, ( ak_uint8 * )buffer + done, size - done )) <= 0 ) return ak_false;
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Дерево сохраняется в двоичном формате: сигнатура (8 октетов), длина идентификатора
+    функции хеширования (1 октет), сам идентификатор (строка чисел, разделенных точками),
+    размер фрагмента и размер файла (по 8 октетов, big-endian), длина хеш-кода (1 октет),
+    после чего следуют все узлы дерева в порядке их хранения в массиве `nodes`.
+
+    @param tree Контекст дерева хеш-кодов.
+    @param filename Имя создаваемого файла.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_tree_context_export_to_file( ak_hash_tree tree, const char *filename )
+{
+  struct file fp;
+  size_t len = 0;
+  int error = ak_error_ok;
+  ak_uint8 header[8 + 1 + 255 + 8 + 8 + 1];
+
+  if(( tree == NULL ) || ( tree->nodes == NULL )) return ak_error_message( ak_error_null_pointer,
+                                                      __func__, "using null pointer to hash tree" );
+  if( filename == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                                 "using null pointer to filename" );
+  if(( len = strlen( tree->oid->id )) > 255 ) return ak_error_message( ak_error_oid_id,
+                                                       __func__, "using very long identifier" );
+  memcpy( header, ak_hash_tree_magic, 8 );
+  header[8] = ( ak_uint8 )len;
+  memcpy( header + 9, tree->oid->id, len );
+  ak_hash_tree_context_put_uint64( header + 9 + len, tree->chunk );
+  ak_hash_tree_context_put_uint64( header + 17 + len, tree->fsize );
+  header[25 + len] = ( ak_uint8 )tree->hsize;
+
+  if(( error = ak_file_create_to_write( &fp, filename )) != ak_error_ok )
+    return ak_error_message_fmt( error, __func__, "incorrect creation of file %s", filename );
+  if(( ak_file_write( &fp, header, 26 + len ) != ( ssize_t )( 26 + len )) ||
+     ( ak_file_write( &fp, tree->nodes,
+                        tree->count*tree->hsize ) != ( ssize_t )( tree->count*tree->hsize ))) {
+    error = ak_error_message_fmt( ak_error_write_data, __func__,
+                                                     "incorrect writing to file %s", filename );
+  }
+  ak_file_close( &fp );
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция считывает дерево, сохраненное функцией ak_hash_tree_context_export_to_file(),
+    и проверяет его целостность: внутренние узлы дерева вычисляются заново по значениям листьев
+    и сравниваются с сохраненными значениями.
+
+    @param tree Контекст дерева хеш-кодов.
+    @param filename Имя файла, содержащего дерево.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_tree_context_import_from_file( ak_hash_tree tree, const char *filename )
+{
+  ak_oid oid = NULL;
+  struct file fp;
+  struct hash ctx;
+  ak_uint8 *nodes = NULL, header[255 + 17];
+  char id[256];
+  size_t len = 0;
+  int error = ak_error_ok;
+
+  if( tree == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                                "using null pointer to hash tree" );
+  if( filename == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                                 "using null pointer to filename" );
+  memset( tree, 0, sizeof( struct hash_tree ));
+  if(( error = ak_file_open_to_read( &fp, filename )) != ak_error_ok )
+    return ak_error_message_fmt( error, __func__, "incorrect access to file %s", filename );
+
+ /* считываем заголовок */
+  if( !ak_hash_tree_context_read( &fp, header, 9 ) ||
+      memcmp( header, ak_hash_tree_magic, 8 )) {
+    error = ak_error_message_fmt( ak_error_read_data, __func__,
+                                            "file %s does not contain a hash tree", filename );
+    goto labexit;
+  }
+  memset( id, 0, sizeof( id ));
+  len = header[8];
+  if( !ak_hash_tree_context_read( &fp, id, len ) ||
+      !ak_hash_tree_context_read( &fp, header, 17 )) {
+    error = ak_error_message( ak_error_read_data, __func__, "unexpected end of file" );
+    goto labexit;
+  }
+  if((( oid = ak_oid_context_find_by_id( id )) == NULL ) || ( oid->engine != hash_function )) {
+    error = ak_error_message_fmt( ak_error_wrong_oid, __func__,
+                                                      "using unsupported hash function %s", id );
+    goto labexit;
+  }
+  if(( error = ak_hash_tree_context_set_sizes( tree, oid,
+         ak_hash_tree_context_get_uint64( header ),
+                                 ak_hash_tree_context_get_uint64( header + 8 ))) != ak_error_ok )
+    goto labexit;
+  if( header[16] != tree->hsize ) {
+    error = ak_error_message( ak_error_wrong_length, __func__, "using wrong length of hash code" );
+    goto labexit;
+  }
+ /* память выделяется только после сравнения объявленного размера дерева с размером файла */
+  if(( fp.size < 0 ) ||
+      (( ak_uint64 ) fp.size != 26 + ( ak_uint64 )len + ( ak_uint64 )tree->count*tree->hsize )) {
+    error = ak_error_message_fmt( ak_error_wrong_length, __func__,
+                                              "file %s has unexpected length", filename );
+    goto labexit;
+  }
+  if(( tree->nodes = malloc( tree->count*tree->hsize )) == NULL ) {
+    error = ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+    goto labexit;
+  }
+
+ /* считываем узлы и проверяем их согласованность */
+  if( !ak_hash_tree_context_read( &fp, tree->nodes, tree->count*tree->hsize )) {
+    error = ak_error_message( ak_error_read_data, __func__, "unexpected end of file" );
+    goto labexit;
+  }
+  if(( nodes = malloc( tree->count*tree->hsize )) == NULL ) {
+    error = ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+    goto labexit;
+  }
+  memcpy( nodes, tree->nodes, tree->leaves*tree->hsize );
+  if(( error = ak_hash_context_create_oid( &ctx, oid )) == ak_error_ok ) {
+    error = ak_hash_tree_context_levels( &ctx, nodes, tree->leaves, tree->hsize );
+    ak_hash_context_destroy( &ctx );
+  }
+  if(( error == ak_error_ok ) &&
+                       !ak_ptr_is_equal( nodes, tree->nodes, tree->count*tree->hsize ))
+    error = ak_error_message_fmt( ak_error_not_equal_data, __func__,
+                                                  "hash tree from file %s is corrupted", filename );
+  free( nodes );
+
+  labexit:
+   ak_file_close( &fp );
+   if( error != ak_error_ok ) ak_hash_tree_context_destroy( tree );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                                                                                 ak_hash_tree.c  */
+/* ----------------------------------------------------------------------------------------------- */
@@ -19,16 +19,21 @@
  #error Library cannot be compiled without string.h header
 #endif
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество 64-х октетных блоков, вырабатываемых генератором hashrnd за один вызов
+    функции ak_random_context_next_hashrnd(). */
+ #define ak_hashrnd_blocks_count   (16)
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Класс для хранения внутренних состояний генератора hashrnd. */
 /* ----------------------------------------------------------------------------------------------- */
  typedef struct hashrnd {
   /*! \brief Структура используемой бесключевой функции хеширования */
    struct hash hctx;
-  /*! \brief Текущее значение счетчика обработанных блоков */
-   ak_uint8 counter[64];
+  /*! \brief Текущее значение счетчика обработанных блоков (младшие слова располагаются первыми) */
+   ak_uint64 counter[8];
   /*! \brief Массив выработанных значений */
-   ak_uint8 buffer[64];
+   ak_uint8 buffer[64*ak_hashrnd_blocks_count];
   /*! \brief Текущее количество доступных для выдачи октетов */
    size_t len;
  } *ak_hashrnd;
@@ -36,15 +41,22 @@
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Функция вычисяет следующее внутреннее состояние генератора.
+    \details Функция вырабатывает \ref ak_hashrnd_blocks_count блоков, каждый из которых является
+    значением функции хеширования Стрибог512 от очередного значения счетчика.
+    Хеш-коды вычисляются одновременно для нескольких значений счетчика.
+
     \param rnd Контекст генератора.
     \return В случае успеха, функция возвращает \ref ak_error_ok. В противном случае
             возвращается код ошибки.                                                               */
 /* ----------------------------------------------------------------------------------------------- */
  static int ak_random_context_next_hashrnd( ak_random rnd )
 {
-  size_t idx = 0;
-  ak_uint8 carry = 0;
   ak_hashrnd hrnd = NULL;
+  size_t idx = 0, ldx = 0, lanes = 0, size[ak_hash_streebog_max_lanes];
+  struct streebog sx[ak_hash_streebog_max_lanes];
+  ak_uint64 block[ak_hash_streebog_max_lanes][8];
+  ak_pointer sctx[ak_hash_streebog_max_lanes], in[ak_hash_streebog_max_lanes],
+                                  empty[ak_hash_streebog_max_lanes], out[ak_hash_streebog_max_lanes];
 
   if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
                                                     "use a null pointer to a random generator" );
@@ -52,18 +64,37 @@
   hrnd = ( ak_hashrnd ) rnd->data.ctx;
   if( hrnd->len != 0 ) return ak_error_message( ak_error_wrong_length, __func__,
                                             "unexpected value of internal variable \"length\"" );
- /* увеличиваем счетчик */
-  hrnd->counter[0]++;
-  do {
-       carry = hrnd->counter[idx++] > 0 ? 0 : 1;
-       hrnd->counter[idx] += carry;
-  } while( carry );
-  hrnd->counter[63] = 0;
-
- /* вычисляем новое хеш-значение */
-  ak_hash_context_ptr( &hrnd->hctx, hrnd->counter, 64, hrnd->buffer, 64 );
+
+  for( idx = 0; idx < ak_hashrnd_blocks_count; idx += lanes ) {
+     lanes = ak_min( ak_hash_streebog_max_lanes, ak_hashrnd_blocks_count - idx );
+     for( ldx = 0; ldx < lanes; ldx++ ) {
+       /* увеличиваем счетчик, старший октет счетчика всегда равен нулю */
+        size_t i = 0;
+        while(( ++hrnd->counter[i] == 0 ) && ( ++i < 8 ));
+        hrnd->counter[7] &= 0x00FFFFFFFFFFFFFFLL;
+       #ifdef LIBAKRYPT_LITTLE_ENDIAN
+        memcpy( block[ldx], hrnd->counter, 64 );
+       #else
+        for( i = 0; i < 8; i++ ) block[ldx][i] = bswap_64( hrnd->counter[i] );
+       #endif
+        sx[ldx].hsize = 64;
+        ak_hash_context_clean_streebog( sx+ldx );
+        sctx[ldx] = sx+ldx;
+        in[ldx] = block[ldx];
+        empty[ldx] = NULL;
+        size[ldx] = 0;
+        out[ldx] = hrnd->buffer + 64*( idx + ldx );
+     }
+    /* вычисляем новые хеш-значения */
+     ak_hash_context_update_streebog_lanes( sctx, ( const ak_pointer * ) in, lanes );
+     ak_hash_context_finalize_streebog_lanes( sctx,
+                                            ( const ak_pointer * ) empty, size, out, 64, lanes );
+  }
+  memset( block, 0, sizeof( block ));
+  memset( sx, 0, sizeof( sx ));
+
  /* определяем доступный объем данных для считывания */
-  hrnd->len = 64;
+  hrnd->len = sizeof( hrnd->buffer );
  return ak_error_ok;
 }
 
@@ -77,6 +108,9 @@
  static int ak_random_context_randomize_hashrnd( ak_random rnd,
                                                        const ak_pointer ptr, const ssize_t size )
 {
+ #ifndef LIBAKRYPT_LITTLE_ENDIAN
+  size_t idx = 0;
+ #endif
   ak_hashrnd hrnd = NULL;
   if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
                                              "use a null pointer to a random generator context" );
@@ -87,12 +121,15 @@
  /* восстанавливаем начальное значение */
   hrnd = rnd->data.ctx;
   hrnd->len = 0;
-  memset( hrnd->counter, 0, 64 );
-  memset( hrnd->buffer, 0, 64 );
+  memset( hrnd->counter, 0, sizeof( hrnd->counter ));
+  memset( hrnd->buffer, 0, sizeof( hrnd->buffer ));
 
  /* теперь вырабатываем начальное заполнение */
   ak_hash_context_ptr( &hrnd->hctx, ptr, (size_t)size, hrnd->counter, 64 );
-  hrnd->counter[63] = 0;
+ #ifndef LIBAKRYPT_LITTLE_ENDIAN
+  for( idx = 0; idx < 8; idx++ ) hrnd->counter[idx] = bswap_64( hrnd->counter[idx] );
+ #endif
+  hrnd->counter[7] &= 0x00FFFFFFFFFFFFFFLL;
 
  /* вычисляем псевдо-случайные данные */
   return rnd->next( rnd );
@@ -121,9 +158,10 @@
   hrnd = ( ak_hashrnd )rnd->data.ctx;
   while( realsize > 0 ) {
     size_t offset = ak_min( (size_t)realsize, hrnd->len );
-    if( offset > 64 ) return ak_error_message( ak_error_undefined_value , __func__ ,
-                                                    "incorrect value of internal buffer offset" );
-    memcpy( inptr, hrnd->buffer + (64 - hrnd->len), offset );
+    if( offset > sizeof( hrnd->buffer )) return ak_error_message( ak_error_undefined_value,
+                                          __func__ , "incorrect value of internal buffer offset" );
+    memcpy( inptr, hrnd->buffer + ( sizeof( hrnd->buffer ) - hrnd->len ), offset );
+    memset( hrnd->buffer + ( sizeof( hrnd->buffer ) - hrnd->len ), 0, offset );
     inptr += offset;
     realsize -= offset;
    /* вычисляем следующий массив данных */
@@ -18,6 +18,9 @@
 #else
  #error Library cannot be compiled without string.h header
 #endif
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Очистка контекста алгоритма hmac.
@@ -506,11 +509,238 @@
  return hctx->mctx.bsize;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                 быстрая реализация алгоритма PBKDF2 на основе hmac-streebog512                  */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Предвычисленное состояние алгоритма hmac-streebog512, используемое алгоритмом PBKDF2.
+    \details Поля ipad и opad содержат внутренние состояния функции хеширования Стрибог512
+    после сжатия блоков \f$ K \oplus ipad \f$ и \f$ K \oplus opad \f$ соответственно. Это
+    позволяет вычислять очередную итерацию алгоритма PBKDF2 без обращения к значению ключа
+    и без повторного сжатия этих блоков.                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct pbkdf2_streebog512 {
+  /*! \brief Состояние функции хеширования после сжатия блока K xor ipad. */
+   struct streebog ipad;
+  /*! \brief Состояние функции хеширования после сжатия блока K xor opad. */
+   struct streebog opad;
+ } *ak_pbkdf2_streebog512;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Формирование предвычисленного состояния алгоритма hmac-streebog512.
+    \param st Контекст предвычисленного состояния.
+    \param pass Пароль, используемый в качестве ключа алгоритма hmac-streebog512.
+    \param pass_size Длина пароля в октетах; пароли, длина которых превышает 64 октета,
+    заменяются своим хеш-кодом (в соответствии с RFC 2104).                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_hmac_pbkdf2_streebog512_init( ak_pbkdf2_streebog512 st,
+                                                      const ak_pointer pass, const size_t pass_size )
+{
+  size_t idx = 0, quot = pass_size >> 6;
+  ak_uint64 key[8], block[8];
+  ak_uint8 *kptr = ( ak_uint8 * )key, *bptr = ( ak_uint8 * )block;
+
+  memset( key, 0, sizeof( key ));
+  st->ipad.hsize = st->opad.hsize = 64;
+  if( pass_size > 64 ) {
+    ak_hash_context_clean_streebog( &st->ipad );
+    ak_hash_context_update_streebog( &st->ipad, pass, quot << 6 );
+    ak_hash_context_finalize_streebog( &st->ipad,
+                       ( ak_uint8 *)pass + ( quot << 6 ), pass_size - ( quot << 6 ), key, 64 );
+  } else memcpy( key, pass, pass_size );
+
+  for( idx = 0; idx < 64; idx++ ) bptr[idx] = kptr[idx]^0x36;
+  ak_hash_context_clean_streebog( &st->ipad );
+  ak_hash_context_update_streebog( &st->ipad, block, 64 );
+
+  for( idx = 0; idx < 64; idx++ ) bptr[idx] = kptr[idx]^0x5C;
+  ak_hash_context_clean_streebog( &st->opad );
+  ak_hash_context_update_streebog( &st->opad, block, 64 );
+
+  memset( key, 0, sizeof( key ));
+  memset( block, 0, sizeof( block ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление значения hmac-streebog512 для блока данных длины 64 октета.
+    \details Функция выполняет четыре сжатия для внутреннего и четыре сжатия для внешнего
+    вызова функции хеширования. Входные и выходные данные могут совпадать. Промежуточные
+    значения помещаются в переданные функции `sx` и `inner`, очистка которых выполняется
+    вызывающей функцией.                                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_hmac_pbkdf2_streebog512_iteration( ak_pbkdf2_streebog512 st,
+                     ak_uint64 *in, ak_uint64 *out, struct streebog *sx, ak_uint64 *inner )
+{
+  memcpy( sx, &st->ipad, sizeof( struct streebog ));
+  ak_hash_context_update_streebog( sx, in, 64 );
+  ak_hash_context_finalize_streebog( sx, NULL, 0, inner, 64 );
+
+  memcpy( sx, &st->opad, sizeof( struct streebog ));
+  ak_hash_context_update_streebog( sx, inner, 64 );
+  ak_hash_context_finalize_streebog( sx, NULL, 0, out, 64 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление первого значения \f$ U_1 = HMAC( P, S || INT( index )) \f$ алгоритма PBKDF2.
+    \param st Контекст предвычисленного состояния.
+    \param salt Инициализационный вектор.
+    \param salt_size Длина инициализационного вектора в октетах.
+    \param index Номер вырабатываемого блока (нумерация начинается с единицы).
+    \param u Массив, в который помещается результат.                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_hmac_pbkdf2_streebog512_first( ak_pbkdf2_streebog512 st,
+               const ak_uint8 *salt, const size_t salt_size, const ak_uint32 index, ak_uint64 *u )
+{
+  struct streebog sx;
+  size_t quot = salt_size >> 6, tail = salt_size - ( quot << 6 );
+  ak_uint64 buffer[16];
+  ak_uint8 *bptr = ( ak_uint8 * )buffer;
+
+  memcpy( &sx, &st->ipad, sizeof( struct streebog ));
+  if( quot ) ak_hash_context_update_streebog( &sx, ( ak_pointer )salt, quot << 6 );
+  if( tail ) memcpy( bptr, salt + ( quot << 6 ), tail );
+  bptr[tail++] = ( ak_uint8 )( index >> 24 );
+  bptr[tail++] = ( ak_uint8 )( index >> 16 );
+  bptr[tail++] = ( ak_uint8 )( index >> 8 );
+  bptr[tail++] = ( ak_uint8 )( index );
+  if( tail >= 64 ) {
+    ak_hash_context_update_streebog( &sx, buffer, 64 );
+    ak_hash_context_finalize_streebog( &sx, bptr + 64, tail - 64, u, 64 );
+  } else ak_hash_context_finalize_streebog( &sx, bptr, tail, u, 64 );
+
+  memcpy( &sx, &st->opad, sizeof( struct streebog ));
+  ak_hash_context_update_streebog( &sx, u, 64 );
+  ak_hash_context_finalize_streebog( &sx, NULL, 0, u, 64 );
+  memset( buffer, 0, sizeof( buffer ));
+  memset( &sx, 0, sizeof( struct streebog ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Смещение, начиная с которого октеты блока \f$ T_i \f$ копируются в ключевой вектор.
+    \details Для ключевых векторов длины не более 64-х октетов используются старшие `len`
+    октетов блока \f$ T_1 \f$ (в соответствии с Р 50.1.111-2016), для более длинных векторов
+    от последнего блока берутся младшие (первые) октеты.                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ #define ak_hmac_pbkdf2_streebog512_offset( dklen, len ) ( (dklen) > 64 ? 0 : 64 - (len) )
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Выработка одного блока \f$ T_i \f$ алгоритма PBKDF2.
+    \param st Контекст предвычисленного состояния.
+    \param salt Инициализационный вектор.
+    \param salt_size Длина инициализационного вектора в октетах.
+    \param cnt Количество итераций.
+    \param index Номер вырабатываемого блока (нумерация начинается с единицы).
+    \param out Область памяти, в которую помещаются `out_size` октетов блока.
+    \param out_size Количество копируемых октетов, не превосходит 64.
+    \param dklen Длина вырабатываемого ключевого вектора; определяет, какие октеты блока
+    копируются в `out`.                                                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_hmac_pbkdf2_streebog512_block( ak_pbkdf2_streebog512 st,
+                    const ak_uint8 *salt, const size_t salt_size, const size_t cnt,
+          const ak_uint32 index, ak_uint8 *out, const size_t out_size, const size_t dklen )
+{
+  size_t idx = 0, jdx = 0;
+  ak_uint64 u[8], t[8], inner[8];
+  struct streebog sx;
+
+ /* вычисляем U_1 = hmac( P, S || INT( index )) */
+  ak_hmac_pbkdf2_streebog512_first( st, salt, salt_size, index, u );
+  memcpy( t, u, 64 );
+
+ /* основной цикл: U_j = hmac( P, U_{j-1} ), T = U_1 xor ... xor U_c */
+  for( idx = 1; idx < cnt; idx++ ) {
+     ak_hmac_pbkdf2_streebog512_iteration( st, u, u, &sx, inner );
+     for( jdx = 0; jdx < 8; jdx++ ) t[jdx] ^= u[jdx];
+  }
+  memcpy( out, ( ak_uint8 * )t + ak_hmac_pbkdf2_streebog512_offset( dklen, out_size ), out_size );
+
+  memset( u, 0, sizeof( u ));
+  memset( t, 0, sizeof( t ));
+  memset( inner, 0, sizeof( inner ));
+  memset( &sx, 0, sizeof( struct streebog ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Проверка параметров алгоритма PBKDF2.
+    \return Функция возвращает \ref ak_error_ok, если параметры допустимы.
+    В противном случае возвращается код ошибки.                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hmac_pbkdf2_streebog512_check( const ak_pointer pass, const size_t pass_size,
+                                  const ak_pointer salt, const size_t dklen, const ak_pointer out )
+{
+  if( pass == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                 "using null pointer to password" );
+  if( !pass_size ) return ak_error_message( ak_error_wrong_length, __func__ ,
+                                                                   "using a zero length password" );
+  if( salt == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                     "using null pointer to salt" );
+  if( dklen < 32 ) return ak_error_message( ak_error_wrong_length,
+                                       __func__ , "using a wrong length for resulting key vector" );
+  if((( dklen + 63 ) >> 6 ) > 0xFFFFFFFF ) return ak_error_message( ak_error_wrong_length,
+                                       __func__ , "using a huge length for resulting key vector" );
+  if( out == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "using null pointer to resulting key vector" );
+ return ak_error_ok;
+}
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Максимальное количество потоков, вырабатывающих блоки алгоритма PBKDF2. */
+ #define ak_hmac_pbkdf2_max_threads  (8)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Задание для потока, вырабатывающего часть блоков алгоритма PBKDF2. */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct pbkdf2_streebog512_task {
+  /*! \brief Предвычисленное состояние (общее для всех потоков). */
+   ak_pbkdf2_streebog512 st;
+  /*! \brief Инициализационный вектор. */
+   const ak_uint8 *salt;
+  /*! \brief Длина инициализационного вектора. */
+   size_t salt_size;
+  /*! \brief Количество итераций. */
+   size_t cnt;
+  /*! \brief Номер первого обрабатываемого потоком блока (нумерация с нуля). */
+   size_t first;
+  /*! \brief Шаг, с которым поток перебирает номера блоков. */
+   size_t step;
+  /*! \brief Длина вырабатываемого ключевого вектора. */
+   size_t dklen;
+  /*! \brief Указатель на вырабатываемый ключевой вектор. */
+   ak_uint8 *out;
+ } *ak_pbkdf2_streebog512_task;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция потока, вырабатывающего блоки с номерами first, first + step, ... */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_hmac_pbkdf2_streebog512_thread( void *ptr )
+{
+  size_t idx = 0;
+  ak_pbkdf2_streebog512_task task = ( ak_pbkdf2_streebog512_task ) ptr;
+
+  for( idx = task->first; ( idx << 6 ) < task->dklen; idx += task->step )
+     ak_hmac_pbkdf2_streebog512_block( task->st, task->salt, task->salt_size, task->cnt,
+               ( ak_uint32 )( idx + 1 ), task->out + ( idx << 6 ),
+                                      ak_min( 64, task->dklen - ( idx << 6 )), task->dklen );
+ return NULL;
+}
+#endif
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Пароль должен представлять собой ненулевую строку символов в utf8
-    кодировке. Размер вырабатываемого ключевого вектора может колебаться от 32-х до 64-х байт.
+    кодировке. Размер вырабатываемого ключевого вектора должен быть не менее 32-х байт.
     При выработке используется алгоритм hmac-streebog512.
 
+    Если длина ключевого вектора не превосходит 64-х октетов, то результатом являются
+    старшие `dklen` октетов блока \f$ T_1 \f$ (в соответствии с Р 50.1.111-2016).
+    В противном случае результат образуется конкатенацией блоков
+    \f$ T_1 || T_2 || \ldots || T_l \f$, при этом от последнего блока берутся первые
+    (младшие) октеты в количестве, необходимом для получения заданной длины.
+
+    Значения функции hmac-streebog512 для блоков \f$ K \oplus ipad \f$ и \f$ K \oplus opad \f$
+    вычисляются один раз, после чего каждая итерация сводится к восьми вызовам
+    сжимающего отображения функции хеширования Стрибог512. При сборке библиотеки с поддержкой
+    потоков блоки \f$ T_i \f$ вырабатываются параллельно.
+
     @param pass Пароль, строка символов в utf8 кодировке.
     @param pass_size Размер пароля в байтах, должен быть отличен от нуля.
     @param salt Строка с инициализационным вектором (произвольная область памяти). Данное значение
@@ -519,8 +749,8 @@
     @param cnt Параметр, определяющий количество однотипных итераций для выработки ключа; данный
     параметр определяет время работы алгоритма; параметр не является секретным и может храниться или
     передаваться в открытом виде.
-    @param dklen Длина вырабатываемого ключевого вектора в байтах, величина должна принимать
-    значение от 32-х до 64-х.
+    @param dklen Длина вырабатываемого ключевого вектора в байтах, величина должна быть
+    не менее 32-х.
     @param out Указатель на массив, куда будет помещен результат; под данный массив должна быть
     заранее выделена память не менее, чем dklen байт.
 
@@ -531,58 +761,284 @@
          const size_t pass_size, const ak_pointer salt, const size_t salt_size, const size_t cnt,
                                                                const size_t dklen, ak_pointer out )
 {
-  struct hmac hctx;
-  ak_uint8 result[64];
   int error = ak_error_ok;
-  size_t idx = 0, jdx = 0;
+  size_t blocks = ( dklen + 63 ) >> 6;
+  struct pbkdf2_streebog512 st;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  size_t idx = 0, threads = 0;
+  pthread_t tid[ak_hmac_pbkdf2_max_threads];
+  struct pbkdf2_streebog512_task tasks[ak_hmac_pbkdf2_max_threads];
+  bool_t started[ak_hmac_pbkdf2_max_threads];
+#endif
 
  /* в начале, многочисленные проверки входных параметров */
-  if( pass == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
-                                                                 "using null pointer to password" );
-  if( !pass_size ) return ak_error_message( ak_error_wrong_length, __func__ ,
-                                                                   "using a zero length password" );
-  if( salt == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
-                                                                     "using null pointer to salt" );
-  if(( dklen < 32 ) || ( dklen > 64 )) return ak_error_message( ak_error_wrong_length,
-                                       __func__ , "using a wrong length for resulting key vector" );
-  if( out == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
-                                                     "using null pointer to resulting key vector" );
- /* создаем контекст алгоритма hmac и определяем его ключ */
-  if(( error = ak_hmac_context_create_streebog512( &hctx )) != ak_error_ok )
-    return ak_error_message( error, __func__, "wrong creation of hmac-streebog512 key context" );
-  if(( error = ak_hmac_context_set_key( &hctx, pass, pass_size )) != ak_error_ok ) {
-    ak_error_message( error, __func__, "wrong initialization of hmac-streebog512 secret key" );
-    goto lab_exit;
+  if(( error = ak_hmac_pbkdf2_streebog512_check( pass, pass_size,
+                                                  salt, dklen, out )) != ak_error_ok )
+    return ak_error_message( error, __func__, "using wrong parameters of pbkdf2 algorithm" );
+
+ /* вычисляем состояния, соответствующие блокам K xor ipad и K xor opad */
+  ak_hmac_pbkdf2_streebog512_init( &st, pass, pass_size );
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  if(( threads = ak_min( blocks, ak_hmac_pbkdf2_max_threads )) > 1 ) {
+    for( idx = 0; idx < threads; idx++ ) {
+       tasks[idx].st = &st;
+       tasks[idx].salt = salt;
+       tasks[idx].salt_size = salt_size;
+       tasks[idx].cnt = cnt;
+       tasks[idx].first = idx;
+       tasks[idx].step = threads;
+       tasks[idx].dklen = dklen;
+       tasks[idx].out = out;
+       started[idx] = ak_false;
+    }
+   /* нулевое задание выполняется в текущем потоке; если поток создать не удалось,
+      соответствующее задание также выполняется в текущем потоке */
+    for( idx = 1; idx < threads; idx++ )
+       if( pthread_create( tid+idx, NULL, ak_hmac_pbkdf2_streebog512_thread, tasks+idx ) == 0 )
+         started[idx] = ak_true;
+    for( idx = 0; idx < threads; idx++ )
+       if( !started[idx] ) ak_hmac_pbkdf2_streebog512_thread( tasks+idx );
+    for( idx = 1; idx < threads; idx++ )
+       if( started[idx] ) pthread_join( tid[idx], NULL );
+  } else
+#endif
+  {
+    size_t jdx = 0;
+    for( jdx = 0; jdx < blocks; jdx++ )
+       ak_hmac_pbkdf2_streebog512_block( &st, salt, salt_size, cnt, ( ak_uint32 )( jdx + 1 ),
+               ( ak_uint8 * )out + ( jdx << 6 ), ak_min( 64, dklen - ( jdx << 6 )), dklen );
   }
 
- /* начальная инициализация промежуточного вектора */
-  memset( result, 0, 64 );
-  result[3] = 1;
+  memset( &st, 0, sizeof( struct pbkdf2_streebog512 ));
+ return ak_error_ok;
+}
 
- /* вычисляем значение первой строки U1  */
-  if(( error = ak_hmac_context_clean( &hctx )) != ak_error_ok ) {
-    ak_error_message( error, __func__, "incorrect cleaning of internal hmac context");
-    goto lab_exit;
+/* ----------------------------------------------------------------------------------------------- */
+/*               пакетная выработка ключевых векторов для набора паролей                           */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Состояние одной дорожки, вырабатывающей блок \f$ T_i \f$ для элемента пакета. */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct pbkdf2_streebog512_lane {
+  /*! \brief Обрабатываемый элемент пакета. */
+   ak_pbkdf2_item item;
+  /*! \brief Предвычисленное состояние для пароля элемента. */
+   struct pbkdf2_streebog512 st;
+  /*! \brief Номер вырабатываемого блока (нумерация начинается с единицы). */
+   ak_uint32 index;
+  /*! \brief Количество оставшихся итераций. */
+   size_t rest;
+  /*! \brief Текущее значение \f$ U_j \f$. */
+   ak_uint64 u[8];
+  /*! \brief Накопленное значение \f$ T_i \f$. */
+   ak_uint64 t[8];
+ } *ak_pbkdf2_streebog512_lane;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Общая очередь заданий пакетной выработки ключевых векторов.
+    \details Заданием является пара (элемент пакета, номер блока); задания раздаются
+    потокам последовательно, начиная с первого блока первого элемента.                             */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct pbkdf2_streebog512_queue {
+  /*! \brief Массив элементов пакета. */
+   ak_pbkdf2_item items;
+  /*! \brief Количество элементов пакета. */
+   size_t count;
+  /*! \brief Номер элемента, содержащего следующее задание. */
+   size_t item;
+  /*! \brief Номер следующего блока (нумерация с нуля). */
+   size_t block;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  /*! \brief Мьютекс, защищающий очередь при многопоточной обработке. */
+   pthread_mutex_t mutex;
+#endif
+ } *ak_pbkdf2_streebog512_queue;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Выбор следующего задания из очереди и инициализация дорожки.
+    \return Функция возвращает ak_true, если задание получено, и ak_false, если очередь пуста.  */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_hmac_pbkdf2_streebog512_queue_next( ak_pbkdf2_streebog512_queue queue,
+                                                                   ak_pbkdf2_streebog512_lane lane )
+{
+  ak_pbkdf2_item item = NULL;
+  size_t block = 0;
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_lock( &queue->mutex );
+#endif
+  while( queue->item < queue->count ) {
+    item = queue->items + queue->item;
+    if(( item->result == ak_error_ok ) && (( queue->block << 6 ) < item->dklen )) {
+      block = queue->block++;
+      break;
+    }
+    queue->item++;
+    queue->block = 0;
+    item = NULL;
   }
-  if(( error = ak_hmac_context_update( &hctx, salt, salt_size )) != ak_error_ok ) {
-    ak_error_message( error, __func__, "incorrect updating of internal hmac context");
-    goto lab_exit;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_unlock( &queue->mutex );
+#endif
+  if( item == NULL ) return ak_false;
+
+  lane->item = item;
+  lane->index = ( ak_uint32 )( block + 1 );
+  lane->rest = item->cnt > 1 ? item->cnt - 1 : 0;
+  ak_hmac_pbkdf2_streebog512_init( &lane->st, item->pass, item->pass_size );
+  ak_hmac_pbkdf2_streebog512_first( &lane->st, item->salt, item->salt_size, lane->index, lane->u );
+  memcpy( lane->t, lane->u, 64 );
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Копирование выработанного блока в ключевой вектор элемента и очистка дорожки. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_hmac_pbkdf2_streebog512_lane_done( ak_pbkdf2_streebog512_lane lane )
+{
+  size_t offset = ( size_t )( lane->index - 1 ) << 6,
+         len = ak_min( 64, lane->item->dklen - offset );
+
+  memcpy(( ak_uint8 * )lane->item->out + offset, ( ak_uint8 * )lane->t +
+                                ak_hmac_pbkdf2_streebog512_offset( lane->item->dklen, len ), len );
+  memset( lane, 0, sizeof( struct pbkdf2_streebog512_lane ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция потока, обрабатывающего задания из общей очереди.
+    \details Поток одновременно ведет до \ref ak_hash_streebog_max_lanes дорожек; очередная
+    итерация алгоритма PBKDF2 выполняется для всех дорожек сразу, что позволяет чередовать
+    сжатия независимых состояний функции хеширования Стрибог512. Завершившаяся дорожка
+    немедленно получает новое задание.                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_hmac_pbkdf2_streebog512_batch_thread( void *ptr )
+{
+  size_t ldx = 0, jdx = 0, active = 0, sizes[ak_hash_streebog_max_lanes];
+  ak_pbkdf2_streebog512_queue queue = ( ak_pbkdf2_streebog512_queue ) ptr;
+  struct pbkdf2_streebog512_lane lanes[ak_hash_streebog_max_lanes];
+  struct streebog sx[ak_hash_streebog_max_lanes];
+  ak_uint64 inner[ak_hash_streebog_max_lanes][8];
+  ak_pointer px[ak_hash_streebog_max_lanes], pin[ak_hash_streebog_max_lanes],
+             pout[ak_hash_streebog_max_lanes], pnull[ak_hash_streebog_max_lanes];
+
+  memset( sizes, 0, sizeof( sizes ));
+  for( ldx = 0; ldx < ak_hash_streebog_max_lanes; ldx++ ) {
+     px[ldx] = sx+ldx;
+     pnull[ldx] = NULL;
   }
-  if(( error = ak_hmac_context_finalize( &hctx, result, 4,
-                                                      result, sizeof( result ))) != ak_error_ok ) {
-    ak_error_message( error, __func__, "incorrect finalizing of internal mac context");
-    goto lab_exit;
+
+  do{
+    /* заполняем свободные дорожки */
+     while( active < ak_hash_streebog_max_lanes ) {
+       if( !ak_hmac_pbkdf2_streebog512_queue_next( queue, lanes+active )) break;
+       if( lanes[active].rest == 0 ) ak_hmac_pbkdf2_streebog512_lane_done( lanes+active );
+         else active++;
+     }
+     if( !active ) break;
+
+    /* выполняем одну итерацию U_j = hmac( P, U_{j-1} ) для всех дорожек */
+     for( ldx = 0; ldx < active; ldx++ ) {
+        memcpy( sx+ldx, &lanes[ldx].st.ipad, sizeof( struct streebog ));
+        pin[ldx] = lanes[ldx].u;
+        pout[ldx] = inner[ldx];
+     }
+     ak_hash_context_update_streebog_lanes( px, pin, active );
+     ak_hash_context_finalize_streebog_lanes( px, pnull, sizes, pout, 64, active );
+
+     for( ldx = 0; ldx < active; ldx++ ) {
+        memcpy( sx+ldx, &lanes[ldx].st.opad, sizeof( struct streebog ));
+        pin[ldx] = inner[ldx];
+        pout[ldx] = lanes[ldx].u;
+     }
+     ak_hash_context_update_streebog_lanes( px, pin, active );
+     ak_hash_context_finalize_streebog_lanes( px, pnull, sizes, pout, 64, active );
+
+    /* накапливаем результат */
+     for( ldx = 0; ldx < active; ldx++ ) {
+        for( jdx = 0; jdx < 8; jdx++ ) lanes[ldx].t[jdx] ^= lanes[ldx].u[jdx];
+        lanes[ldx].rest--;
+     }
+
+    /* освобождаем завершившиеся дорожки, перемещая на их место последние активные */
+     for( ldx = 0; ldx < active; ) {
+        if( lanes[ldx].rest ) { ldx++; continue; }
+        ak_hmac_pbkdf2_streebog512_lane_done( lanes+ldx );
+        if( ldx != --active )
+          memcpy( lanes+ldx, lanes+active, sizeof( struct pbkdf2_streebog512_lane ));
+     }
+  } while( ak_true );
+
+  memset( sx, 0, sizeof( sx ));
+  memset( inner, 0, sizeof( inner ));
+  memset( lanes, 0, sizeof( lanes ));
+ return NULL;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вырабатывает ключевые векторы для каждого элемента массива `items` так же, как это
+    делает функция ak_hmac_context_pbkdf2_streebog512(). Параметры элементов (пароль,
+    инициализационный вектор, количество итераций и длина ключевого вектора) могут различаться.
+
+    Все блоки \f$ T_i \f$ всех элементов образуют общую очередь заданий. Каждый поток одновременно
+    вырабатывает до \ref ak_hash_streebog_max_lanes блоков, чередуя сжатия независимых состояний
+    функции хеширования; при сборке библиотеки с поддержкой потоков очередь обрабатывается
+    `threads` потоками.
+
+    Результат обработки каждого элемента помещается в поле `result` этого элемента; элементы
+    с некорректными параметрами пропускаются и не влияют на обработку остальных элементов.
+
+    @param items Массив элементов пакета.
+    @param count Количество элементов пакета.
+    @param threads Количество потоков; значения 0 и 1 означают обработку в текущем потоке.
+
+    @return Функция возвращает \ref ak_error_ok, если все элементы обработаны успешно.
+    В противном случае возвращается код ошибки первого некорректного элемента.                     */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hmac_context_pbkdf2_streebog512_batch( ak_pbkdf2_item items, const size_t count,
+                                                                            const size_t threads )
+{
+  size_t idx = 0;
+  int error = ak_error_ok;
+  struct pbkdf2_streebog512_queue queue;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_t *tid = NULL;
+  size_t started = 0;
+#endif
+
+  if( items == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                         "using null pointer to array of items" );
+  if( !count ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                               "using zero length array of items" );
+ /* проверяем параметры каждого элемента */
+  for( idx = 0; idx < count; idx++ ) {
+     ak_pbkdf2_item it = items+idx;
+     it->result = ak_hmac_pbkdf2_streebog512_check( it->pass, it->pass_size,
+                                                                 it->salt, it->dklen, it->out );
+     if(( it->result != ak_error_ok ) && ( error == ak_error_ok )) error = it->result;
   }
-  memcpy( out, result+64-dklen, dklen );
 
- /* теперь основной цикл по значению аргумента c */
-  for( idx = 1; idx < cnt; idx++ ) {
-     ak_hmac_context_ptr( &hctx, result, 64, result, sizeof( result ));
-     for( jdx = 0; jdx < dklen; jdx++ ) ((ak_uint8 *)out)[jdx] ^= result[64-dklen+jdx];
+  queue.items = items;
+  queue.count = count;
+  queue.item = queue.block = 0;
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  if( pthread_mutex_init( &queue.mutex, NULL ) != 0 )
+    return ak_error_message( ak_error_undefined_value, __func__ , "wrong initialization of mutex" );
+ /* потоки, которые не удалось создать, не используются: очередь будет обработана остальными */
+  if(( threads > 1 ) && (( tid = malloc(( threads - 1 )*sizeof( pthread_t ))) != NULL )) {
+    for( started = 0; started < threads - 1; started++ )
+       if( pthread_create( tid+started, NULL,
+                                   ak_hmac_pbkdf2_streebog512_batch_thread, &queue ) != 0 ) break;
   }
-  memset( result, 0, 64 );
+  ak_hmac_pbkdf2_streebog512_batch_thread( &queue );
+  for( idx = 0; idx < started; idx++ ) pthread_join( tid[idx], NULL );
+  if( tid != NULL ) free( tid );
+  pthread_mutex_destroy( &queue.mutex );
+#else
+  ak_hmac_pbkdf2_streebog512_batch_thread( &queue );
+  (void)threads;
+#endif
 
-  lab_exit: ak_hmac_context_destroy( &hctx );
  return error;
 }
 
@@ -800,12 +1256,24 @@
    0x78, 0xcc, 0xb8, 0x79, 0xf6, 0x70, 0x68, 0xcd, 0xac, 0x19, 0x10, 0x74, 0x08, 0x44, 0xe8, 0x30
   };
 
+  ak_uint8 R5[100] = {
+   0xb2, 0xd8, 0xf1, 0x24, 0x5f, 0xc4, 0xd2, 0x92, 0x74, 0x80, 0x20, 0x57, 0xe4, 0xb5, 0x4e, 0x0a,
+   0x07, 0x53, 0xaa, 0x22, 0xfc, 0x53, 0x76, 0x0b, 0x30, 0x1c, 0xf0, 0x08, 0x67, 0x9e, 0x58, 0xfe,
+   0x4b, 0xee, 0x9a, 0xdd, 0xca, 0xe9, 0x9b, 0xa2, 0xb0, 0xb2, 0x0f, 0x43, 0x1a, 0x9c, 0x5e, 0x50,
+   0xf3, 0x95, 0xc8, 0x93, 0x87, 0xd0, 0x94, 0x5a, 0xed, 0xec, 0xa6, 0xeb, 0x40, 0x15, 0xdf, 0xc2,
+   0xbd, 0x24, 0x21, 0xee, 0x9b, 0xb7, 0x11, 0x83, 0xba, 0x88, 0x2c, 0xee, 0xbf, 0xef, 0x25, 0x9f,
+   0x33, 0xf9, 0xe2, 0x7d, 0xc6, 0x17, 0x8c, 0xb8, 0x9d, 0xc3, 0x74, 0x28, 0xcf, 0x9c, 0xc5, 0x2a,
+   0x2b, 0xaa, 0x2d, 0x3a
+  };
+
   ak_uint8 password_one[8] = "password",
            password_two[9] = { 'p', 'a', 's', 's', 0, 'w', 'o', 'r', 'd' },
            salt_one[4]     = "salt",
            salt_two[5]     = { 's', 'a', 0, 'l', 't' };
+  const char *password_three = "passwordPASSWORDpassword",
+             *salt_three = "saltSALTsaltSALTsaltSALTsaltSALTsalt";
 
-  ak_uint8 out[64];
+  ak_uint8 out[100];
   int error = ak_error_ok;
   int audit = ak_log_get_level();
 
@@ -864,6 +1332,20 @@
   }
   if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
                                              "the 4th test for pbkdf2 from R 50.1.111-2016 is Ok" );
+
+ /* пятый тест из Р 50.1.111-2016 (ключевой вектор длины 100 октетов) */
+  if(( error = ak_hmac_context_pbkdf2_streebog512(( ak_pointer )password_three, 24,
+                                   ( ak_pointer )salt_three, 36, 4096, 100, out )) != ak_error_ok ) {
+    ak_error_message( error,__func__, "incorrect transformation password to key");
+    return ak_false;
+  }
+  if( !ak_ptr_is_equal_with_log( out, R5, 100 )) {
+    ak_error_message( ak_error_not_equal_data, __func__ ,
+                                                 "wrong 5th test for pbkdf2 from R 50.1.111-2016" );
+    return ak_false;
+  }
+  if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
+                                             "the 5th test for pbkdf2 from R 50.1.111-2016 is Ok" );
  return ak_true;
 }
 
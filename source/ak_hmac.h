@@ -77,6 +77,31 @@
 /*! \brief Развертка ключевого вектора из пароля (согласно Р 50.1.111-2016, раздел 4) */
  int ak_hmac_context_pbkdf2_streebog512( const ak_pointer , const size_t ,
                    const ak_pointer , const size_t, const size_t , const size_t , ak_pointer );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Элемент пакета, обрабатываемого функцией ak_hmac_context_pbkdf2_streebog512_batch(). */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct pbkdf2_item {
+  /*! \brief Пароль, строка символов в utf8 кодировке. */
+   ak_pointer pass;
+  /*! \brief Размер пароля в октетах. */
+   size_t pass_size;
+  /*! \brief Инициализационный вектор. */
+   ak_pointer salt;
+  /*! \brief Размер инициализационного вектора в октетах. */
+   size_t salt_size;
+  /*! \brief Количество итераций. */
+   size_t cnt;
+  /*! \brief Длина вырабатываемого ключевого вектора в октетах. */
+   size_t dklen;
+  /*! \brief Указатель на область памяти, в которую помещается ключевой вектор. */
+   ak_pointer out;
+  /*! \brief Результат обработки данного элемента (код ошибки). */
+   int result;
+} *ak_pbkdf2_item;
+
+/*! \brief Развертка ключевых векторов для набора паролей и инициализационных векторов. */
+ int ak_hmac_context_pbkdf2_streebog512_batch( ak_pbkdf2_item , const size_t , const size_t );
 /*! \brief Тестирование алгоритмов выработки имитовставки HMAC с отечественными
     функциями хеширования семейства Стрибог (ГОСТ Р 34.11-2012). */
  bool_t ak_hmac_test_streebog( void );
@@ -386,6 +386,11 @@
      return ak_false;
    }
 
+ /* выбираем реализации умножения в представлении Монтгомери для используемого процессора */
+   if( ak_mpzn_set_montgomery_functions( ak_true ) && ( ak_log_get_level() >= ak_log_maximum ))
+     ak_error_message( ak_error_ok, __func__ ,
+                                 "library applies mulx, adcx and adox commands for multiplication" );
+
 #ifdef LIBAKRYPT_CRYPTO_FUNCTIONS
  /* инициализируем константные таблицы для алгоритма Кузнечик */
   if(( error = ak_bckey_context_kuznechik_init_gost_tables()) != ak_error_ok ) {
@@ -457,7 +462,11 @@
   if( ak_libakrypt_destroy_context_manager() != ak_error_ok ) {
     ak_error_message( ak_error_get_value(), __func__, "destroying of context manager is wrong" );
   }
+ /* уничтожаем данные секретных ключей, принадлежащие основному потоку */
+  ak_skey_context_thread_data_destroy();
 #endif
+ /* удаляем таблицы кратных точек эллиптических кривых */
+  ak_wcurve_base_tables_destroy();
 
   if( ak_log_get_level() != ak_log_none )
     ak_error_message( ak_error_ok, __func__ , "all crypto mechanisms successfully destroyed" );
@@ -203,6 +203,18 @@
 /*! Функция вычисляет результат сжимающего отображения для заданного файла и помещает
     его в область памяти, на которую указывает out.
 
+    Если операционная система позволяет, обычный файл отображается в память с указанием
+    последовательного характера доступа к данным (`madvise( MADV_SEQUENTIAL )`), что позволяет
+    совместить чтение данных с диска с их обработкой. В противном случае файл считывается
+    фрагментами длины не менее \ref ak_mac_file_buffer_size октетов.
+
+    \note Длина отображенного файла проверяется перед обработкой каждого фрагмента
+    длины \ref ak_mac_file_buffer_size октетов и после вычисления результата; если файл
+    был изменен, он обрабатывается повторно с помощью функции чтения. Усечение файла другим
+    процессом непосредственно во время обработки фрагмента по-прежнему может привести
+    к сигналу SIGBUS, поэтому для файлов, которые могут изменяться во время хеширования,
+    следует использовать функцию ak_mac_context_update() и самостоятельное чтение данных.
+
     @param mctx Указатель на контекст итерационного сжатия.
     @param filename имя сжимаемого файла
     @param out Область памяти, куда будет помещен результат. Память должна быть заранее выделена.
@@ -215,7 +227,7 @@
 /* ----------------------------------------------------------------------------------------------- */
  int ak_mac_context_file( ak_mac mctx, const char* filename, ak_pointer out, const size_t out_size )
 {
-  size_t len = 0;
+  ssize_t len = 0;
   struct file file;
   int error = ak_error_ok;
   size_t block_size = 4096; /* оптимальная длина блока для Windows пока не ясна */
@@ -238,8 +250,40 @@
     return ak_mac_context_finalize( mctx, "", 0, out, out_size );
   }
 
- /* готовим область для хранения данных */
+ /* в начале пытаемся отобразить файл в память: в этом случае данные считываются
+    ядром операционной системы с опережением, одновременно с их обработкой */
+  if(( ak_uint64 )file.size <= ( ak_uint64 )(( size_t )-1 )) {
+    size_t offset = 0, fsize = ( size_t )file.size;
+    ak_uint8 *map = ( ak_uint8 * ) ak_file_mmap( &file, fsize );
+
+    if( map != NULL ) {
+     /* данные обрабатываются фрагментами; перед каждым фрагментом и после вычисления
+        результата проверяется, что файл не был усечен (обращение к отображенной памяти
+        за границей файла привело бы к сигналу SIGBUS) */
+      while( offset < fsize ) {
+        size_t len = ak_min( ak_mac_file_buffer_size, fsize - offset );
+        if( ak_file_get_current_size( &file ) != file.size ) break;
+        ak_mac_context_update( mctx, map + offset, len );
+        offset += len;
+      }
+      if(( offset == fsize ) && ( ak_file_get_current_size( &file ) == file.size ))
+        error = ak_mac_context_finalize( mctx, "", 0, out, out_size );
+       else error = ak_error_read_data;
+      ak_file_unmap( map, fsize );
+      if( error == ak_error_ok ) goto labexit;
+
+     /* длина файла изменилась: повторно обрабатываем файл с помощью функции чтения */
+      if( ak_log_get_level() >= ak_log_maximum ) ak_error_message_fmt( ak_error_ok, __func__,
+                                  "file %s was changed while hashing, reading it again", filename );
+      ak_mac_context_clean( mctx );
+      if(( error = ak_file_seek( &file, 0 )) != ak_error_ok ) goto labexit;
+    }
+  }
+
+ /* готовим область для хранения данных:
+    размер буффера кратен размеру блока файловой системы и не менее ak_mac_file_buffer_size */
   block_size = ak_max( ( size_t )file.blksize, mctx->bsize );
+  block_size *= ak_max( 1, ak_mac_file_buffer_size/block_size );
  /* здесь мы выделяем локальный буффер для считывания/обработки данных */
   if(( localbuffer = ( ak_uint8 * ) ak_libakrypt_aligned_malloc( block_size )) == NULL ) {
     ak_file_close( &file );
@@ -247,22 +291,27 @@
                                                       "memory allocation error for local buffer" );
   }
  /* теперь обрабатываем файл с данными */
-  read_label: len = ( size_t ) ak_file_read( &file, localbuffer, block_size );
-  if( len == block_size ) {
+  read_label: len = ak_file_read( &file, localbuffer, block_size );
+  if( len == ( ssize_t )block_size ) {
     ak_mac_context_update( mctx, localbuffer, block_size ); /* добавляем считанные данные */
     goto read_label;
-  } else {
-           size_t qcnt = len / mctx->bsize,
-                  tail = len - qcnt*mctx->bsize;
+  }
+  if( len < 0 ) error = ak_error_message_fmt( ak_error_read_data, __func__,
+                                                        "incorrect reading of file %s", filename );
+   else {
+           size_t qcnt = ( size_t )len / mctx->bsize,
+                  tail = ( size_t )len - qcnt*mctx->bsize;
            if( qcnt ) ak_mac_context_update( mctx, localbuffer, qcnt*mctx->bsize );
            error = ak_mac_context_finalize( mctx,
                                              localbuffer + qcnt*mctx->bsize, tail, out, out_size );
          }
+  free( localbuffer );
+
  /* очищаем за собой данные, содержащиеся в контексте */
-  ak_mac_context_clean( mctx );
+  labexit:
+   ak_mac_context_clean( mctx );
  /* закрываем данные */
-  ak_file_close( &file );
-  free( localbuffer );
+   ak_file_close( &file );
  return error;
 }
 
@@ -22,6 +22,8 @@
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Максимальный размер блока входных данных. */
  #define ak_mac_context_max_buffer_size (64)
+/*! \brief Минимальный размер буффера, используемого для чтения файлов. */
+ #define ak_mac_file_buffer_size (1048576)
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Контекст алгоритима итерационного сжатия. */
@@ -15,6 +15,9 @@
 #else
  #error Library cannot be compiled without string.h header
 #endif
+#ifdef LIBAKRYPT_HAVE_BUILTIN_MULX_ADX
+ #include <cpuid.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 #if LIBAKRYPT_HAVE_BUILTIN_MULQ_GCC
@@ -498,25 +501,9 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! Функция реализует операцию умножения двух вычетов как двух целых чисел, то есть
-    для \f$ x, y \in \mathbb Z_{2^n} \f$ вычисляется значение \f$ z \in \mathbb Z_{2^n} \f$
-    для которого в точности выполнено равенство \f$ z = x\cdot y\f$.
-
-    Допускается использовать в качестве аргумента z один из аргументов x или y.
-    Однако надо обязательно учитывать тот факт, что результат z занимает в два раза
-    больше места чем x или y.
-
-    Для максимальной эффективности вычислений функция не проверяет допустимые значения параметров.
-
-    @param z    Вычет, в который помещается результат. Должен иметь длину в два раза большую,
-    чем длины вычетов x и y.
-    @param x    Вычет (левый множитель)
-    @param y    Вычет (равый множитель)
-    @param size Размер вычетов x, y в машинных словах - значение, задаваемое константой
-    \ref ak_mpzn256_size или \ref ak_mpzn512_size.
-    @return Функция не возвращает значение.                                                        */
+/*! \brief Умножение вычетов как целых чисел для вычетов произвольной длины. */
 /* ----------------------------------------------------------------------------------------------- */
- void ak_mpzn_mul( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y, const size_t size )
+ static void ak_mpzn_mul_generic( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y, const size_t size )
 {
  size_t i = 0, j = 0, ij = 0;
  ak_mpznmax w = ak_mpznmax_zero;
@@ -576,6 +563,79 @@
    else memcpy( r, s, size*sizeof( ak_uint64 ));
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет вычет \f$ r \f$, удовлетворяющий сравнению \f$ r \equiv u \pmod{q}\f$,
+    методом Барретта. Вычет \f$ u \f$ занимает 2size машинных слов, то есть
+    \f$ 0 \leq u < b^{2k} \f$, где \f$ b = 2^{64} \f$, \f$ k = size \f$; например, \f$ u \f$
+    может быть произведением двух вычетов, вычисленным функцией ak_mpzn_mul().
+
+    Используется заранее вычисленная величина \f$ \mu = \lfloor b^{2k}/q \rfloor \f$,
+    занимающая size+1 машинное слово. Частное оценивается значением
+    \f$ \hat{s} = \lfloor \lfloor u/b^{k-1} \rfloor \mu / b^{k+1} \rfloor \f$, при этом
+    \f$ 0 \leq u - \hat{s}q < 3q \f$. Разность вычисляется по модулю \f$ b^{k+1} \f$, после
+    чего дважды выполняется вычитание модуля с наложением маски. В отличие от
+    функции ak_mpzn_rem(), функция не использует деления и время ее работы не зависит от
+    значения \f$ u \f$.
+
+    @param r Вычет, в который помещается результат (size машинных слов). Указатель на r
+    может совпадать с указателем на u.
+    @param u Приводимый вычет длины 2size машинных слов
+    @param q Модуль, старшее слово которого отлично от нуля
+    @param mu Величина \f$ \lfloor b^{2k}/q \rfloor \f$ длины size+1 машинных слов
+    @param size Размер модуля в машинных словах (не более \ref ak_mpzn512_size).                   */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_rem_barrett( ak_uint64 *r, ak_uint64 *u, ak_uint64 *q,
+                                                              ak_uint64 *mu, const size_t size )
+{
+  size_t i, j;
+  ak_uint64 t[2*ak_mpzn512_size+2], s[ak_mpzn512_size+1], d[ak_mpzn512_size+1],
+            *u1 = u + size - 1, c, w0, w1, mask;
+
+ /* t <- floor( u/b^{k-1} )*mu */
+  for( j = 0; j < 2*size+2; j++ ) t[j] = 0;
+  for( i = 0; i <= size; i++ ) {
+     for( j = 0, c = 0; j <= size; j++ ) {
+        umul_ppmm( w1, w0, u1[j], mu[i] );
+        w0 += c;
+        w1 += w0 < c;
+        t[i+j] += w0;
+        c = w1 + ( t[i+j] < w0 );
+     }
+     t[i+size+1] = c;
+  }
+ /* s <- ( floor( t/b^{k+1} )*q ) (mod b^{k+1}) */
+  for( j = 0; j <= size; j++ ) s[j] = 0;
+  for( i = 0; i <= size; i++ ) {
+     for( j = 0, c = 0; ( j < size ) && ( i+j <= size ); j++ ) {
+        umul_ppmm( w1, w0, t[size+1+i], q[j] );
+        w0 += c;
+        w1 += w0 < c;
+        s[i+j] += w0;
+        c = w1 + ( s[i+j] < w0 );
+     }
+     if( i+j <= size ) s[i+j] += c;
+  }
+ /* s <- u - s (mod b^{k+1}), при этом 0 <= s < 3q */
+  for( j = 0, c = 0; j <= size; j++ ) {
+     w0 = u[j] - s[j];
+     w1 = w0 > u[j];
+     s[j] = w0 - c;
+     c = w1 + ( s[j] > w0 );
+  }
+ /* дважды вычитаем модуль */
+  for( i = 0; i < 2; i++ ) {
+     for( j = 0, c = 0; j <= size; j++ ) {
+        w0 = s[j] - (( j < size ) ? q[j] : 0 );
+        w1 = w0 > s[j];
+        d[j] = w0 - c;
+        c = w1 + ( d[j] > w0 );
+     }
+     mask = ( ak_uint64 )0 - c; /* маска отлична от нуля, если s < q */
+     for( j = 0; j <= size; j++ ) s[j] = d[j] ^ ( mask&( d[j] ^ s[j] ));
+  }
+  memcpy( r, s, size*sizeof( ak_uint64 ));
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Для вычета \f$ x = \sum_{n=0}^{s-1} a_n\cdot \left( 2^{64} \right)^n \f$ в начале вычисляется
     последовательность \f$ r_0 = 0\f$, \f$r_1 = 2^{64} \pmod{p}\f$, \f$r_n = r_1r_{n-1} \pmod{p}\f$.
@@ -698,23 +758,56 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! Функция умножает два вычета x и y в представлении Монтгомери, после чего приводит полученное
-    произведение по модулю p, то есть для \f$ x \equiv x_0r \pmod{p} \f$ и
-    \f$ y \equiv y_0r \pmod{p} \f$ функция вычисляет значение,
-    удовлетворяющее сравнению \f$ z \equiv x_0y_0r \pmod{p}\f$.
-    Результат помещается в переменную z. Указатель на z может совпадать с одним из указателей на
-    перемножаемые вычеты.
+/*! Функция вычитает из вычета x вычет y и приводит полученную разность
+    по модулю p, то есть вычисляет значение сравнения \f$ z \equiv x - y \pmod{p}\f$.
+    Если разность отрицательна, то к ней прибавляется модуль; прибавление выполняется
+    с наложением маски, поэтому время работы функции не зависит от значений x и y.
 
-    @param z Указатель на вычет, в который помещается результат
-    @param x Левый аргумент опреации сложения
-    @param y Правый аргумент операции сложения
-    @param p Модуль, по которому производятся вычисления
-    @param n0 Константа, используемая в вычислениях. Представляет собой младшее слово
-    числа n, удовлетворяющего равенству \f$ rs - np = 1\f$.
-    @param size Размер модуля в словах (значение константы \ref ak_mpzn256_size или
-                                                                          \ref ak_mpzn512_size).   */
+    Результат помещается в переменную z. Указатель на z может совпадать с одним из других аргументов
+    функции.
+
+    @param z Вычет, в который помещается результат
+    @param x Уменьшаемое, вычет, меньший p
+    @param y Вычитаемое, вычет, меньший p
+    @param p Модуль, по которому производится операция вычитания
+    @param size Размер модуля в словах
+    (значение константы \ref ak_mpzn256_size или \ref ak_mpzn512_size ).                           */
 /* ----------------------------------------------------------------------------------------------- */
- inline void ak_mpzn_mul_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+ void ak_mpzn_sub_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                ak_uint64 *p, const size_t size )
+{
+  size_t i;
+  ak_uint64 av = 0, bv = 0, cy = 0, mask = 0;
+
+ // сначала вычитаем: (x - y) -> z
+  for( i = 0; i < size; i++ ) {
+     av = x[i];
+     bv = av - cy;
+     cy = bv > av;
+     av = bv - y[i];
+     cy += av > bv;
+     z[i] = av;
+  }
+ // потом, при наличии заема, прибавляем модуль
+  mask = ( ak_uint64 )0 - cy;
+  for( i = 0, cy = 0; i < size; i++ ) {
+     av = z[i];
+     bv = ( p[i]&mask ) + cy;
+     cy = bv < cy;
+     bv += av;
+     cy += bv < av;
+     z[i] = bv;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Умножение в представлении Монтгомери для модулей произвольной длины.
+
+    Произведение вычисляется полностью, после чего выполняется приведение
+    (метод SOS, Separated Operand Scanning). Функция используется для модулей, длина которых
+    отлична от \ref ak_mpzn256_size и \ref ak_mpzn512_size.                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_mul_montgomery_generic( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
                                                ak_uint64 *p, ak_uint64 n0, const size_t size )
 {
   size_t i = 0, j = 0, ij = 0;
@@ -773,6 +866,712 @@
   if( cy != t[2*size] ) memcpy( z, t+size, size*sizeof( ak_uint64 ));
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Окончательное приведение результата умножения в представлении Монтгомери.
+
+    Функция помещает в z значение \f$ t - p \f$, если \f$ t \geq p \f$, и значение \f$ t \f$
+    в противном случае. Величина \f$ t < 2p \f$ занимает size+1 машинное слово. Выбор результата
+    выполняется с наложением маски, поэтому время работы функции не зависит от значения t.         */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_mul_montgomery_final( ak_uint64 *z, ak_uint64 *t,
+                                                                ak_uint64 *p, const size_t size )
+{
+  size_t j;
+  ak_uint64 r[ak_mpzn512_size], w0, w1, cy = 0, mask;
+
+  for( j = 0; j < size; j++ ) {
+     w0 = t[j] - p[j];
+     w1 = w0 > t[j];
+     r[j] = w0 - cy;
+     cy = w1 + ( r[j] > w0 );
+  }
+  mask = ( ak_uint64 )0 - ( cy > t[size] ); /* маска отлична от нуля, если t < p */
+  for( j = 0; j < size; j++ ) z[j] = r[j] ^ ( mask&( r[j] ^ t[j] ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Умножение в представлении Монтгомери для модулей фиксированной длины.
+
+    Используется метод CIOS (Coarsely Integrated Operand Scanning): после прибавления
+    очередной строки произведения \f$ x \cdot y_i \f$ сразу выполняется шаг редукции, поэтому
+    промежуточное значение занимает только size+2 машинных слова и не требует обнуления
+    массива максимальной длины. Функция вызывается с константным значением size
+    (\ref ak_mpzn256_size или \ref ak_mpzn512_size), что позволяет компилятору полностью
+    развернуть все циклы.                                                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_mul_montgomery_cios( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  size_t i, j;
+  ak_uint64 t[ak_mpzn512_size+2], c, m, w0, w1;
+
+  for( j = 0; j < size+2; j++ ) t[j] = 0;
+  for( i = 0; i < size; i++ ) {
+    /* t <- t + x*y[i] */
+     for( j = 0, c = 0; j < size; j++ ) {
+        umul_ppmm( w1, w0, x[j], y[i] );
+        w0 += c;
+        w1 += w0 < c;
+        t[j] += w0;
+        c = w1 + ( t[j] < w0 );
+     }
+     t[size] += c;
+     t[size+1] = t[size] < c;
+
+    /* t <- ( t + m*p )/2^64 */
+     m = t[0]*n0;
+     umul_ppmm( w1, w0, m, p[0] );
+     w0 += t[0];
+     c = w1 + ( w0 < t[0] );
+     for( j = 1; j < size; j++ ) {
+        umul_ppmm( w1, w0, m, p[j] );
+        w0 += c;
+        w1 += w0 < c;
+        w0 += t[j];
+        w1 += w0 < t[j];
+        t[j-1] = w0;
+        c = w1;
+     }
+     t[size-1] = t[size] + c;
+     t[size] = t[size+1] + ( t[size-1] < c );
+  }
+  ak_mpzn_mul_montgomery_final( z, t, p, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn256_mul_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                     ak_uint64 *p, ak_uint64 n0 )
+{
+  ak_mpzn_mul_montgomery_cios( z, x, y, p, n0, ak_mpzn256_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn512_mul_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                     ak_uint64 *p, ak_uint64 n0 )
+{
+  ak_mpzn_mul_montgomery_cios( z, x, y, p, n0, ak_mpzn512_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление произведения вычетов фиксированной длины как целых чисел.
+
+    Произведение вычисляется по строкам \f$ t \leftarrow t + x\cdot y_i2^{64i} \f$ и занимает
+    2size машинных слов. Указатель t не должен совпадать с указателями на множители.               */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_mul_product( ak_uint64 *t, ak_uint64 *x, ak_uint64 *y,
+                                                                                const size_t size )
+{
+  size_t i, j;
+  ak_uint64 c, w0, w1;
+
+  for( j = 0; j < size; j++ ) t[j] = 0;
+  for( i = 0; i < size; i++ ) {
+     for( j = 0, c = 0; j < size; j++ ) {
+        umul_ppmm( w1, w0, x[j], y[i] );
+        w0 += c;
+        w1 += w0 < c;
+        t[i+j] += w0;
+        c = w1 + ( t[i+j] < w0 );
+     }
+     t[i+size] = c;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn256_mul( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y )
+{
+  ak_uint64 t[2*ak_mpzn256_size];
+
+  ak_mpzn_mul_product( t, x, y, ak_mpzn256_size );
+  memcpy( z, t, sizeof( t ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn512_mul( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y )
+{
+  ak_uint64 t[2*ak_mpzn512_size];
+
+  ak_mpzn_mul_product( t, x, y, ak_mpzn512_size );
+  memcpy( z, t, sizeof( t ));
+}
+
+#ifdef LIBAKRYPT_HAVE_BUILTIN_MULX_ADX
+/* ----------------------------------------------------------------------------------------------- */
+/* Строка \f$ t \leftarrow t + a\cdot v \f$ вычисляется с помощью двух независимых цепочек
+   переносов: младшие слова произведений складываются командой adcx (флаг CF),
+   старшие - командой adox (флаг OF). Регистр r10 хранит старшее слово предыдущего произведения,
+   регистр rax равен нулю. Перенос из старшего слова строки прибавляется к следующему слову.       */
+ #define ak_mulx_row_start \
+   "xor %%r10d, %%r10d\n\t" \
+   "xor %%eax, %%eax\n\t"
+ #define ak_mulx_row_step( offset ) \
+   "mulx " offset "(%[v]), %%r8, %%r9\n\t" \
+   "mov " offset "(%[t]), %%r11\n\t" \
+   "adcx %%r8, %%r11\n\t" \
+   "adox %%r10, %%r11\n\t" \
+   "mov %%r11, " offset "(%[t])\n\t" \
+   "mov %%r9, %%r10\n\t"
+ #define ak_mulx_row_finish( offset, next ) \
+   "mov " offset "(%[t]), %%r11\n\t" \
+   "adcx %%rax, %%r11\n\t" \
+   "adox %%r10, %%r11\n\t" \
+   "mov %%r11, " offset "(%[t])\n\t" \
+   "mov " next "(%[t]), %%r11\n\t" \
+   "adcx %%rax, %%r11\n\t" \
+   "adox %%rax, %%r11\n\t" \
+   "mov %%r11, " next "(%[t])\n\t"
+
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn256_mulx_row( ak_uint64 *t, ak_uint64 *v, ak_uint64 a )
+{
+  __asm__ volatile ( ak_mulx_row_start
+                     ak_mulx_row_step( "0" ) ak_mulx_row_step( "8" )
+                     ak_mulx_row_step( "16" ) ak_mulx_row_step( "24" )
+                     ak_mulx_row_finish( "32", "40" )
+                   : : [t] "r" (t), [v] "r" (v), "d" (a)
+                   : "rax", "r8", "r9", "r10", "r11", "cc", "memory" );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn512_mulx_row( ak_uint64 *t, ak_uint64 *v, ak_uint64 a )
+{
+  __asm__ volatile ( ak_mulx_row_start
+                     ak_mulx_row_step( "0" ) ak_mulx_row_step( "8" )
+                     ak_mulx_row_step( "16" ) ak_mulx_row_step( "24" )
+                     ak_mulx_row_step( "32" ) ak_mulx_row_step( "40" )
+                     ak_mulx_row_step( "48" ) ak_mulx_row_step( "56" )
+                     ak_mulx_row_finish( "64", "72" )
+                   : : [t] "r" (t), [v] "r" (v), "d" (a)
+                   : "rax", "r8", "r9", "r10", "r11", "cc", "memory" );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Умножение в представлении Монтгомери с использованием команд mulx, adcx и adox.
+
+    Вычисления выполняются по методу CIOS, однако вместо сдвига промежуточного значения
+    на одно слово после каждого шага редукции смещается начало обрабатываемой строки;
+    по окончании вычислений результат, меньший 2p, расположен в словах size, ..., 2size.           */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn256_mul_montgomery_mulx( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                     ak_uint64 *p, ak_uint64 n0 )
+{
+  size_t i;
+  ak_uint64 t[2*ak_mpzn256_size+1] = { 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+  for( i = 0; i < ak_mpzn256_size; i++ ) {
+     ak_mpzn256_mulx_row( t+i, x, y[i] );
+     ak_mpzn256_mulx_row( t+i, p, t[i]*n0 );
+  }
+  ak_mpzn_mul_montgomery_final( z, t+ak_mpzn256_size, p, ak_mpzn256_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn512_mul_montgomery_mulx( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                     ak_uint64 *p, ak_uint64 n0 )
+{
+  size_t i;
+  ak_uint64 t[2*ak_mpzn512_size+1] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+  for( i = 0; i < ak_mpzn512_size; i++ ) {
+     ak_mpzn512_mulx_row( t+i, x, y[i] );
+     ak_mpzn512_mulx_row( t+i, p, t[i]*n0 );
+  }
+  ak_mpzn_mul_montgomery_final( z, t+ak_mpzn512_size, p, ak_mpzn512_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление произведения 256-ти битных вычетов с использованием команды mulx. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn256_mul_mulx( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y )
+{
+  size_t i;
+  ak_uint64 t[2*ak_mpzn256_size+1] = { 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+  for( i = 0; i < ak_mpzn256_size; i++ ) ak_mpzn256_mulx_row( t+i, x, y[i] );
+  memcpy( z, t, 2*ak_mpzn256_size*sizeof( ak_uint64 ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление произведения 512-ти битных вычетов с использованием команды mulx. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn512_mul_mulx( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y )
+{
+  size_t i;
+  ak_uint64 t[2*ak_mpzn512_size+1] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+  for( i = 0; i < ak_mpzn512_size; i++ ) ak_mpzn512_mulx_row( t+i, x, y[i] );
+  memcpy( z, t, 2*ak_mpzn512_size*sizeof( ak_uint64 ));
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление квадрата вычета как целого числа.
+
+    Каждое из попарных произведений \f$ x_ix_j, i < j, \f$ вычисляется один раз, после чего
+    их сумма удваивается и к ней прибавляются квадраты слов \f$ x_i^2 \f$. По сравнению
+    с умножением количество умножений машинных слов сокращается с \f$ n^2 \f$
+    до \f$ n(n+1)/2 \f$. Результат занимает 2size машинных слов.                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_sqr_product( ak_uint64 *t, ak_uint64 *x, const size_t size )
+{
+  size_t i, j;
+  ak_uint64 c, h, a0, a1, w0, w1;
+
+  for( j = 0; j < 2*size; j++ ) t[j] = 0;
+ /* попарные произведения */
+  for( i = 0; i < size-1; i++ ) {
+     for( j = i+1, c = 0; j < size; j++ ) {
+        umul_ppmm( w1, w0, x[i], x[j] );
+        w0 += c;
+        w1 += w0 < c;
+        t[i+j] += w0;
+        c = w1 + ( t[i+j] < w0 );
+     }
+     t[i+size] = c;
+  }
+ /* удвоение и прибавление квадратов слов (обрабатываются пары слов t[2i], t[2i+1]) */
+  for( i = 0, c = 0, h = 0; i < size; i++ ) {
+     a0 = ( t[2*i] << 1 )|h;
+     a1 = ( t[2*i+1] << 1 )|( t[2*i] >> 63 );
+     h = t[2*i+1] >> 63;
+     umul_ppmm( w1, w0, x[i], x[i] );
+     w0 += c;
+     w1 += w0 < c;
+     t[2*i] = a0 + w0;
+     w1 += t[2*i] < w0;
+     t[2*i+1] = a1 + w1;
+     c = t[2*i+1] < w1;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Приведение в представлении Монтгомери значения, занимающего 2size машинных слов.
+
+    Для \f$ t = t_0 + t_1r \f$ функция вычисляет \f$ z \equiv tr^{-1} \pmod{p} \f$ как
+    сумму \f$ (t_0 + mp)/r + t_1 \f$, где \f$ m \equiv -t_0p^{-1} \pmod{r} \f$. Величина
+    \f$ (t_0 + mp)/r \f$ вычисляется по методу CIOS, результат сложения меньше \f$ 2p \f$.         */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_redc( ak_uint64 *z, ak_uint64 *t, ak_uint64 *p, ak_uint64 n0,
+                                                                                const size_t size )
+{
+  size_t i, j;
+  ak_uint64 u[ak_mpzn512_size+1], c, m, w0, w1;
+
+  for( j = 0; j < size; j++ ) u[j] = t[j];
+  u[size] = 0;
+ /* u <- ( t_0 + m*p )/r */
+  for( i = 0; i < size; i++ ) {
+     m = u[0]*n0;
+     umul_ppmm( w1, w0, m, p[0] );
+     w0 += u[0];
+     c = w1 + ( w0 < u[0] );
+     for( j = 1; j < size; j++ ) {
+        umul_ppmm( w1, w0, m, p[j] );
+        w0 += c;
+        w1 += w0 < c;
+        w0 += u[j];
+        w1 += w0 < u[j];
+        u[j-1] = w0;
+        c = w1;
+     }
+     u[size-1] = u[size] + c;
+     u[size] = u[size-1] < c;
+  }
+ /* u <- u + t_1 */
+  for( j = 0, c = 0; j < size; j++ ) {
+     w0 = u[j] + c;
+     c = w0 < c;
+     u[j] = w0 + t[j+size];
+     c += u[j] < w0;
+  }
+  u[size] += c;
+  ak_mpzn_mul_montgomery_final( z, u, p, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция приводит в представлении Монтгомери значение \f$ t = t_0 + t_1r \f$, занимающее
+    2size машинных слов, то есть вычисляет \f$ z \equiv tr^{-1} \pmod{p} \f$, для модуля
+    специального вида \f$ p = r - c \f$, где \f$ 0 < c < 2^{64} \f$. К таким модулям относятся
+    модули кривых id_tc26_gost_3410_2012_256_paramSetA, id_rfc4357_gost_3410_2001_paramSetA,
+    id_tc26_gost_3410_2012_512_paramSetA, id_tc26_gost_3410_2012_512_paramSetC и других.
+
+    Для модуля такого вида выполнено равенство \f$ n_0 \equiv c^{-1} \pmod{2^{64}} \f$, а
+    сравнение \f$ t_0 + mp \equiv 0 \pmod{r} \f$ равносильно равенству \f$ t_0 - mc \equiv 0
+    \pmod{r}\f$. Поэтому слова \f$ m_i \f$ множителя \f$ m \f$ вычисляются последовательно,
+    при этом на каждом шаге выполняется только одно умножение \f$ m_i \cdot c \f$ вместо size
+    умножений \f$ m_i \cdot p_j \f$. Результат вычисляется как
+    \f$ (t_0 - mc)/r + t_1 + m < 2p \f$ и окончательно приводится по модулю \f$ p \f$.
+
+    Функция не проверяет вид модуля p; указатель на функцию помещается в контекст
+    эллиптической кривой (поле redc структуры \ref wcurve) только для модулей указанного вида.
+
+    @param z Указатель на вычет, в который помещается результат
+    @param t Приводимое значение, занимающее 2size машинных слов
+    @param p Модуль, по которому производятся вычисления
+    @param n0 Константа, используемая в вычислениях. Представляет собой младшее слово
+    числа n, удовлетворяющего равенству \f$ rs - np = 1\f$.
+    @param size Размер модуля в словах (значение константы \ref ak_mpzn256_size или
+                                                                          \ref ak_mpzn512_size).   */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_redc_pseudo_mersenne( ak_uint64 *z, ak_uint64 *t, ak_uint64 *p,
+                                                             ak_uint64 n0, const size_t size )
+{
+  size_t i;
+  ak_uint64 m[ak_mpzn512_size], u[ak_mpzn512_size+1], c = ( ak_uint64 )0 - p[0];
+  ak_uint64 h = 0, b = 0, w0, w1, lo;
+
+ /* слова m_i, для которых ( t_0 - m*c ) делится на r; h и b - перенос и заем */
+  for( i = 0; i < size; i++ ) {
+     w0 = t[i] - h;
+     w1 = w0 - b;
+     b = ( w0 > t[i] ) + ( w1 > w0 );
+     m[i] = w1*n0;
+     umul_ppmm( h, lo, m[i], c );
+  }
+  ( void )lo;
+ /* u <- t_1 + m - ( h + b ) */
+  for( i = 0, c = 0; i < size; i++ ) {
+     w0 = t[i+size] + c;
+     c = w0 < c;
+     u[i] = w0 + m[i];
+     c += u[i] < w0;
+  }
+  u[size] = c;
+  w0 = u[0] - h;
+  w1 = w0 - b;
+  c = ( w0 > u[0] ) + ( w1 > w0 );
+  u[0] = w1;
+  for( i = 1; i <= size; i++ ) {
+     w0 = u[i] - c;
+     c = w0 > u[i];
+     u[i] = w0;
+  }
+  ak_mpzn_mul_montgomery_final( z, u, p, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn256_sqr_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *p, ak_uint64 n0 )
+{
+  ak_uint64 t[2*ak_mpzn256_size];
+
+  ak_mpzn_sqr_product( t, x, ak_mpzn256_size );
+  ak_mpzn_redc( z, t, p, n0, ak_mpzn256_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn512_sqr_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *p, ak_uint64 n0 )
+{
+  ak_uint64 t[2*ak_mpzn512_size];
+
+  ak_mpzn_sqr_product( t, x, ak_mpzn512_size );
+  ak_mpzn_redc( z, t, p, n0, ak_mpzn512_size );
+}
+
+#ifdef LIBAKRYPT_HAVE_BUILTIN_MULX_ADX
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Возведение в квадрат с приведением, использующим команды mulx, adcx и adox.
+
+    Строки \f$ t_0 + m_ip \f$ вычисляются функцией ak_mpzn512_mulx_row() так же, как и при
+    умножении. Для 256-ти битных модулей такое приведение не дает выигрыша по сравнению
+    с функцией ak_mpzn_redc(), поэтому используется только для 512-ти битных модулей.              */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn512_sqr_montgomery_mulx( ak_uint64 *z, ak_uint64 *x,
+                                                                     ak_uint64 *p, ak_uint64 n0 )
+{
+  size_t i;
+  ak_uint64 t[2*ak_mpzn512_size], u[2*ak_mpzn512_size+1], c, w0;
+
+  ak_mpzn_sqr_product( t, x, ak_mpzn512_size );
+  for( i = 0; i < ak_mpzn512_size; i++ ) { u[i] = t[i]; u[i+ak_mpzn512_size] = 0; }
+  u[2*ak_mpzn512_size] = 0;
+ /* u <- ( t_0 + m*p )/r */
+  for( i = 0; i < ak_mpzn512_size; i++ ) ak_mpzn512_mulx_row( u+i, p, u[i]*n0 );
+ /* u <- u + t_1 */
+  for( i = ak_mpzn512_size, c = 0; i < 2*ak_mpzn512_size; i++ ) {
+     w0 = u[i] + c;
+     c = w0 < c;
+     u[i] = w0 + t[i];
+     c += u[i] < w0;
+  }
+  u[2*ak_mpzn512_size] += c;
+  ak_mpzn_mul_montgomery_final( z, u+ak_mpzn512_size, p, ak_mpzn512_size );
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Тип функции умножения в представлении Монтгомери для модуля фиксированной длины. */
+ typedef void ( ak_function_mpzn_mul_montgomery )( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                                        ak_uint64 *, ak_uint64 );
+/*! \brief Функция умножения, используемая для 256-ти битных модулей. */
+ static ak_function_mpzn_mul_montgomery *ak_mpzn256_mul_montgomery_function =
+                                                                        ak_mpzn256_mul_montgomery;
+/*! \brief Функция умножения, используемая для 512-ти битных модулей. */
+ static ak_function_mpzn_mul_montgomery *ak_mpzn512_mul_montgomery_function =
+                                                                        ak_mpzn512_mul_montgomery;
+/*! \brief Тип функции возведения в квадрат в представлении Монтгомери. */
+ typedef void ( ak_function_mpzn_sqr_montgomery )( ak_uint64 *, ak_uint64 *,
+                                                                        ak_uint64 *, ak_uint64 );
+/*! \brief Функция возведения в квадрат, используемая для 256-ти битных модулей. */
+ static ak_function_mpzn_sqr_montgomery *ak_mpzn256_sqr_montgomery_function =
+                                                                        ak_mpzn256_sqr_montgomery;
+/*! \brief Функция возведения в квадрат, используемая для 512-ти битных модулей. */
+ static ak_function_mpzn_sqr_montgomery *ak_mpzn512_sqr_montgomery_function =
+                                                                        ak_mpzn512_sqr_montgomery;
+/*! \brief Тип функции умножения вычетов фиксированной длины как целых чисел. */
+ typedef void ( ak_function_mpzn_mul )( ak_uint64 *, ak_uint64 *, ak_uint64 * );
+/*! \brief Функция умножения, используемая для 256-ти битных вычетов. */
+ static ak_function_mpzn_mul *ak_mpzn256_mul_function = ak_mpzn256_mul;
+/*! \brief Функция умножения, используемая для 512-ти битных вычетов. */
+ static ak_function_mpzn_mul *ak_mpzn512_mul_function = ak_mpzn512_mul;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция выбирает реализации умножения и возведения в квадрат в представлении Монтгомери,
+    а также умножения вычетов как целых чисел, используемые для 256-ти и 512-ти битных модулей.
+    Если использование расширений системы команд разрешено и процессор поддерживает команды
+    mulx, adcx и adox (наборы BMI2 и ADX), то выбираются реализации, использующие эти команды;
+    в противном случае используются переносимые реализации. Функция вызывается при инициализации библиотеки.
+
+    @param extensions Флаг, разрешающий использование расширений системы команд.
+    @return Функция возвращает \ref ak_true, если выбраны реализации, использующие команды
+    mulx, adcx и adox. В противном случае возвращается \ref ak_false.                              */
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_mpzn_set_montgomery_functions( bool_t extensions )
+{
+#ifdef LIBAKRYPT_HAVE_BUILTIN_MULX_ADX
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+  if( extensions && __get_cpuid_count( 7, 0, &eax, &ebx, &ecx, &edx ) &&
+                                     ( ebx&( 1 << 8 )) && ( ebx&( 1 << 19 ))) { /* BMI2 и ADX */
+    ak_mpzn256_mul_montgomery_function = ak_mpzn256_mul_montgomery_mulx;
+    ak_mpzn512_mul_montgomery_function = ak_mpzn512_mul_montgomery_mulx;
+    ak_mpzn512_sqr_montgomery_function = ak_mpzn512_sqr_montgomery_mulx;
+    ak_mpzn256_mul_function = ak_mpzn256_mul_mulx;
+    ak_mpzn512_mul_function = ak_mpzn512_mul_mulx;
+    return ak_true;
+  }
+#else
+  ( void )extensions;
+#endif
+  ak_mpzn256_mul_montgomery_function = ak_mpzn256_mul_montgomery;
+  ak_mpzn512_mul_montgomery_function = ak_mpzn512_mul_montgomery;
+  ak_mpzn256_sqr_montgomery_function = ak_mpzn256_sqr_montgomery;
+  ak_mpzn512_sqr_montgomery_function = ak_mpzn512_sqr_montgomery;
+  ak_mpzn256_mul_function = ak_mpzn256_mul;
+  ak_mpzn512_mul_function = ak_mpzn512_mul;
+ return ak_false;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция умножает два вычета x и y в представлении Монтгомери, после чего приводит полученное
+    произведение по модулю p, то есть для \f$ x \equiv x_0r \pmod{p} \f$ и
+    \f$ y \equiv y_0r \pmod{p} \f$ функция вычисляет значение,
+    удовлетворяющее сравнению \f$ z \equiv x_0y_0r \pmod{p}\f$.
+    Результат помещается в переменную z. Указатель на z может совпадать с одним из указателей на
+    перемножаемые вычеты.
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Левый аргумент опреации сложения
+    @param y Правый аргумент операции сложения
+    @param p Модуль, по которому производятся вычисления
+    @param n0 Константа, используемая в вычислениях. Представляет собой младшее слово
+    числа n, удовлетворяющего равенству \f$ rs - np = 1\f$.
+    @param size Размер модуля в словах (значение константы \ref ak_mpzn256_size или
+                                                                          \ref ak_mpzn512_size).
+
+    Для модулей длины \ref ak_mpzn256_size и \ref ak_mpzn512_size используются реализации
+    с развернутыми циклами, выбираемые функцией ak_mpzn_set_montgomery_functions().                */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_mul_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  switch( size ) {
+    case ak_mpzn256_size: ak_mpzn256_mul_montgomery_function( z, x, y, p, n0 );
+      break;
+    case ak_mpzn512_size: ak_mpzn512_mul_montgomery_function( z, x, y, p, n0 );
+      break;
+    default: ak_mpzn_mul_montgomery_generic( z, x, y, p, n0, size );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция возводит в квадрат вычет x в представлении Монтгомери, то есть для
+    \f$ x \equiv x_0r \pmod{p} \f$ вычисляет значение, удовлетворяющее сравнению
+    \f$ z \equiv x_0^2r \pmod{p}\f$. Результат совпадает с результатом вызова
+    ak_mpzn_mul_montgomery( z, x, x, p, n0, size ), однако при вычислении произведения
+    используется симметричность попарных произведений слов вычета x. Указатель на z может
+    совпадать с указателем на x.
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Вычет, возводимый в квадрат
+    @param p Модуль, по которому производятся вычисления
+    @param n0 Константа, используемая в вычислениях. Представляет собой младшее слово
+    числа n, удовлетворяющего равенству \f$ rs - np = 1\f$.
+    @param size Размер модуля в словах (значение константы \ref ak_mpzn256_size или
+                                                                          \ref ak_mpzn512_size).   */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_sqr_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *p,
+                                                             ak_uint64 n0, const size_t size )
+{
+  switch( size ) {
+    case ak_mpzn256_size: ak_mpzn256_sqr_montgomery_function( z, x, p, n0 );
+      break;
+    case ak_mpzn512_size: ak_mpzn512_sqr_montgomery_function( z, x, p, n0 );
+      break;
+    default: ak_mpzn_mul_montgomery_generic( z, x, x, p, n0, size );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция реализует операцию умножения двух вычетов как двух целых чисел, то есть
+    для \f$ x, y \in \mathbb Z_{2^n} \f$ вычисляется значение \f$ z \in \mathbb Z_{2^n} \f$
+    для которого в точности выполнено равенство \f$ z = x\cdot y\f$.
+
+    Допускается использовать в качестве аргумента z один из аргументов x или y.
+    Однако надо обязательно учитывать тот факт, что результат z занимает в два раза
+    больше места чем x или y.
+
+    Для максимальной эффективности вычислений функция не проверяет допустимые значения параметров.
+
+    @param z    Вычет, в который помещается результат. Должен иметь длину в два раза большую,
+    чем длины вычетов x и y.
+    @param x    Вычет (левый множитель)
+    @param y    Вычет (равый множитель)
+    @param size Размер вычетов x, y в машинных словах - значение, задаваемое константой
+    \ref ak_mpzn256_size или \ref ak_mpzn512_size.
+    @return Функция не возвращает значение.
+
+    Для вычетов длины \ref ak_mpzn256_size и \ref ak_mpzn512_size используются реализации
+    с развернутыми циклами, выбираемые функцией ak_mpzn_set_montgomery_functions().                */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_mul( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y, const size_t size )
+{
+  switch( size ) {
+    case ak_mpzn256_size: ak_mpzn256_mul_function( z, x, y );
+      break;
+    case ak_mpzn512_size: ak_mpzn512_mul_function( z, x, y );
+      break;
+    default: ak_mpzn_mul_generic( z, x, y, size );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет квадрат вычета x как целого числа, то есть значение \f$ z = x^2 \f$,
+    занимающее 2size машинных слов. Результат совпадает с результатом вызова
+    ak_mpzn_mul( z, x, x, size ), однако каждое из попарных произведений слов вычета x
+    вычисляется только один раз. Допускается использовать в качестве аргумента z вычет x.
+
+    @param z    Вычет, в который помещается результат. Должен иметь длину в два раза большую,
+    чем длина вычета x.
+    @param x    Вычет, возводимый в квадрат
+    @param size Размер вычета x в машинных словах (значение, не превосходящее
+    \ref ak_mpzn512_size).                                                                         */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_sqr( ak_uint64 *z, ak_uint64 *x, const size_t size )
+{
+  ak_uint64 t[2*ak_mpzn512_size];
+
+  switch( size ) {
+    case ak_mpzn256_size: ak_mpzn_sqr_product( t, x, ak_mpzn256_size );
+      break;
+    case ak_mpzn512_size: ak_mpzn_sqr_product( t, x, ak_mpzn512_size );
+      break;
+    default: ak_mpzn_sqr_product( t, x, size );
+  }
+  memcpy( z, t, 2*size*sizeof( ak_uint64 ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Длина окна при возведении в степень методом окон фиксированной длины. */
+ #define ak_mpzn_modpow_fixed_bits (4)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Возведение в степень методом окон фиксированной длины.
+
+    Показатель k обрабатывается полностью, начиная со старшего бита слова k[size-1], окнами
+    по \ref ak_mpzn_modpow_fixed_bits бит. Для каждого окна выполняется одно и то же количество
+    возведений в квадрат и одно умножение на значение \f$ x^d \f$, \f$ 0 \leq d < 16 \f$,
+    которое выбирается из таблицы с помощью масок (при выборе просматриваются все элементы
+    таблицы). Поэтому последовательность операций и обращений к памяти не зависит от значения k.   */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_modpow_montgomery_fixed( ak_uint64 *z, ak_uint64 *x, ak_uint64 *k,
+                               ak_uint64 *p, ak_uint64 n0, ak_uint64 *one, const size_t size )
+{
+  size_t i, j, l, bits = 64*size;
+  ak_uint64 table[1 << ak_mpzn_modpow_fixed_bits][ak_mpzn512_size], res[ak_mpzn512_size],
+            v[ak_mpzn512_size], d, mask;
+
+ /* таблица значений x^0, x^1, ..., x^15 */
+  ak_mpzn_set( table[0], one, size );
+  ak_mpzn_set( table[1], x, size );
+  for( i = 2; i < ( 1 << ak_mpzn_modpow_fixed_bits ); i++ )
+     ak_mpzn_mul_montgomery( table[i], table[i-1], x, p, n0, size );
+
+  for( i = bits; i > 0; ) {
+     i -= ak_mpzn_modpow_fixed_bits;
+     d = ( k[i >> 6] >> ( i&0x3f ))&(( 1 << ak_mpzn_modpow_fixed_bits ) - 1 );
+    /* v <- table[d] */
+     memset( v, 0, sizeof( v ));
+     for( j = 0; j < ( 1 << ak_mpzn_modpow_fixed_bits ); j++ ) {
+        mask = ( ak_uint64 )0 - ((( ak_uint64 )( j^d ) - 1 ) >> 63 );
+        for( l = 0; l < size; l++ ) v[l] |= table[j][l]&mask;
+     }
+     if( i == bits - ak_mpzn_modpow_fixed_bits ) ak_mpzn_set( res, v, size );
+      else {
+        for( j = 0; j < ak_mpzn_modpow_fixed_bits; j++ )
+           ak_mpzn_sqr_montgomery( res, res, p, n0, size );
+        ak_mpzn_mul_montgomery( res, res, v, p, n0, size );
+      }
+  }
+  ak_mpzn_set( z, res, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Возведение в степень методом скользящих окон.
+
+    Вычисляется таблица нечетных степеней \f$ x, x^3, \ldots, x^{2^w-1} \f$, где длина окна
+    \f$ w \f$ равна 4 для 256-ти битных и 5 для 512-ти битных модулей. Показатель k
+    просматривается, начиная со старшего ненулевого бита; нулевые биты обрабатываются
+    только возведением в квадрат, а каждое окно, заканчивающееся единичным битом,
+    одним умножением на элемент таблицы. Время вычислений зависит от значения k, поэтому
+    функция используется только для открытых значений показателя.                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_modpow_montgomery_sliding( ak_uint64 *z, ak_uint64 *x, ak_uint64 *k,
+                               ak_uint64 *p, ak_uint64 n0, ak_uint64 *one, const size_t size )
+{
+  long long int i, j, l;
+  size_t w = ( size > ak_mpzn256_size ) ? 5 : 4;
+  ak_uint64 table[16][ak_mpzn512_size], res[ak_mpzn512_size], d;
+  bool_t started = ak_false;
+
+ /* таблица нечетных степеней: table[i] = x^{2i+1} */
+  ak_mpzn_sqr_montgomery( res, x, p, n0, size );
+  ak_mpzn_set( table[0], x, size );
+  for( i = 1; i < ( 1 << ( w-1 )); i++ )
+     ak_mpzn_mul_montgomery( table[i], table[i-1], res, p, n0, size );
+
+  ak_mpzn_set( res, one, size );
+  for( i = 64*( long long int )size - 1; i >= 0; ) {
+     if((( k[i >> 6] >> ( i&0x3f ))&1 ) == 0 ) {
+       if( started ) ak_mpzn_sqr_montgomery( res, res, p, n0, size );
+       i--;
+       continue;
+     }
+    /* окно из l бит с номерами i, ..., i-l+1, младший бит которого равен единице */
+     l = ( i+1 < ( long long int )w ) ? i+1 : ( long long int )w;
+     while((( k[( i-l+1 ) >> 6] >> (( i-l+1 )&0x3f ))&1 ) == 0 ) l--;
+     for( j = i, d = 0; j > i-l; j-- ) d = ( d << 1 )|(( k[j >> 6] >> ( j&0x3f ))&1 );
+     if( started ) {
+       for( j = 0; j < l; j++ ) ak_mpzn_sqr_montgomery( res, res, p, n0, size );
+       ak_mpzn_mul_montgomery( res, res, table[d >> 1], p, n0, size );
+     } else {
+         ak_mpzn_set( res, table[d >> 1], size );
+         started = ak_true;
+       }
+     i -= l;
+  }
+  ak_mpzn_set( z, res, size );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Для вычета \f$ x \f$, заданного в представлении Монтгомери в виде \f$ xr \f$, где \f$ r \f$
     заданная степень двойки, вычисляется вычет \f$ z \f$,
@@ -780,6 +1579,11 @@
     Результат \f$ z \f$  является значением вычета \f$ x^k \pmod{p}\f$ в представлении Монтгомери.
     Величины \f$ k \f$  и \f$ p \f$ задаются как обычные вычеты и \f$ p \f$  отлично от нуля.
 
+    Если значение показателя k является секретным, то должен использоваться метод окон
+    фиксированной длины (\ref modpow_fixed_window), время работы которого не зависит от k.
+    Для открытых значений показателя, например, при проверке параметров эллиптических кривых,
+    используется более быстрый метод скользящих окон (\ref modpow_sliding_window).
+
     @param z Вычет, в который помещается результат
     @param x Вычет, который возводится в степень \f$ k \f$
     @param k Степень, в которую возводится вычет \f$ x \f$
@@ -787,36 +1591,293 @@
     @param n0 Константа, используемая в вычислениях. Представляет собой младшее слово числа n,
     удовлетворяющего равенству \f$ rs - np = 1\f$.
     @param size Размер модуля в словах (значение константы \ref ak_mpzn256_size
-    или \ref ak_mpzn512_size )                                                                     */
+    или \ref ak_mpzn512_size )
+    @param window Способ возведения в степень.                                                     */
 /* ----------------------------------------------------------------------------------------------- */
  void ak_mpzn_modpow_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *k,
-                                                   ak_uint64 *p, ak_uint64 n0, const size_t size )
-{
-  ak_uint64 uk = 0;
-  size_t s = size-1;
-  long long int i, j;
-  ak_mpznmax res = ak_mpznmax_zero; // это константа r (mod p) = r-p
-  if( ak_mpzn_sub( res, res, p, size ) == 0 ) {
-    ak_error_message( ak_error_undefined_value,
-                                          "using an unexpected value of prime modulo", __func__ );
+                       ak_uint64 *p, ak_uint64 n0, const size_t size, modpow_window_t window )
+{
+  ak_mpznmax one = ak_mpznmax_zero;
+
+ /* one <- r (mod p), единица в представлении Монтгомери */
+  if( ak_mpzn_sub( one, one, p, size ) == 0 ) {
+    ak_error_message( ak_error_undefined_value, __func__,
+                                                     "using an unexpected value of prime modulo" );
     return;
   }
-  while( k[s] == 0 ) {
-     if( s > 0 ) --s;
-      else {
-             ak_mpzn_set( z, res, size );
-             return;
-           }
-  }
-  for( i = s; i >= 0; i-- ) {
-     uk = k[i];
-     for( j = 0; j < 64; j++ ) {
-        ak_mpzn_mul_montgomery( res, res, res, p, n0, size );
-        if( uk&0x8000000000000000LL ) ak_mpzn_mul_montgomery( res, res, x, p, n0, size );
-        uk <<= 1;
+  ak_mpzn_rem( one, one, p, size );
+
+  if( window == modpow_fixed_window )
+    ak_mpzn_modpow_montgomery_fixed( z, x, k, p, n0, one, size );
+   else ak_mpzn_modpow_montgomery_sliding( z, x, k, p, n0, one, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                     обращение вычетов методом Бернштейна-Янга (safegcd)                         */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество 30-ти битных слов, достаточное для представления вычетов ak_mpzn512. */
+ #define ak_mpzn_signed30_size (18)
+/*! \brief Маска младших 30-ти бит. */
+ #define ak_mpzn_signed30_mask ((ak_int32)0x3fffffff)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Преобразование вычета в последовательность 30-ти битных слов. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_to_signed30( ak_int32 *a, const size_t len, ak_uint64 *x, const size_t size )
+{
+  size_t i, w, s;
+  ak_uint64 v;
+
+  for( i = 0; i < len; i++ ) {
+     w = ( 30*i ) >> 6;
+     s = ( 30*i )&0x3f;
+     v = 0;
+     if( w < size ) {
+       v = x[w] >> s;
+       if(( s > 34 ) && ( w+1 < size )) v |= x[w+1] << ( 64 - s );
      }
+     a[i] = ( ak_int32 )( v&ak_mpzn_signed30_mask );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Преобразование последовательности неотрицательных 30-ти битных слов в вычет. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_from_signed30( ak_uint64 *x, const size_t size, ak_int32 *a, const size_t len )
+{
+  size_t i, w, s;
+
+  memset( x, 0, size*sizeof( ak_uint64 ));
+  for( i = 0; i < len; i++ ) {
+     w = ( 30*i ) >> 6;
+     s = ( 30*i )&0x3f;
+     if( w < size ) x[w] |= ( ak_uint64 )a[i] << s;
+     if(( s > 34 ) && ( w+1 < size )) x[w+1] |= ( ak_uint64 )a[i] >> ( 64 - s );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Выполнение 30-ти шагов divstep над младшими словами значений f и g.
+
+    Функция вычисляет матрицу перехода \f$ t = \left(\begin{smallmatrix} u & v \\ q & r
+    \end{smallmatrix}\right) \f$, умноженную на \f$ 2^{30} \f$, для которой
+    \f$ 2^{30}(f', g') = t(f, g) \f$, и возвращает новое значение \f$ \delta \f$.
+    Каждый шаг выполняется без ветвлений: выбор одного из трех вариантов шага
+    \f$ (\delta, f, g) \rightarrow (1 - \delta, g, (g - f)/2) \f$,
+    \f$ (1 + \delta, f, (g + f)/2) \f$ или \f$ (1 + \delta, f, g/2) \f$ выполняется
+    с помощью масок.                                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_int32 ak_mpzn_divsteps_30( ak_int32 delta, ak_uint32 f, ak_uint32 g, ak_int32 *t )
+{
+  int i;
+  ak_uint32 u = 1, v = 0, q = 0, r = 1, c1, c2, x, y, z;
+
+  for( i = 0; i < 30; i++ ) {
+     c1 = ( ak_uint32 )(( -delta ) >> 31 );   /* маска отлична от нуля, если delta > 0 */
+     c2 = ( ak_uint32 )0 - ( g&1 );           /* маска отлична от нуля, если g нечетно */
+     x = ( f^c1 ) - c1;
+     y = ( u^c1 ) - c1;
+     z = ( v^c1 ) - c1;
+     g += x&c2; q += y&c2; r += z&c2;
+     c1 &= c2;                                /* маска отлична от нуля, если f и g меняются */
+     delta = ( delta^( ak_int32 )c1 ) - ( ak_int32 )c1 + 1;
+     f += g&c1; u += q&c1; v += r&c1;
+     g >>= 1; u <<= 1; v <<= 1;
+  }
+  t[0] = ( ak_int32 )u; t[1] = ( ak_int32 )v; t[2] = ( ak_int32 )q; t[3] = ( ak_int32 )r;
+ return delta;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление \f$ (d, e) \leftarrow t(d, e)/2^{30} \pmod{p} \f$.
+
+    К значениям \f$ td \f$ и \f$ te \f$ прибавляются кратные модуля, для которых
+    младшие 30 бит суммы равны нулю, после чего выполняется точное деление на \f$ 2^{30} \f$.
+    Значения \f$ d, e \f$ до и после преобразования лежат в интервале \f$ (-2p, p) \f$.            */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_update_de_30( ak_int32 *d, ak_int32 *e, ak_int32 *t,
+                                     ak_int32 *p, ak_uint32 pinv, const size_t len )
+{
+  size_t i;
+  ak_int32 md, me, sd, se;
+  ak_int64 cd, ce;
+  const ak_int32 u = t[0], v = t[1], q = t[2], r = t[3];
+
+ /* md, me равны u и q, если d < 0, плюс v и r, если e < 0 */
+  sd = d[len-1] >> 31;
+  se = e[len-1] >> 31;
+  md = ( u&sd ) + ( v&se );
+  me = ( q&sd ) + ( r&se );
+  cd = ( ak_int64 )u*d[0] + ( ak_int64 )v*e[0];
+  ce = ( ak_int64 )q*d[0] + ( ak_int64 )r*e[0];
+ /* корректируем md и me так, чтобы младшие 30 бит сумм t(d, e) + p(md, me) были нулевыми */
+  md -= ( ak_int32 )(( pinv*( ak_uint32 )cd + ( ak_uint32 )md )&ak_mpzn_signed30_mask );
+  me -= ( ak_int32 )(( pinv*( ak_uint32 )ce + ( ak_uint32 )me )&ak_mpzn_signed30_mask );
+  cd += ( ak_int64 )p[0]*md;
+  ce += ( ak_int64 )p[0]*me;
+  cd >>= 30;
+  ce >>= 30;
+  for( i = 1; i < len; i++ ) {
+     cd += ( ak_int64 )u*d[i] + ( ak_int64 )v*e[i] + ( ak_int64 )p[i]*md;
+     ce += ( ak_int64 )q*d[i] + ( ak_int64 )r*e[i] + ( ak_int64 )p[i]*me;
+     d[i-1] = ( ak_int32 )cd&ak_mpzn_signed30_mask; cd >>= 30;
+     e[i-1] = ( ak_int32 )ce&ak_mpzn_signed30_mask; ce >>= 30;
+  }
+  d[len-1] = ( ak_int32 )cd;
+  e[len-1] = ( ak_int32 )ce;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление \f$ (f, g) \leftarrow t(f, g)/2^{30} \f$ (деление выполняется нацело). */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_update_fg_30( ak_int32 *f, ak_int32 *g, ak_int32 *t, const size_t len )
+{
+  size_t i;
+  ak_int64 cf, cg;
+  const ak_int32 u = t[0], v = t[1], q = t[2], r = t[3];
+
+  cf = ( ak_int64 )u*f[0] + ( ak_int64 )v*g[0];
+  cg = ( ak_int64 )q*f[0] + ( ak_int64 )r*g[0];
+  cf >>= 30;
+  cg >>= 30;
+  for( i = 1; i < len; i++ ) {
+     cf += ( ak_int64 )u*f[i] + ( ak_int64 )v*g[i];
+     cg += ( ak_int64 )q*f[i] + ( ak_int64 )r*g[i];
+     f[i-1] = ( ak_int32 )cf&ak_mpzn_signed30_mask; cf >>= 30;
+     g[i-1] = ( ak_int32 )cg&ak_mpzn_signed30_mask; cg >>= 30;
+  }
+  f[len-1] = ( ak_int32 )cf;
+  g[len-1] = ( ak_int32 )cg;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Приведение значения \f$ d \in (-2p, p) \f$, умноженного на знак sign, к интервалу
+    \f$ [0, p) \f$; все слова результата становятся неотрицательными 30-ти битными словами.        */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_normalize_30( ak_int32 *d, ak_int32 sign, ak_int32 *p, const size_t len )
+{
+  size_t i;
+  ak_int32 mask = d[len-1] >> 31;
+
+ /* d <- d + p, если d < 0; затем d <- -d, если sign < 0 */
+  for( i = 0; i < len; i++ ) d[i] += p[i]&mask;
+  mask = sign >> 31;
+  for( i = 0; i < len; i++ ) d[i] = ( d[i]^mask ) - mask;
+  for( i = 0; i < len-1; i++ ) { d[i+1] += d[i] >> 30; d[i] &= ak_mpzn_signed30_mask; }
+ /* d <- d + p, если d все еще отрицательно */
+  mask = d[len-1] >> 31;
+  for( i = 0; i < len; i++ ) d[i] += p[i]&mask;
+  for( i = 0; i < len-1; i++ ) { d[i+1] += d[i] >> 30; d[i] &= ak_mpzn_signed30_mask; }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет вычет \f$ z \f$, удовлетворяющий сравнению \f$ xz \equiv 1 \pmod{p} \f$,
+    с помощью алгоритма Д. Бернштейна и Б.-Я. Янга (safegcd, 2019), основанного на
+    последовательном применении шагов divstep к паре \f$ (f, g) = (p, x) \f$.
+    Шаги объединяются в группы по 30, для каждой группы по младшим словам f и g вычисляется
+    матрица перехода, которая затем применяется к значениям f, g и к коэффициентам
+    \f$ d, e \f$, удовлетворяющим сравнениям \f$ dx \equiv f, ex \equiv g \pmod{p} \f$.
+    Количество групп фиксировано и определяется только длиной модуля: для модуля длины
+    \f$ n \f$ бит достаточно \f$ \lfloor (49n + 57)/17 \rfloor + 1 \f$ шагов
+    (742 шага для 256-ти и 1480 шагов для 512-ти битных модулей),
+    после которых \f$ g = 0 \f$ и \f$ f = \pm 1 \f$. Вычисления не содержат ветвлений,
+    зависящих от значения x, поэтому время работы функции не зависит от обращаемого значения.
+
+    По сравнению с вычислением \f$ x^{p-2} \pmod{p} \f$ функция не использует умножений
+    по модулю p и требует в несколько раз меньшего времени.
+
+    @param z Вычет, в который помещается результат. Указатель на z может совпадать с указателем на x.
+    @param x Обращаемый вычет, удовлетворяющий неравенству \f$ 0 \leq x < p \f$; для \f$ x = 0 \f$
+    функция возвращает ноль.
+    @param p Нечетный модуль, взаимно простой с x (как правило, простое число).
+    @param size Размер модуля в словах (не более \ref ak_mpzn512_size).                            */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_inverse( ak_uint64 *z, ak_uint64 *x, ak_uint64 *p, const size_t size )
+{
+  size_t i, iterations, len = ( 64*size )/30 + 1;
+  ak_int32 d[ak_mpzn_signed30_size], e[ak_mpzn_signed30_size], f[ak_mpzn_signed30_size],
+           g[ak_mpzn_signed30_size], m[ak_mpzn_signed30_size], t[4], delta = 1;
+  ak_uint32 pinv = ( ak_uint32 )p[0];
+
+ /* pinv <- p^{-1} (mod 2^30); каждая итерация метода Ньютона удваивает число верных бит */
+  for( i = 0; i < 4; i++ ) pinv *= 2 - ( ak_uint32 )p[0]*pinv;
+  pinv &= ( ak_uint32 )ak_mpzn_signed30_mask;
+
+  ak_mpzn_to_signed30( m, len, p, size );
+  ak_mpzn_to_signed30( f, len, p, size );
+  ak_mpzn_to_signed30( g, len, x, size );
+  memset( d, 0, sizeof( d ));
+  memset( e, 0, sizeof( e ));
+  e[0] = 1;
+
+  iterations = (( 49*64*size + 57 )/17 + 30 )/30;
+  for( i = 0; i < iterations; i++ ) {
+     delta = ak_mpzn_divsteps_30( delta, ( ak_uint32 )f[0], ( ak_uint32 )g[0], t );
+     ak_mpzn_update_de_30( d, e, t, m, pinv, len );
+     ak_mpzn_update_fg_30( f, g, t, len );
+  }
+ /* теперь g = 0, f = 1 или f = -1, при этом dx = f (mod p) */
+  ak_mpzn_normalize_30( d, f[len-1], m, len );
+  ak_mpzn_from_signed30( z, size, d, len );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для вычета \f$ x \f$, заданного в представлении Монтгомери в виде \f$ x_0r \f$, функция
+    вычисляет вычет \f$ z \equiv x_0^{-1}r \pmod{p} \f$, то есть обратный вычет в представлении
+    Монтгомери. Обращение выполняется функцией ak_mpzn_inverse(), которая вычисляет
+    \f$ x_0^{-1}r^{-1} \f$; полученное значение дважды умножается на \f$ r^2 \f$.
+    Время работы функции не зависит от значения x.
+
+    @param z Вычет, в который помещается результат
+    @param x Обращаемый вычет
+    @param p Модуль, по которому производятся вычисления; нечетное простое число.
+    @param n0 Константа, используемая в вычислениях в представлении Монтгомери.
+    @param r2 Величина \f$ r^2 \pmod{p} \f$.
+    @param size Размер модуля в словах.                                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_inverse_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *p,
+                                              ak_uint64 n0, ak_uint64 *r2, const size_t size )
+{
+  ak_mpzn_inverse( z, x, p, size );
+  ak_mpzn_mul_montgomery( z, z, r2, p, n0, size );
+  ak_mpzn_mul_montgomery( z, z, r2, p, n0, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для набора вычетов \f$ x_0, \ldots, x_{c-1} \f$, заданных в представлении Монтгомери,
+    вычисляются обратные вычеты \f$ x_i^{-1} \pmod{p} \f$ (также в представлении Монтгомери).
+    Для этого вычисляется только одно обращение: если \f$ t_i = x_0 \cdots x_i \f$,
+    то \f$ x_i^{-1} = t_i^{-1}t_{i-1} \f$ и \f$ t_{i-1}^{-1} = t_i^{-1}x_i \f$ (прием Монтгомери).
+
+    @param x Массив из `count` вычетов, каждый из которых занимает `size` слов; вычеты
+    должны быть отличны от нуля. Результат помещается на место исходных значений.
+    @param t Временный массив того же размера, что и массив `x`.
+    @param count Количество вычетов.
+    @param p Модуль, по которому производятся вычисления; простое число.
+    @param n0 Константа, используемая в вычислениях в представлении Монтгомери.
+    @param r2 Величина \f$ r^2 \pmod{p} \f$.
+    @param size Размер модуля в словах.                                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_inverse_montgomery_batch( ak_uint64 *x, ak_uint64 *t, const size_t count,
+                                   ak_uint64 *p, ak_uint64 n0, ak_uint64 *r2, const size_t size )
+{
+  size_t i;
+  ak_mpznmax u, v;
+
+  if( !count ) return;
+  ak_mpzn_set( t, x, size );
+  for( i = 1; i < count; i++ )
+     ak_mpzn_mul_montgomery( t+i*size, t+(i-1)*size, x+i*size, p, n0, size );
+
+ /* u <- t_{count-1}^{-1} (mod p) */
+  ak_mpzn_inverse_montgomery( u, t+(count-1)*size, p, n0, r2, size );
+
+  for( i = count-1; i > 0; i-- ) {
+     ak_mpzn_mul_montgomery( v, u, t+(i-1)*size, p, n0, size );
+     ak_mpzn_mul_montgomery( u, u, x+i*size, p, n0, size );
+     ak_mpzn_set( x+i*size, v, size );
   }
-  memcpy( z, res, size*sizeof( ak_uint64 ));
+  ak_mpzn_set( x, u, size );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
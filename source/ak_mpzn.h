@@ -35,6 +35,15 @@
 /*! \brief Тип данных для хранения максимально возможного большого числа. */
  typedef ak_uint64 ak_mpznmax[ ak_mpznmax_size ];
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Способ вычисления степени в функции ak_mpzn_modpow_montgomery(). */
+ typedef enum {
+  /*! \brief Окна фиксированной длины; время вычислений не зависит от значения показателя. */
+   modpow_fixed_window,
+  /*! \brief Скользящие окна; используется только для открытых значений показателя. */
+   modpow_sliding_window
+} modpow_window_t;
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Присвоение вычету другого вычета. */
  void ak_mpzn_set( ak_uint64 *, ak_uint64 * , const size_t );
@@ -68,8 +77,12 @@
  ak_uint64 ak_mpzn_mul_ui( ak_uint64 *, ak_uint64 *, const size_t, const ak_uint64 );
 /*! \brief Умножение двух вычетов как целых чисел */
  void ak_mpzn_mul( ak_uint64 *, ak_uint64 *, ak_uint64 *, const size_t );
+/*! \brief Возведение вычета в квадрат как целого числа */
+ void ak_mpzn_sqr( ak_uint64 *, ak_uint64 *, const size_t );
 /*! \brief Вычисление остатка от деления одного вычета на другой */
  void ak_mpzn_rem( ak_uint64 *, ak_uint64 *, ak_uint64 *, const size_t );
+/*! \brief Вычисление остатка от деления методом Барретта */
+ void ak_mpzn_rem_barrett( ak_uint64 *, ak_uint64 *, ak_uint64 *, ak_uint64 *, const size_t );
 /*! \brief Вычисление остатка от деления вычета на одноразрядное число */
  ak_uint32 ak_mpzn_rem_uint32( ak_uint64 *, const size_t , ak_uint32 );
 
@@ -78,12 +91,32 @@
  void ak_mpzn_add_montgomery( ak_uint64 *, ak_uint64 *, ak_uint64 *, ak_uint64 *, const size_t );
 /*! \brief Удвоение на двойку в представлении Монтгомери. */
  void ak_mpzn_lshift_montgomery( ak_uint64 *, ak_uint64 *, ak_uint64 *, const size_t );
+/*! \brief Вычитание двух вычетов в представлении Монтгомери. */
+ void ak_mpzn_sub_montgomery( ak_uint64 *, ak_uint64 *, ak_uint64 *, ak_uint64 *, const size_t );
 /*! \brief Умножение двух вычетов в представлении Монтгомери. */
  void ak_mpzn_mul_montgomery( ak_uint64 *, ak_uint64 *, ak_uint64 *,
                                                           ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Возведение в квадрат в представлении Монтгомери. */
+ void ak_mpzn_sqr_montgomery( ak_uint64 *, ak_uint64 *, ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Тип функции приведения в представлении Монтгомери произведения длины 2size. */
+ typedef void ( ak_function_mpzn_redc )( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                                       ak_uint64, const size_t );
+/*! \brief Приведение в представлении Монтгомери по модулю вида \f$ p = 2^{64size} - c \f$. */
+ void ak_mpzn_redc_pseudo_mersenne( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                                       ak_uint64, const size_t );
+/*! \brief Выбор реализаций умножения в представлении Монтгомери для используемого процессора. */
+ bool_t ak_mpzn_set_montgomery_functions( bool_t );
 /*! \brief Модульное возведение в степень в представлении Монтгомери. */
  void ak_mpzn_modpow_montgomery( ak_uint64 *, ak_uint64 *, ak_uint64 *,
-                                                          ak_uint64 *, ak_uint64, const size_t );
+                                        ak_uint64 *, ak_uint64, const size_t , modpow_window_t );
+/*! \brief Обращение вычета (алгоритм Бернштейна-Янга, время работы не зависит от вычета). */
+ void ak_mpzn_inverse( ak_uint64 *, ak_uint64 *, ak_uint64 *, const size_t );
+/*! \brief Обращение вычета в представлении Монтгомери. */
+ void ak_mpzn_inverse_montgomery( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                ak_uint64, ak_uint64 *, const size_t );
+/*! \brief Одновременное обращение набора вычетов в представлении Монтгомери. */
+ void ak_mpzn_inverse_montgomery_batch( ak_uint64 *, ak_uint64 *, const size_t ,
+                                                ak_uint64 *, ak_uint64, ak_uint64 *, const size_t );
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef LIBAKRYPT_HAVE_GMP_H
 /*! \brief Преобразование ak_mpznxxx в mpz_t. */
@@ -30,9 +30,16 @@
 #ifdef _WIN32
  static const char *on_winrtl[] =           { "winrtl", NULL };
 #endif
+#ifdef LIBAKRYPT_HAVE_SYSRANDOM_H
+ static const char *on_getrandom[] =        { "getrandom", NULL };
+#endif
+#ifdef LIBAKRYPT_HAVE_SYSUN_H
+ static const char *on_unix_domain_socket[] = { "unix-domain-socket", NULL };
+#endif
 
 #ifdef LIBAKRYPT_CRYPTO_FUNCTIONS
  static const char *on_hashrnd[] =          { "hashrnd", NULL };
+ static const char *on_ctrrnd[] =           { "ctrrnd", "ctrrnd-kuznechik", NULL };
  static const char *on_streebog256[] =      { "streebog256", "md_gost12_256", NULL };
  static const char *on_streebog512[] =      { "streebog512", "md_gost12_512", NULL };
  static const char *on_hmac_streebog256[] = { "hmac-streebog256", "HMAC-md_gost12_256", NULL };
@@ -142,6 +149,20 @@
                                                 ( ak_function_void *) ak_random_context_destroy,
                                                  ( ak_function_void *) ak_random_context_delete }},
   #endif
+  #ifdef LIBAKRYPT_HAVE_SYSRANDOM_H
+   { random_generator, algorithm, on_getrandom, "1.2.643.2.52.1.1.7", NULL,
+           { sizeof( struct random ), ( ak_function_void *) ak_random_context_create_getrandom,
+                                                ( ak_function_void *) ak_random_context_destroy,
+                                                 ( ak_function_void *) ak_random_context_delete }},
+  #endif
+  #ifdef LIBAKRYPT_HAVE_SYSUN_H
+  /* генератор создается только функцией ak_random_context_create_unix_domain_socket(),
+     поскольку требует указания пути к сокету сервера */
+   { random_generator, algorithm, on_unix_domain_socket, "1.2.643.2.52.1.1.8", NULL,
+                                                        { sizeof( struct random ), NULL,
+                                                ( ak_function_void *) ak_random_context_destroy,
+                                                 ( ak_function_void *) ak_random_context_delete }},
+  #endif
   #ifdef _WIN32
    { random_generator, algorithm, on_winrtl, "1.2.643.2.52.1.1.4", NULL,
                { sizeof( struct random ), ( ak_function_void *) ak_random_context_create_winrtl,
@@ -154,6 +175,11 @@
                                                 ( ak_function_void *) ak_random_context_destroy,
                                                  ( ak_function_void *) ak_random_context_delete }},
 
+   { random_generator, algorithm, on_ctrrnd, "1.2.643.2.52.1.1.6", NULL,
+              { sizeof( struct random ), ( ak_function_void *) ak_random_context_create_ctrrnd,
+                                                ( ak_function_void *) ak_random_context_destroy,
+                                                 ( ak_function_void *) ak_random_context_delete }},
+
   /* 2. идентификаторы алгоритмов бесключевого хеширования,
         значения OID взяты из перечней КриптоПро и ТК26 (http://tk26.ru/methods/OID_TK_26/index.php)
         в дереве библиотеки: 1.2.643.2.52.1.2 - функции бесключевого хеширования */
@@ -26,6 +26,19 @@
 #ifdef LIBAKRYPT_HAVE_FCNTL_H
  #include <fcntl.h>
 #endif
+#ifdef LIBAKRYPT_HAVE_SYSRANDOM_H
+ #include <sys/random.h>
+#endif
+#ifdef LIBAKRYPT_HAVE_ERRNO_H
+ #include <errno.h>
+#endif
+#ifdef LIBAKRYPT_HAVE_SYSUN_H
+ #include <sys/un.h>
+ #include <sys/socket.h>
+#endif
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция устанавливает значение полей структуры struct random в значения по-умолчанию.
@@ -404,6 +417,569 @@
 }
 #endif
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                                реализация класса rng_getrandom                                  */
+/* ----------------------------------------------------------------------------------------------- */
+#ifdef LIBAKRYPT_HAVE_SYSRANDOM_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция заполняет заданную область памяти с помощью системного вызова getrandom().      */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_context_fill_getrandom( ak_uint8 *out, size_t size )
+{
+  ssize_t result = 0;
+
+  while( size > 0 ) {
+    if(( result = getrandom( out, size, 0 )) < 0 ) {
+      if( errno == EINTR ) continue;
+      return ak_error_message_fmt( ak_error_read_data, __func__ ,
+                                       "wrong call of getrandom() function (%s)", strerror( errno ));
+    }
+    out += result;
+    size -= ( size_t )result;
+  }
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Каждый запрос обрабатывается отдельным системным вызовом, значения нигде не сохраняются.
+    Поэтому один и тот же генератор может одновременно использоваться несколькими потоками,
+    а также родительским и дочерним процессами после вызова fork(), без риска выдачи
+    совпадающих последовательностей.                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_context_random_getrandom_unbuffered( ak_random rnd,
+                                                          const ak_pointer ptr, const ssize_t size )
+{
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "use a null pointer to a random generator" );
+  if( ptr == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                   "use a null pointer to data" );
+  if( size <= 0 ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                                 "use a data with wrong length" );
+ return ak_random_context_fill_getrandom( ptr, ( size_t )size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Размер буффера, заполняемого генератором getrandom за один системный вызов. */
+ #define ak_getrandom_buffer_size   (4096)
+
+/*! \brief Внутреннее состояние генератора, использующего системный вызов getrandom(). */
+ typedef struct getrandom_buffer {
+  /*! \brief Массив полученных от операционной системы значений */
+   ak_uint8 buffer[ak_getrandom_buffer_size];
+  /*! \brief Текущее количество доступных для выдачи октетов */
+   size_t len;
+  /*! \brief Идентификатор процесса, получившего значения, хранящиеся в буффере */
+   pid_t pid;
+ #ifdef LIBAKRYPT_HAVE_PTHREAD
+  /*! \brief Мьютекс, защищающий буффер при одновременном обращении нескольких потоков */
+   pthread_mutex_t mutex;
+ #endif
+ } *ak_getrandom_buffer;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Значения выдаются из внутреннего буффера, выданные октеты буффера сразу же обнуляются.
+    После исчерпания буффера он заполняется заново одним системным вызовом; запросы, длина
+    которых не меньше длины буффера, обрабатываются без его использования.
+
+    Процесс, порожденный с помощью fork(), не использует значения, полученные родительским
+    процессом: при первом обращении к генератору в порожденном процессе буффер очищается.          */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_context_random_getrandom( ak_random rnd,
+                                                          const ak_pointer ptr, const ssize_t size )
+{
+  ak_uint8 *inptr = ptr;
+  ssize_t realsize = size;
+  int error = ak_error_ok;
+  ak_getrandom_buffer gb = NULL;
+
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "use a null pointer to a random generator" );
+  if( ptr == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                   "use a null pointer to data" );
+  if( size <= 0 ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                                 "use a data with wrong length" );
+  gb = ( ak_getrandom_buffer ) rnd->data.ctx;
+
+ /* в порожденном процессе мьютекс может оказаться захваченным потоком родительского процесса,
+    поэтому он инициализируется заново вместе с очисткой буффера */
+  if( gb->pid != getpid( )) {
+   #ifdef LIBAKRYPT_HAVE_PTHREAD
+    pthread_mutex_init( &gb->mutex, NULL );
+   #endif
+    memset( gb->buffer, 0, sizeof( gb->buffer ));
+    gb->len = 0;
+    gb->pid = getpid();
+  }
+
+ #ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_lock( &gb->mutex );
+ #endif
+  while( realsize > 0 ) {
+    size_t offset = ak_min( (size_t)realsize, gb->len );
+    ak_uint8 *bufptr = gb->buffer + ( sizeof( gb->buffer ) - gb->len );
+
+    memcpy( inptr, bufptr, offset );
+    memset( bufptr, 0, offset );
+    inptr += offset;
+    realsize -= offset;
+    gb->len -= offset;
+    if( realsize == 0 ) break;
+
+   /* длинные запросы обрабатываются напрямую, короткие - через буффер */
+    if( realsize >= ( ssize_t ) sizeof( gb->buffer )) {
+      error = ak_random_context_fill_getrandom( inptr, ( size_t )realsize );
+      break;
+    }
+    if(( error = ak_random_context_fill_getrandom( gb->buffer,
+                                                        sizeof( gb->buffer ))) != ak_error_ok )
+      break;
+    gb->len = sizeof( gb->buffer );
+  }
+ #ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_unlock( &gb->mutex );
+ #endif
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_context_free_getrandom( ak_random rnd )
+{
+  ak_getrandom_buffer gb = NULL;
+
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "use a null pointer to a random generator" );
+  if(( gb = ( ak_getrandom_buffer ) rnd->data.ctx ) == NULL ) return ak_error_ok;
+ #ifdef LIBAKRYPT_HAVE_PTHREAD
+  if( gb->pid == getpid( )) pthread_mutex_destroy( &gb->mutex );
+ #endif
+  memset( gb, 0, sizeof( struct getrandom_buffer ));
+  free( gb );
+  rnd->data.ctx = NULL;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Генератор получает случайные значения от операционной системы с помощью системного
+    вызова getrandom() и не требует открытия файлов. В отличие от генератора /dev/urandom,
+    значения запрашиваются блоками по \ref ak_getrandom_buffer_size октетов, что позволяет
+    заменить большое количество коротких системных вызовов одним.
+
+    Доступ к буфферу защищен мьютексом, поэтому генератор может использоваться несколькими
+    потоками. В процессе, порожденном с помощью fork(), буффер очищается при первом обращении
+    к генератору; это обращение должно выполняться до создания в порожденном процессе других
+    потоков, использующих данный генератор. Для генератора, разделяемого всеми потоками
+    и процессами (например, генератора ключей менеджера контекстов), следует использовать
+    функцию ak_random_context_create_getrandom_unbuffered().
+
+    @param generator Контекст создаваемого генератора.
+    \return В случае успеха, функция возвращает \ref ak_error_ok. В противном случае
+            возвращается код ошибки.                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_random_context_create_getrandom( ak_random generator )
+{
+  int error = ak_error_ok;
+  ak_getrandom_buffer gb = NULL;
+
+  if(( error = ak_random_context_create( generator )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "wrong initialization of random generator" );
+
+  if(( gb = malloc( sizeof( struct getrandom_buffer ))) == NULL ) {
+    ak_random_context_destroy( generator );
+    return ak_error_message( ak_error_out_of_memory, __func__ ,
+                                              "incorrect memory allocation for internal buffer" );
+  }
+  memset( gb, 0, sizeof( struct getrandom_buffer ));
+  gb->pid = getpid();
+ #ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_init( &gb->mutex, NULL );
+ #endif
+
+  generator->oid = ak_oid_context_find_by_name("getrandom");
+  generator->data.ctx = gb;
+  generator->next = NULL;
+  generator->randomize_ptr = NULL;
+  generator->random = ak_random_context_random_getrandom;
+  generator->free = ak_random_context_free_getrandom;
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Генератор получает случайные значения от операционной системы с помощью системного
+    вызова getrandom(), выполняемого для каждого запроса. Генератор не имеет внутреннего
+    состояния, поэтому используется библиотекой в качестве генератора ключевой информации,
+    разделяемого всеми потоками и сохраняющегося после вызова fork().
+
+    @param generator Контекст создаваемого генератора.
+    \return В случае успеха, функция возвращает \ref ak_error_ok. В противном случае
+            возвращается код ошибки.                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_random_context_create_getrandom_unbuffered( ak_random generator )
+{
+  int error = ak_error_ok;
+  if(( error = ak_random_context_create( generator )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "wrong initialization of random generator" );
+
+  generator->oid = ak_oid_context_find_by_name("getrandom");
+  generator->next = NULL;
+  generator->randomize_ptr = NULL;
+  generator->random = ak_random_context_random_getrandom_unbuffered;
+
+ return error;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                         реализация класса rng_unix_domain_socket                                */
+/* ----------------------------------------------------------------------------------------------- */
+#ifdef LIBAKRYPT_HAVE_SYSUN_H
+/*! \brief Размер буффера генератора, использующего сокет домена unix, по-умолчанию. */
+ #define ak_uds_default_buffer_size   (65536)
+/*! \brief Максимальное количество октетов, запрашиваемых у сервера за одно обращение. */
+ #define ak_uds_max_request_size      (16384)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Внутреннее состояние генератора, получающего значения из сокета домена unix. */
+/*! \details Полученные от сервера значения хранятся в кольцевом буффере. Буффер пополняется
+    фоновым потоком, который обращается к серверу каждый раз, когда количество доступных
+    значений становится не больше величины `low`. Пользователь, как правило, получает значения
+    из буффера без обращения к серверу.                                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct uds_buffer {
+  /*! \brief Дескриптор сокета */
+   int fd;
+  /*! \brief Адрес сервера */
+   struct sockaddr_un addr;
+  /*! \brief Идентификатор процесса, установившего соединение с сервером */
+   pid_t pid;
+  /*! \brief Кольцевой буффер полученных от сервера значений */
+   ak_uint8 *buffer;
+  /*! \brief Размер буффера (в октетах) */
+   size_t size;
+  /*! \brief Смещение первого доступного октета */
+   size_t start;
+  /*! \brief Количество доступных октетов */
+   size_t len;
+  /*! \brief Граница, при достижении которой буффер пополняется */
+   size_t low;
+  /*! \brief Код ошибки, возникшей при обмене с сервером */
+   int error;
+ #ifdef LIBAKRYPT_HAVE_PTHREAD
+  /*! \brief Флаг завершения работы фонового потока */
+   bool_t stop;
+  /*! \brief Фоновый поток, пополняющий буффер */
+   pthread_t thread;
+  /*! \brief Мьютекс, защищающий поля `start`, `len`, `error` и `stop` */
+   pthread_mutex_t mutex;
+  /*! \brief Условие появления в буффере новых значений */
+   pthread_cond_t filled;
+  /*! \brief Условие необходимости пополнения буффера */
+   pthread_cond_t refill;
+ #endif
+ } *ak_uds_buffer;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция запрашивает у сервера `size` октетов и помещает их в заданную область памяти.
+    \details Запрос состоит из четырех октетов, содержащих длину запрашиваемых данных
+    (старший октет передается первым); в ответ сервер передает в точности запрошенное
+    количество октетов.
+    \return В случае успеха, функция возвращает \ref ak_error_ok. В противном случае
+            возвращается код ошибки (сообщение об ошибке не формируется).                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_context_request_uds( int fd, ak_uint8 *out, size_t size )
+{
+  ssize_t result = 0;
+  ak_uint8 request[4];
+
+  request[0] = ( ak_uint8 )( size >> 24 ); request[1] = ( ak_uint8 )( size >> 16 );
+  request[2] = ( ak_uint8 )( size >> 8 ); request[3] = ( ak_uint8 )size;
+  if( send( fd, request, sizeof( request ),
+ #ifdef MSG_NOSIGNAL
+                                            MSG_NOSIGNAL /* при закрытии сокета сервером */
+ #else
+                                            0
+ #endif
+                                                                   ) != sizeof( request ))
+    return ak_error_write_data;
+  while( size > 0 ) {
+    if(( result = read( fd, out, size )) <= 0 ) {
+      if(( result < 0 ) && ( errno == EINTR )) continue;
+      return ak_error_read_data;
+    }
+    out += result;
+    size -= ( size_t )result;
+  }
+ return ak_error_ok;
+}
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция фонового потока, пополняющего буффер генератора.
+    \details Значения считываются непосредственно в свободную часть кольцевого буффера, которая
+    не используется при выдаче значений, поэтому обмен с сервером выполняется без блокировки.      */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_random_context_thread_uds( void *ptr )
+{
+  ak_uds_buffer ub = ptr;
+  size_t tail = 0, count = 0;
+  int error = ak_error_ok;
+
+  pthread_mutex_lock( &ub->mutex );
+  while( !ub->stop ) {
+    if( ub->len > ub->low ) {
+      pthread_cond_wait( &ub->refill, &ub->mutex );
+      continue;
+    }
+   /* определяем непрерывный фрагмент свободной части буффера */
+    tail = ( ub->start + ub->len )%ub->size;
+    count = ak_min( ub->size - ub->len, ub->size - tail );
+    count = ak_min( count, ak_uds_max_request_size );
+    pthread_mutex_unlock( &ub->mutex );
+
+    error = ak_random_context_request_uds( ub->fd, ub->buffer + tail, count );
+
+    pthread_mutex_lock( &ub->mutex );
+    if( error != ak_error_ok ) {
+     /* при остановке потока обмен с сервером прерывается намеренно */
+      if( !ub->stop ) ak_error_message( error, __func__ , "wrong exchange with random server" );
+      ub->error = error;
+      pthread_cond_broadcast( &ub->filled );
+      break;
+    }
+    ub->len += count;
+    pthread_cond_broadcast( &ub->filled );
+  }
+  pthread_mutex_unlock( &ub->mutex );
+ return NULL;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция устанавливает соединение с сервером и запускает фоновый поток.
+    \details Функция вызывается при создании генератора, а также в процессе, порожденном
+    с помощью вызова fork(), при первом обращении к генератору. Идентификатор процесса
+    запоминается только после успешного запуска фонового потока.
+    \return В случае успеха, функция возвращает \ref ak_error_ok. В противном случае
+            возвращается код ошибки.                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_context_connect_uds( ak_uds_buffer ub )
+{
+  int error = ak_error_ok;
+
+  ub->start = 0;
+  ub->len = 0;
+  ub->error = ak_error_ok;
+  if((( ub->fd = socket( AF_UNIX, SOCK_STREAM, 0 )) == -1 ) ||
+     ( connect( ub->fd, ( struct sockaddr *)&ub->addr, sizeof( ub->addr )) == -1 )) {
+    ak_error_message_fmt( error = ak_error_open_file, __func__ ,
+                                        "wrong connection to random server \"%s\" (%s)",
+                                                           ub->addr.sun_path, strerror( errno ));
+    if( ub->fd != -1 ) close( ub->fd );
+    ub->fd = -1;
+    return error;
+  }
+
+ /* запускаем фоновый поток, который сразу же заполняет буффер */
+ #ifdef LIBAKRYPT_HAVE_PTHREAD
+  ub->stop = ak_false;
+  pthread_mutex_init( &ub->mutex, NULL );
+  pthread_cond_init( &ub->filled, NULL );
+  pthread_cond_init( &ub->refill, NULL );
+  if( pthread_create( &ub->thread, NULL, ak_random_context_thread_uds, ub ) != 0 ) {
+    pthread_cond_destroy( &ub->filled );
+    pthread_cond_destroy( &ub->refill );
+    pthread_mutex_destroy( &ub->mutex );
+    close( ub->fd );
+    ub->fd = -1;
+    return ak_error_message( ak_error_undefined_function, __func__ ,
+                                                      "wrong creation of background thread" );
+  }
+ #endif
+  ub->pid = getpid();
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Значения выдаются из кольцевого буффера, выданные октеты буффера сразу же обнуляются.
+    Если доступных значений недостаточно, функция ожидает пополнения буффера фоновым потоком
+    (при отсутствии поддержки потоков буффер пополняется непосредственно из данной функции).       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_context_random_uds( ak_random rnd, const ak_pointer ptr, const ssize_t size )
+{
+  ak_uint8 *outptr = ptr;
+  ak_uds_buffer ub = NULL;
+  size_t count = 0, realsize = ( size_t )size;
+  int error = ak_error_ok;
+
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "use a null pointer to a random generator" );
+  if( ptr == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                   "use a null pointer to data" );
+  if( size <= 0 ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                                 "use a data with wrong length" );
+  ub = ( ak_uds_buffer ) rnd->data.ctx;
+
+ /* процесс, порожденный с помощью fork(), не должен использовать значения, полученные
+    родительским процессом: буффер очищается, соединение и фоновый поток создаются заново */
+  if( ub->pid != getpid( )) {
+    if( ub->fd != -1 ) close( ub->fd );
+    memset( ub->buffer, 0, ub->size );
+    if(( error = ak_random_context_connect_uds( ub )) != ak_error_ok )
+      return ak_error_message( error, __func__ , "wrong reconnection to random server" );
+  }
+
+ #ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_lock( &ub->mutex );
+ #endif
+  while( realsize > 0 ) {
+    if( ub->len == 0 ) {
+      if(( error = ub->error ) != ak_error_ok ) break;
+     #ifdef LIBAKRYPT_HAVE_PTHREAD
+      pthread_cond_signal( &ub->refill );
+      pthread_cond_wait( &ub->filled, &ub->mutex );
+     #else
+      count = ak_min( ub->size, ak_uds_max_request_size );
+      if(( error = ub->error = ak_random_context_request_uds( ub->fd,
+                                                         ub->buffer, count )) != ak_error_ok ) break;
+      ub->start = 0;
+      ub->len = count;
+     #endif
+      continue;
+    }
+    count = ak_min( realsize, ak_min( ub->len, ub->size - ub->start ));
+    memcpy( outptr, ub->buffer + ub->start, count );
+    memset( ub->buffer + ub->start, 0, count );
+    outptr += count;
+    realsize -= count;
+    ub->start = ( ub->start + count )%ub->size;
+    ub->len -= count;
+  }
+ #ifdef LIBAKRYPT_HAVE_PTHREAD
+  if( ub->len <= ub->low ) pthread_cond_signal( &ub->refill );
+  pthread_mutex_unlock( &ub->mutex );
+ #endif
+
+  if( error != ak_error_ok ) return ak_error_message( error, __func__ ,
+                                                     "wrong receiving data from random server" );
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_context_free_uds( ak_random rnd )
+{
+  ak_uds_buffer ub = NULL;
+
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "use a null pointer to a random generator" );
+  if(( ub = ( ak_uds_buffer ) rnd->data.ctx ) == NULL ) return ak_error_ok;
+
+ /* останавливаем фоновый поток; прерываем возможный обмен с сервером;
+    в порожденном процессе, не обращавшемся к генератору, фоновый поток отсутствует,
+    а унаследованный сокет используется родительским процессом и только закрывается */
+ #ifdef LIBAKRYPT_HAVE_PTHREAD
+  if( ub->pid == getpid( )) {
+    pthread_mutex_lock( &ub->mutex );
+    ub->stop = ak_true;
+    pthread_cond_signal( &ub->refill );
+    pthread_mutex_unlock( &ub->mutex );
+    shutdown( ub->fd, SHUT_RDWR );
+    pthread_join( ub->thread, NULL );
+    pthread_cond_destroy( &ub->filled );
+    pthread_cond_destroy( &ub->refill );
+    pthread_mutex_destroy( &ub->mutex );
+  }
+ #endif
+  if(( ub->fd != -1 ) && ( close( ub->fd ) == -1 ))
+    ak_error_message( ak_error_close_file, __func__ , "wrong closing a socket with random data" );
+
+  memset( ub->buffer, 0, ub->size );
+  free( ub->buffer );
+  memset( ub, 0, sizeof( struct uds_buffer ));
+  free( ub );
+  rnd->data.ctx = NULL;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Генератор получает значения от сервера, доступного через сокет домена unix. Для каждого
+    запроса клиент передает серверу четыре октета, содержащие длину запрашиваемых данных
+    (старший октет передается первым), в ответ сервер передает запрошенное количество октетов.
+
+    Значения, полученные от сервера, хранятся в кольцевом буффере. Фоновый поток пополняет
+    буффер заранее, каждый раз, когда в нем остается не более четверти его длины, поэтому
+    выработка значений, как правило, не включает в себя обмен с сервером.
+
+    Фоновый поток не наследуется процессом, порожденным с помощью вызова fork(), а содержимое
+    буффера совпадает с содержимым буффера родительского процесса. Поэтому при первом обращении
+    к генератору в порожденном процессе буффер очищается, соединение с сервером устанавливается
+    заново и запускается новый фоновый поток. Первое обращение должно выполняться до создания
+    в порожденном процессе других потоков, использующих данный генератор.
+
+    Генератору соответствует идентификатор "unix-domain-socket"; поскольку для создания
+    генератора необходим путь к сокету, генератор не может быть создан с помощью функции
+    ak_random_context_create_oid().
+
+    @param generator Контекст создаваемого генератора.
+    @param path Путь к сокету сервера.
+    @param size Размер буффера в октетах; при нулевом или отрицательном значении используется
+    размер по-умолчанию (64 Кб).
+    \return В случае успеха, функция возвращает \ref ak_error_ok. В противном случае
+            возвращается код ошибки.                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_random_context_create_unix_domain_socket( ak_random generator,
+                                                                const char *path, ssize_t size )
+{
+  ak_uds_buffer ub = NULL;
+  int error = ak_error_ok;
+
+  if( path == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                              "use a null pointer to socket path" );
+  if( strlen( path ) >= sizeof( ub->addr.sun_path ))
+    return ak_error_message( ak_error_wrong_length, __func__ , "using a very long socket path" );
+  if(( error = ak_random_context_create( generator )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "wrong initialization of random generator" );
+
+  if(( ub = malloc( sizeof( struct uds_buffer ))) == NULL ) {
+    ak_random_context_destroy( generator );
+    return ak_error_message( ak_error_out_of_memory, __func__ ,
+                                          "incorrect memory allocation for internal variables" );
+  }
+  memset( ub, 0, sizeof( struct uds_buffer ));
+  ub->fd = -1;
+  ub->size = ( size > 0 ) ? ( size_t )size : ak_uds_default_buffer_size;
+  ub->low = ub->size >> 2;
+  if(( ub->buffer = malloc( ub->size )) == NULL ) {
+    free( ub );
+    ak_random_context_destroy( generator );
+    return ak_error_message( ak_error_out_of_memory, __func__ ,
+                                              "incorrect memory allocation for internal buffer" );
+  }
+  memset( ub->buffer, 0, ub->size );
+
+ /* устанавливаем соединение с сервером и запускаем фоновый поток */
+  ub->addr.sun_family = AF_UNIX;
+  strncpy( ub->addr.sun_path, path, sizeof( ub->addr.sun_path ) - 1 );
+  if(( error = ak_random_context_connect_uds( ub )) != ak_error_ok ) {
+    free( ub->buffer );
+    free( ub );
+    ak_random_context_destroy( generator );
+    return error;
+  }
+
+  generator->oid = ak_oid_context_find_by_name("unix-domain-socket");
+  generator->data.ctx = ub;
+  generator->next = NULL;
+  generator->randomize_ptr = NULL;
+  generator->random = ak_random_context_random_uds;
+  generator->free = ak_random_context_free_uds;
+
+ return error;
+}
+#endif
+
 /* ----------------------------------------------------------------------------------------------- */
 /*                                 реализация класса rng_winrtl                                    */
 /* ----------------------------------------------------------------------------------------------- */
@@ -484,6 +1060,7 @@
 /*!  \example test-random01.c                                                                      */
 /*!  \example test-random02.c                                                                      */
 /*!  \example test-random03.c                                                                      */
+/*!  \example test-random04.c                                                                      */
 /* ----------------------------------------------------------------------------------------------- */
 /*                                                                                    ak_random.c  */
 /* ----------------------------------------------------------------------------------------------- */
@@ -78,6 +78,12 @@
 /*! \brief Инициализация контекста генератора, считывающего случайные значения из /dev/urandom. */
  int ak_random_context_create_urandom( ak_random );
 #endif
+#ifdef LIBAKRYPT_HAVE_SYSRANDOM_H
+/*! \brief Инициализация контекста генератора, получающего случайные значения с помощью системного вызова getrandom(). */
+ int ak_random_context_create_getrandom( ak_random );
+/*! \brief Инициализация контекста генератора, выполняющего системный вызов getrandom() для каждого запроса. */
+ int ak_random_context_create_getrandom_unbuffered( ak_random );
+#endif
 #ifdef _WIN32
 /*! \brief Инициализация контекста, реализующего интерфейс доступа к генератору псевдо-случайных чисел, предоставляемому ОС Windows. */
  int ak_random_context_create_winrtl( ak_random );
@@ -87,6 +93,8 @@
  int ak_random_context_create_hashrnd( ak_random );
 /*! \brief Инициализация контекста генератора, основанного на применении функции хеширования, определяемой по ее идентификатору. */
  int ak_random_context_create_hashrnd_oid( ak_random , ak_oid );
+/*! \brief Инициализация контекста генератора, основанного на применении блочного шифра Кузнечик в режиме гаммирования. */
+ int ak_random_context_create_ctrrnd( ak_random );
 #endif
 #ifdef LIBAKRYPT_HAVE_SYSUN_H
 /*! \brief Инициализация контекста генератора, считывающего случайные значения из сокета домена unix. */
@@ -23,6 +23,9 @@
 #ifdef LIBAKRYPT_HAVE_TIME_H
  #include <time.h>
 #endif
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Установление или изменение маски секретного ключа ассиметричного криптографического
@@ -51,7 +54,7 @@
 #ifndef LIBAKRYPT_LITTLE_ENDIAN
   int i = 0;
 #endif
-  ak_mpznmax u, zeta;
+  ak_mpznmax zeta;
   ak_wcurve wc = NULL;
   int error = ak_error_ok;
   ak_uint64 *key = NULL, *mask = NULL;
@@ -86,19 +89,16 @@
 #endif
 
     /* приводим случайное число по модулю q и сразу считаем, что это число в представлении Монтгомери */
-     ak_mpzn_rem( mask, mask, wc->q, wc->size );
+     ak_mpzn_rem_q( mask, mask, wc );
 
     /* приводим значение ключа по модулю q, а потом переводим в представление Монтгомери
        при этом мы предполагаем, что значение ключа установлено в естественном представлении */
-     ak_mpzn_rem( key, key, wc->q, wc->size );
+     ak_mpzn_rem_q( key, key, wc );
      ak_mpzn_mul_montgomery( key, key, wc->r2q, wc->q, wc->nq, wc->size);
      ak_mpzn_mul_montgomery( key, key, mask, wc->q, wc->nq, wc->size);
 
     /* вычисляем обратное значение для маски */
-     ak_mpzn_set_ui( u, wc->size, 2 );
-     ak_mpzn_sub( u, wc->q, u, wc->size );
-     ak_mpzn_modpow_montgomery( mask, // m <- m^{q-2} (mod q)
-                                    mask, u, wc->q, wc->nq, wc->size );
+     ak_mpzn_inverse_montgomery( mask, mask, wc->q, wc->nq, wc->r2q, wc->size ); // m <- m^{-1}
     /* меняем значение флага */
      skey->flags |= ak_key_flag_set_mask;
 
@@ -110,14 +110,12 @@
        return ak_error_message( error, __func__ , "wrong mask generation for key buffer" );
 
     /* приводим случайное число по модулю q и сразу считаем, что это число в представлении Монтгомери */
-     ak_mpzn_rem( zeta, zeta, wc->q, wc->size );
+     ak_mpzn_rem_q( zeta, zeta, wc );
 
     /* домножаем ключ на случайное число */
      ak_mpzn_mul_montgomery( key, key, zeta, wc->q, wc->nq, wc->size );
     /* вычисляем обратное значение zeta */
-     ak_mpzn_set_ui( u, wc->size, 2 );
-     ak_mpzn_sub( u, wc->q, u, wc->size );
-     ak_mpzn_modpow_montgomery( zeta, zeta, u, wc->q, wc->nq, wc->size ); // z <- z^{q-2} (mod q)
+     ak_mpzn_inverse_montgomery( zeta, zeta, wc->q, wc->nq, wc->r2q, wc->size ); // z <- z^{-1}
 
     /* домножаем маску на обратное значение zeta */
      ak_mpzn_mul_montgomery( mask, mask, zeta, wc->q, wc->nq, wc->size );
@@ -424,6 +422,8 @@
   int error = ak_error_ok;
   if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
                            "destroying a null pointer to digital signature secret key context" );
+  if(( error = ak_signkey_context_destroy_pool( sctx )) != ak_error_ok )
+    ak_error_message( error, __func__ , "incorrect destroying of precomputed values pool" );
   if(( error = ak_skey_context_destroy( &sctx->key )) != ak_error_ok )
     ak_error_message( error, __func__ , "incorrect destroying of digital signature secret key" );
   if(( error = ak_hash_context_destroy( &sctx->ctx )) != ak_error_ok )
@@ -573,6 +573,33 @@
  return ak_tlv_context_add_string_to_global_name( sk->name, ni, string );
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет значение \f$ s \equiv rd \pmod{q} \f$, где \f$ d \f$ секретный ключ. */
+/*! Ключ хранится в маскированном виде, поэтому вычет \f$ r \f$, переведенный в представление
+    Монтгомери, сначала домножается на ключ, а потом на его маску. Результат возвращается
+    в обычной форме.
+
+    @param sctx Контекст секретного ключа алгоритма электронной подписи.
+    @param s Вычет, в который помещается результат.
+    @param r Вычет \f$ r \f$ в обычной форме, приведенный по модулю \f$ q \f$.                     */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_signkey_context_mul_key( ak_signkey sctx, ak_uint64 *s, ak_uint64 *r )
+{
+  ak_mpzn512 t;
+  ak_wcurve wc = ( ak_wcurve ) sctx->key.data;
+
+ /* приводим r к виду Монтгомери */
+  ak_mpzn_mul_montgomery( t, r, wc->r2q, wc->q, wc->nq, wc->size );
+ /* домножаем на ключ и на его маску */
+  ak_mpzn_mul_montgomery( s, t, (ak_uint64 *)sctx->key.key, wc->q, wc->nq, wc->size );
+  ak_mpzn_mul_montgomery( s, s,
+              (ak_uint64 *)(sctx->key.key+sctx->key.key_size), wc->q, wc->nq, wc->size );
+ /* приводим s к обычной форме */
+  ak_mpzn_mul_montgomery( s, s,  wc->point.z, /* для экономии памяти пользуемся равенством z = 1 */
+                                 wc->q, wc->nq, wc->size );
+  memset( t, 0, sizeof( ak_mpzn512 ));
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция вырабатывает электронную подпись для \f$ e \f$ - вычисленного хеш-кода подписываемого
     сообщения и заданного случайного числа \f$ k \f$. Для этого
@@ -616,33 +643,21 @@
 
  /* поскольку функция не экспортируется, мы оставляем все проверки функциям верхнего уровня */
  /* вычисляем r */
-  ak_wpoint_pow( &wr, &wc->point, k, wc->size, wc );
+  ak_wpoint_pow_base( &wr, k, wc );
   ak_wpoint_reduce( &wr, wc );
-  ak_mpzn_rem( r, wr.x, wc->q, wc->size );
+  ak_mpzn_rem_q( r, wr.x, wc );
 
- /* приводим r к виду Монтгомери и помещаем во временную переменную wr.x <- r */
-  ak_mpzn_mul_montgomery( wr.x, r, wc->r2q, wc->q, wc->nq, wc->size );
+ /* вычисляем значение s <- r*d (mod q) */
+  ak_signkey_context_mul_key( sctx, s, r );
 
- /* вычисляем значение s <- r*d (mod q) (сначала домножаем на ключ, потом на его маску) */
-  ak_mpzn_mul_montgomery( s, wr.x, (ak_uint64 *)sctx->key.key, wc->q, wc->nq, wc->size );
-  ak_mpzn_mul_montgomery( s, s,
-              (ak_uint64 *)(sctx->key.key+sctx->key.key_size), wc->q, wc->nq, wc->size );
-
- /* приводим k к виду Монтгомери и помещаем во временную переменную wr.y <- k */
-  ak_mpzn_mul_montgomery( wr.y, k, wc->r2q, wc->q, wc->nq, wc->size );
-
- /* приводим e к виду Монтгомери и помещаем во временную переменную wr.z <- e */
-  ak_mpzn_rem( wr.z, e, wc->q, wc->size );
+ /* приводим e по модулю q и помещаем во временную переменную wr.z <- e */
+  ak_mpzn_rem_q( wr.z, e, wc );
   if( ak_mpzn_cmp_ui( wr.z, wc->size, 0 )) ak_mpzn_set_ui( wr.z, wc->size, 1 );
-  ak_mpzn_mul_montgomery( wr.z, wr.z, wc->r2q, wc->q, wc->nq, wc->size );
 
- /* вычисляем k*e (mod q) и вычисляем s = r*d + k*e (mod q) (в форме Монтгомери) */
-  ak_mpzn_mul_montgomery( wr.y, wr.y, wr.z, wc->q, wc->nq, wc->size ); /* wr.y <- k*e */
+ /* вычисляем k*e (mod q) методом Барретта и вычисляем s = r*d + k*e (mod q) */
+  ak_mpzn_mulmod_q( wr.y, k, wr.z, wc ); /* wr.y <- k*e */
   ak_mpzn_add_montgomery( s, s, wr.y, wc->q, wc->size );
 
- /* приводим s к обычной форме */
-  ak_mpzn_mul_montgomery( s, s,  wc->point.z, /* для экономии памяти пользуемся равенством z = 1 */
-                                 wc->q, wc->nq, wc->size );
  /* экспортируем результат */
   ak_mpzn_to_little_endian( s, wc->size, out, sizeof(ak_uint64)*wc->size, ak_true );
   ak_mpzn_to_little_endian( r, wc->size, (ak_uint64 *)out + wc->size,
@@ -654,6 +669,437 @@
   memset( s, 0, sizeof( ak_mpzn512 ));
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                      функции для работы с пулом заранее вычисленных пар                         */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Пул заранее вычисленных пар \f$ (k, r) \f$, используемых при выработке подписи.
+
+    Для каждой пары хранятся три вычета по `size` 64-х битных слов: значение \f$ k\mu \f$
+    и маска \f$ \mu^{-1} \f$ в представлении Монтгомери по модулю \f$ q \f$, где \f$ \mu \f$
+    случайный вычет, вырабатываемый отдельно для каждой пары, а также значение
+    \f$ r \equiv x_C \pmod{q} \f$, где \f$ C = [k]P \f$. Таким образом, значение \f$ k \f$
+    хранится в маскированном виде, так же как и секретный ключ.
+
+    Значения \f$ k \f$ и маски вырабатываются собственным генератором пула, обращения к
+    которому из потока, пополняющего пул, и из функции ak_signkey_context_refill_pool()
+    упорядочиваются отдельным мьютексом.                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ struct signkey_pool {
+  /*! \brief Массив пар */
+   ak_uint64 *values;
+  /*! \brief Эллиптическая кривая, на которой вычисляются точки \f$ [k]P \f$ */
+   ak_wcurve wc;
+  /*! \brief Генератор, используемый для выработки значений \f$ k \f$ и масок */
+   struct random generator;
+  /*! \brief Максимальное количество пар в пуле */
+   size_t capacity;
+  /*! \brief Текущее количество пар в пуле */
+   size_t count;
+  /*! \brief Флаг использования потока, пополняющего пул */
+   bool_t background;
+  /*! \brief Флаг завершения работы потока, пополняющего пул */
+   bool_t stop;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  /*! \brief Мьютекс, защищающий массив пар */
+   pthread_mutex_t mutex;
+  /*! \brief Условная переменная, сигнализирующая потоку о необходимости пополнения пула */
+   pthread_cond_t cond;
+  /*! \brief Поток, пополняющий пул */
+   pthread_t thread;
+  /*! \brief Мьютекс, упорядочивающий обращения к генератору пула */
+   pthread_mutex_t rnd_mutex;
+#endif
+};
+
+/*! \brief Количество 64-х битных слов, занимаемых в пуле одной парой. */
+ #define ak_signkey_pool_item_size( size )  ( 3*( size ))
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет одну пару \f$ (k, r) \f$ и маскирует значение \f$ k \f$.
+
+    Случайные значения \f$ k \f$ и \f$ \mu \f$ вырабатываются генератором пула; на время
+    обращения к генератору устанавливается блокировка, вычисление точки \f$ [k]P \f$
+    выполняется без блокировки.
+
+    @param item Массив, в который помещается пара; должен содержать
+    `ak_signkey_pool_item_size( wc->size )` слов.
+    @param pool Пул, для которого вычисляется пара.
+    @return В случае успеха функция возвращает ноль (\ref ak_error_ok). В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_signkey_pool_set_item( ak_uint64 *item, ak_signkey_pool pool )
+{
+  ak_mpzn512 k, mu;
+  struct wpoint wr;
+  int error = ak_error_ok;
+  const ak_wcurve wc = pool->wc;
+  const size_t size = wc->size;
+
+  memset( k, 0, sizeof( ak_mpzn512 ));
+  memset( mu, 0, sizeof( ak_mpzn512 ));
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_lock( &pool->rnd_mutex );
+#endif
+  if(( error = ak_mpzn_set_random_modulo( k, wc->q, size, &pool->generator )) == ak_error_ok )
+    error = ak_mpzn_set_random_modulo( mu, wc->q, size, &pool->generator );
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_unlock( &pool->rnd_mutex );
+#endif
+  if( error != ak_error_ok ) {
+    memset( k, 0, sizeof( ak_mpzn512 ));
+    return ak_error_message( error, __func__ , "invalid generation of random value");
+  }
+  if( ak_mpzn_cmp_ui( mu, size, 0 )) ak_mpzn_set_ui( mu, size, 1 );
+
+ /* вычисляем r */
+  ak_wpoint_pow_base( &wr, k, wc );
+  ak_wpoint_reduce( &wr, wc );
+  ak_mpzn_rem_q( item+2*size, wr.x, wc );
+
+ /* маскируем k: случайный вычет mu сразу считаем записанным в представлении Монтгомери */
+  ak_mpzn_mul_montgomery( k, k, wc->r2q, wc->q, wc->nq, size );
+  ak_mpzn_mul_montgomery( item, k, mu, wc->q, wc->nq, size );
+  ak_mpzn_inverse_montgomery( item+size, mu, wc->q, wc->nq, wc->r2q, size );
+
+  memset( &wr, 0, sizeof( struct wpoint ));
+  memset( k, 0, sizeof( ak_mpzn512 ));
+  memset( mu, 0, sizeof( ak_mpzn512 ));
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция пополняет пул до максимального количества пар.
+
+    Пары вычисляются без блокировки пула, блокировка устанавливается только на время
+    помещения вычисленной пары в массив, поэтому пополнение пула может выполняться
+    одновременно с выработкой подписей.                                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_signkey_pool_refill( ak_signkey_pool pool )
+{
+  bool_t full = ak_false;
+  int error = ak_error_ok;
+  ak_uint64 item[ak_signkey_pool_item_size( ak_mpzn512_size )];
+  const size_t len = ak_signkey_pool_item_size( pool->wc->size );
+
+  while( !full ) {
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+     pthread_mutex_lock( &pool->mutex );
+#endif
+     full = ( pool->count >= pool->capacity ) || pool->stop;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+     pthread_mutex_unlock( &pool->mutex );
+#endif
+     if( full ) break;
+     if(( error = ak_signkey_pool_set_item( item, pool )) != ak_error_ok ) break;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+     pthread_mutex_lock( &pool->mutex );
+#endif
+     if( pool->count < pool->capacity ) {
+       memcpy( pool->values + pool->count*len, item, len*sizeof( ak_uint64 ));
+       pool->count++;
+     }
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+     pthread_mutex_unlock( &pool->mutex );
+#endif
+  }
+  memset( item, 0, sizeof( item ));
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция извлекает из пула одну пару.
+    @return Функция возвращает \ref ak_true, если пара извлечена, и \ref ak_false,
+    если пул пуст.                                                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_signkey_pool_take( ak_signkey_pool pool, ak_uint64 *item )
+{
+  bool_t result = ak_false;
+  const size_t len = ak_signkey_pool_item_size( pool->wc->size );
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_lock( &pool->mutex );
+#endif
+  if( pool->count > 0 ) {
+    pool->count--;
+    memcpy( item, pool->values + pool->count*len, len*sizeof( ak_uint64 ));
+    memset( pool->values + pool->count*len, 0, len*sizeof( ak_uint64 ));
+    result = ak_true;
+  }
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  if( pool->background ) pthread_cond_signal( &pool->cond );
+  pthread_mutex_unlock( &pool->mutex );
+#endif
+ return result;
+}
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция потока, пополняющего пул после извлечения из него пар. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_signkey_pool_thread( void *ptr )
+{
+  ak_signkey_pool pool = ( ak_signkey_pool ) ptr;
+
+  pthread_mutex_lock( &pool->mutex );
+  while( !pool->stop ) {
+    if( pool->count >= pool->capacity ) {
+      pthread_cond_wait( &pool->cond, &pool->mutex );
+      continue;
+    }
+    pthread_mutex_unlock( &pool->mutex );
+    if( ak_signkey_pool_refill( pool ) != ak_error_ok ) {
+     /* при ошибке генератора поток завершается, подписи вырабатываются без пула */
+      pthread_mutex_lock( &pool->mutex );
+      break;
+    }
+    pthread_mutex_lock( &pool->mutex );
+  }
+  pthread_mutex_unlock( &pool->mutex );
+ return NULL;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция создает генератор, принадлежащий пулу.
+
+    Используется тот же источник случайности, что и для генератора ключей менеджера контекстов,
+    однако каждый пул владеет собственным экземпляром генератора.                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_signkey_pool_create_generator( ak_random generator )
+{
+#ifdef LIBAKRYPT_HAVE_SYSRANDOM_H
+ return ak_random_context_create_getrandom( generator );
+#elif defined(__unix__) || defined(__APPLE__)
+ return ak_random_context_create_urandom( generator );
+#elif defined(_WIN32)
+ return ak_random_context_create_winrtl( generator );
+#else
+ return ak_error_message( ak_error_undefined_function, __func__,
+                                                "system random number generator is not supported" );
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция создает пул, в котором хранятся заранее вычисленные пары \f$ (k, r) \f$, где
+    \f$ k \f$ случайный вычет по модулю \f$ q \f$, а \f$ r \f$ есть x-координата точки
+    \f$ [k]P \f$, приведенная по модулю \f$ q \f$. При выработке подписи функцией
+    ak_signkey_context_sign_hash() пара извлекается из пула, поэтому вычисление кратной
+    точки, занимающее основную часть времени выработки подписи, выполняется заранее,
+    а выработка подписи сводится к нескольким умножениям по модулю \f$ q \f$.
+    Если пул пуст, подпись вырабатывается обычным образом. Каждая пара используется
+    только один раз и удаляется из пула после извлечения.
+
+    Пул пополняется вызовом функции ak_signkey_context_refill_pool() либо, если значение
+    `background` истинно, отдельным потоком, который пополняет пул после каждого извлечения
+    из него пары. Значения \f$ k \f$ хранятся в маскированном виде и вырабатываются
+    собственным генератором пула, который создается данной функцией.
+
+    @param sctx Контекст секретного ключа алгоритма электронной подписи.
+    @param capacity Максимальное количество пар в пуле.
+    @param background Флаг создания потока, пополняющего пул.
+    @return В случае успеха возвращается ноль (\ref ak_error_ok). В противном случае возвращается
+    код ошибки.                                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_signkey_context_create_pool( ak_signkey sctx, const size_t capacity, bool_t background )
+{
+  ak_signkey_pool pool = NULL;
+  ak_wcurve wc = NULL;
+  int error = ak_error_ok;
+
+  if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                      "using null pointer to secret key context" );
+  if(( wc = ( ak_wcurve ) sctx->key.data ) == NULL )
+    return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                 "using internal null pointer to elliptic curve" );
+  if( !capacity ) return ak_error_message( ak_error_zero_length, __func__,
+                                                                    "using pool with zero size" );
+  if( sctx->pool != NULL ) return ak_error_message( ak_error_undefined_value, __func__,
+                                                                   "pool is already created" );
+#ifndef LIBAKRYPT_HAVE_PTHREAD
+  if( background ) return ak_error_message( ak_error_undefined_function, __func__,
+                                                     "library is compiled without thread support" );
+#endif
+  if(( pool = calloc( 1, sizeof( struct signkey_pool ))) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+  if(( pool->values = calloc( capacity,
+                      ak_signkey_pool_item_size( wc->size )*sizeof( ak_uint64 ))) == NULL ) {
+    free( pool );
+    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+  }
+  if(( error = ak_signkey_pool_create_generator( &pool->generator )) != ak_error_ok ) {
+    free( pool->values );
+    free( pool );
+    return ak_error_message( error, __func__, "wrong creation of pool random generator" );
+  }
+  pool->wc = wc;
+  pool->capacity = capacity;
+  pool->count = 0;
+  pool->background = ak_false;
+  pool->stop = ak_false;
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  if( pthread_mutex_init( &pool->mutex, NULL ) != 0 ) {
+    ak_random_context_destroy( &pool->generator );
+    free( pool->values );
+    free( pool );
+    return ak_error_message( ak_error_undefined_value, __func__ , "wrong initialization of mutex" );
+  }
+  if( pthread_mutex_init( &pool->rnd_mutex, NULL ) != 0 ) {
+    pthread_mutex_destroy( &pool->mutex );
+    ak_random_context_destroy( &pool->generator );
+    free( pool->values );
+    free( pool );
+    return ak_error_message( ak_error_undefined_value, __func__ , "wrong initialization of mutex" );
+  }
+  if( pthread_cond_init( &pool->cond, NULL ) != 0 ) {
+    pthread_mutex_destroy( &pool->rnd_mutex );
+    pthread_mutex_destroy( &pool->mutex );
+    ak_random_context_destroy( &pool->generator );
+    free( pool->values );
+    free( pool );
+    return ak_error_message( ak_error_undefined_value, __func__ ,
+                                                 "wrong initialization of condition variable" );
+  }
+  if( background ) {
+    if( pthread_create( &pool->thread, NULL, ak_signkey_pool_thread, pool ) != 0 ) {
+      pthread_cond_destroy( &pool->cond );
+      pthread_mutex_destroy( &pool->rnd_mutex );
+      pthread_mutex_destroy( &pool->mutex );
+      ak_random_context_destroy( &pool->generator );
+      free( pool->values );
+      free( pool );
+      return ak_error_message( ak_error_undefined_function, __func__ ,
+                                                                 "wrong creation of pool thread" );
+    }
+    pool->background = ak_true;
+  }
+#endif
+  sctx->pool = pool;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет недостающие пары и помещает их в пул, созданный функцией
+    ak_signkey_context_create_pool(). Функция может вызываться одновременно с выработкой
+    подписей, а также при наличии потока, пополняющего пул.
+
+    @param sctx Контекст секретного ключа алгоритма электронной подписи.
+    @return В случае успеха возвращается ноль (\ref ak_error_ok). В противном случае возвращается
+    код ошибки.                                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_signkey_context_refill_pool( ak_signkey sctx )
+{
+  int error = ak_error_ok;
+
+  if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                      "using null pointer to secret key context" );
+  if( sctx->pool == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                                "using key without created pool" );
+  if(( error = ak_signkey_pool_refill( sctx->pool )) != ak_error_ok )
+    ak_error_message( error, __func__ , "incorrect refilling of pool" );
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param sctx Контекст секретного ключа алгоритма электронной подписи.
+    @return Функция возвращает количество пар, содержащихся в пуле. Если пул не создан,
+    возвращается ноль.                                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ size_t ak_signkey_context_get_pool_count( ak_signkey sctx )
+{
+  size_t count = 0;
+
+  if(( sctx == NULL ) || ( sctx->pool == NULL )) return 0;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_lock( &sctx->pool->mutex );
+#endif
+  count = sctx->pool->count;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_unlock( &sctx->pool->mutex );
+#endif
+ return count;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция завершает работу потока, пополняющего пул (если он был создан), уничтожает
+    хранящиеся в пуле пары и освобождает память. Функция вызывается при уничтожении
+    контекста секретного ключа.
+
+    @param sctx Контекст секретного ключа алгоритма электронной подписи.
+    @return В случае успеха возвращается ноль (\ref ak_error_ok). В противном случае возвращается
+    код ошибки.                                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_signkey_context_destroy_pool( ak_signkey sctx )
+{
+  ak_signkey_pool pool = NULL;
+
+  if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                      "using null pointer to secret key context" );
+  if(( pool = sctx->pool ) == NULL ) return ak_error_ok;
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_lock( &pool->mutex );
+  pool->stop = ak_true;
+  pthread_cond_signal( &pool->cond );
+  pthread_mutex_unlock( &pool->mutex );
+  if( pool->background ) pthread_join( pool->thread, NULL );
+  pthread_cond_destroy( &pool->cond );
+  pthread_mutex_destroy( &pool->rnd_mutex );
+  pthread_mutex_destroy( &pool->mutex );
+#endif
+  ak_random_context_destroy( &pool->generator );
+  memset( pool->values, 0,
+                pool->capacity*ak_signkey_pool_item_size( pool->wc->size )*sizeof( ak_uint64 ));
+  free( pool->values );
+  free( pool );
+  sctx->pool = NULL;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Выработка электронной подписи с использованием пары, извлеченной из пула.
+
+    Функция аналогична функции ak_signkey_context_sign_const_values(), однако значение
+    \f$ r \f$ берется из пула, а произведение \f$ ke \f$ вычисляется без снятия маски
+    со значения \f$ k \f$: \f$ ke \equiv (k\mu \cdot e)\cdot \mu^{-1} \pmod{q} \f$.
+
+    @param sctx Контекст секретного ключа алгоритма электронной подписи.
+    @param item Пара, извлеченная из пула.
+    @param e Целое число, соотвествующее хеш-коду подписываемого сообщения.
+    @param out Массив, куда помещается результат.                                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_signkey_context_sign_pool_values( ak_signkey sctx,
+                                                    ak_uint64 *item, ak_uint64 *e, ak_pointer out )
+{
+  ak_mpzn512 s, t;
+  ak_wcurve wc = ( ak_wcurve ) sctx->key.data;
+  ak_uint64 *r = item + 2*wc->size;
+
+ /* вычисляем значение s <- r*d (mod q) */
+  ak_signkey_context_mul_key( sctx, s, r );
+
+ /* приводим e по модулю q */
+  ak_mpzn_rem_q( t, e, wc );
+  if( ak_mpzn_cmp_ui( t, wc->size, 0 )) ak_mpzn_set_ui( t, wc->size, 1 );
+
+ /* вычисляем k*e (mod q), снимая маску только с произведения, и s = r*d + k*e (mod q) */
+  ak_mpzn_mul_montgomery( t, item, t, wc->q, wc->nq, wc->size );       /* t <- k*mu*e */
+  ak_mpzn_mul_montgomery( t, t, item+wc->size, wc->q, wc->nq, wc->size );  /* t <- k*e */
+  ak_mpzn_add_montgomery( s, s, t, wc->q, wc->size );
+
+ /* экспортируем результат */
+  ak_mpzn_to_little_endian( s, wc->size, out, sizeof(ak_uint64)*wc->size, ak_true );
+  ak_mpzn_to_little_endian( r, wc->size, (ak_uint64 *)out + wc->size,
+                                                             sizeof(ak_uint64)*wc->size, ak_true );
+ /* завершаемся */
+  sctx->key.set_mask( &sctx->key );
+  memset( s, 0, sizeof( ak_mpzn512 ));
+  memset( t, 0, sizeof( ak_mpzn512 ));
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! @param sctx Контекст секретного ключа алгоритма электронной подписи.
     @param hash Последовательность байт, содержащая в себе хеш-код
@@ -676,6 +1122,7 @@
   size_t lb = 0;
   ak_mpzn512 k, h;
   int error = ak_error_ok;
+  ak_uint64 item[ak_signkey_pool_item_size( ak_mpzn512_size )];
  /* нужен нам для доступа к системному генератору случайных чисел */
   ak_context_manager manager = NULL;
 
@@ -689,6 +1136,18 @@
   if( out_size < 2*lb ) return ak_error_message( ak_error_wrong_length, __func__,
                                                        "using small buffer for digital sigature" );
 
+ /* если пул не пуст, то используем заранее вычисленную пару */
+  if(( sctx->pool != NULL ) && ( sctx->pool->wc == ( ak_wcurve )sctx->key.data ) &&
+                                                       ak_signkey_pool_take( sctx->pool, item )) {
+    memcpy( h, hash, sctx->ctx.data.sctx.hsize );
+#ifndef LIBAKRYPT_LITTLE_ENDIAN
+    for( i = 0; i < (( ak_wcurve )sctx->key.data)->size; i++ ) h[i] = bswap_64( h[i] );
+#endif
+    ak_signkey_context_sign_pool_values( sctx, item, h, out );
+    ak_ptr_context_wipe( item, sizeof( item ), &sctx->key.generator );
+    return ak_error_ok;
+  }
+
  /* получаем доступ к генератору случайных чисел */
   if(( manager = ak_libakrypt_get_context_manager()) == NULL )
     return ak_error_message( ak_error_null_pointer, __func__,
@@ -871,7 +1330,7 @@
  /* теперь определяем открытый ключ */
   ak_mpzn_mul_montgomery( k, ( ak_uint64 *)sctx->key.key, one,
                                                       pctx->wc->q, pctx->wc->nq, pctx->wc->size );
-  ak_wpoint_pow( &pctx->qpoint, &pctx->wc->point, k, pctx->wc->size, pctx->wc );
+  ak_wpoint_pow_base( &pctx->qpoint, k, pctx->wc );
 
   ak_mpzn_mul_montgomery( k, ( ak_uint64 *)( sctx->key.key + sctx->key.key_size ),
                                                   one, pctx->wc->q, pctx->wc->nq, pctx->wc->size);
@@ -967,40 +1426,18 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! @param pctx контекст открытого ключа.
-    @param hash хеш-код сообщения (последовательность байт), для которого проверяется электронная подпись.
-    @param hsize размер хеш-кода, в байтах.
-    @param sign электронная подпись, для которой выполняется проверка.
-    @return Функция возыращает истину, если подпись верна. Если функция не верна или если
-    возникла ошибка, то возвращается ложь. Код Ошибки может получен с помощью
-    вызова функции ak_error_get_value().                                                           */
+/*! \brief Функция импортирует электронную подпись и хеш-код подписанного сообщения. */
+/*! Функция вычисляет значения \f$ r, s \f$, а также вычет \f$ v \equiv h \pmod{q} \f$
+    в представлении Монтгомери (если \f$ h \equiv 0 \pmod{q}\f$, то \f$ v = 1\f$). Проверки
+    параметров должны быть выполнены до вызова функции.                                            */
 /* ----------------------------------------------------------------------------------------------- */
- bool_t ak_verifykey_context_verify_hash( ak_verifykey pctx,
-                                        const ak_pointer hash, const size_t hsize, ak_pointer sign )
+ static void ak_verifykey_context_import_sign( ak_verifykey pctx, const ak_pointer hash,
+                                    ak_pointer sign, ak_uint64 *r, ak_uint64 *s, ak_uint64 *v )
 {
 #ifndef LIBAKRYPT_LITTLE_ENDIAN
   int i = 0;
 #endif
-  ak_mpzn512 v, z1, z2, u, r, s, h;
-  struct wpoint cpoint, tpoint;
-
-  if( pctx == NULL ) {
-    ak_error_message( ak_error_null_pointer, __func__,
-                                               "using a null pointer to secret key context" );
-    return ak_false;
-  }
-  if( hash == NULL ) {
-    ak_error_message( ak_error_null_pointer, __func__, "using a null pointer to hash value" );
-    return ak_false;
-  }
-  if( hsize != sizeof( ak_uint64 )*(pctx->wc->size )) {
-    ak_error_message( ak_error_wrong_length, __func__, "using hash value with wrong length" );
-    return ak_false;
-  }
-  if( sign == NULL ) {
-    ak_error_message( ak_error_null_pointer, __func__, "using a null pointer to sign value" );
-    return ak_false;
-  }
+  ak_mpzn512 h;
 
  /* импортируем подпись */
   ak_mpzn_set_little_endian( s, pctx->wc->size, sign, sizeof(ak_uint64)*pctx->wc->size, ak_true );
@@ -1013,15 +1450,19 @@
 #endif
 
   ak_mpzn_set( v, h, pctx->wc->size );
-  ak_mpzn_rem( v, v, pctx->wc->q, pctx->wc->size );
+  ak_mpzn_rem_q( v, v, pctx->wc );
   if( ak_mpzn_cmp_ui( v, pctx->wc->size, 0 )) ak_mpzn_set_ui( v, pctx->wc->size, 1 );
   ak_mpzn_mul_montgomery( v, v, pctx->wc->r2q, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
+}
 
-  /* вычисляем v (в представлении Монтгомери) */
-  ak_mpzn_set_ui( u, pctx->wc->size, 2 );
-  ak_mpzn_sub( u, pctx->wc->q, u, pctx->wc->size );
-  ak_mpzn_modpow_montgomery( v, v, u, pctx->wc->q, pctx->wc->nq, pctx->wc->size ); // v <- v^{q-2} (mod q)
-
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет степени кратности \f$ z_1 \equiv sv^{-1} \pmod{q}\f$ и
+    \f$ z_2 \equiv -rv^{-1} \pmod{q}\f$ (величина \f$ v^{-1}\f$ задается в представлении
+    Монтгомери).                                                                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_verifykey_context_set_multipliers( ak_verifykey pctx, ak_uint64 *r, ak_uint64 *s,
+                                                   ak_uint64 *v, ak_uint64 *z1, ak_uint64 *z2 )
+{
   /* вычисляем z1 */
   ak_mpzn_mul_montgomery( z1, s, pctx->wc->r2q, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
   ak_mpzn_mul_montgomery( z1, z1, v, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
@@ -1032,13 +1473,51 @@
   ak_mpzn_sub( z2, pctx->wc->q, z2, pctx->wc->size );
   ak_mpzn_mul_montgomery( z2, z2, v, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
   ak_mpzn_mul_montgomery( z2, z2, pctx->wc->point.z, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param pctx контекст открытого ключа.
+    @param hash хеш-код сообщения (последовательность байт), для которого проверяется электронная подпись.
+    @param hsize размер хеш-кода, в байтах.
+    @param sign электронная подпись, для которой выполняется проверка.
+    @return Функция возыращает истину, если подпись верна. Если функция не верна или если
+    возникла ошибка, то возвращается ложь. Код Ошибки может получен с помощью
+    вызова функции ak_error_get_value().                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_verifykey_context_verify_hash( ak_verifykey pctx,
+                                        const ak_pointer hash, const size_t hsize, ak_pointer sign )
+{
+  ak_mpzn512 v, z1, z2, r, s;
+  struct wpoint cpoint;
+
+  if( pctx == NULL ) {
+    ak_error_message( ak_error_null_pointer, __func__,
+                                               "using a null pointer to secret key context" );
+    return ak_false;
+  }
+  if( hash == NULL ) {
+    ak_error_message( ak_error_null_pointer, __func__, "using a null pointer to hash value" );
+    return ak_false;
+  }
+  if( hsize != sizeof( ak_uint64 )*(pctx->wc->size )) {
+    ak_error_message( ak_error_wrong_length, __func__, "using hash value with wrong length" );
+    return ak_false;
+  }
+  if( sign == NULL ) {
+    ak_error_message( ak_error_null_pointer, __func__, "using a null pointer to sign value" );
+    return ak_false;
+  }
+
+ /* вычисляем v^{-1} (mod q) (в представлении Монтгомери) */
+  ak_verifykey_context_import_sign( pctx, hash, sign, r, s, v );
+  ak_mpzn_inverse_montgomery( v, v, pctx->wc->q,
+                                  pctx->wc->nq, pctx->wc->r2q, pctx->wc->size ); // v <- v^{-1}
+  ak_verifykey_context_set_multipliers( pctx, r, s, v, z1, z2 );
 
  /* сложение точек и проверка */
-  ak_wpoint_pow( &cpoint, &pctx->wc->point, z1, pctx->wc->size, pctx->wc );
-  ak_wpoint_pow( &tpoint, &pctx->qpoint, z2, pctx->wc->size, pctx->wc );
-  ak_wpoint_add( &cpoint, &tpoint, pctx->wc );
+  ak_wpoint_pow_sum( &cpoint, &pctx->wc->point, z1, &pctx->qpoint, z2, pctx->wc->size, pctx->wc );
   ak_wpoint_reduce( &cpoint, pctx->wc );
-  ak_mpzn_rem( cpoint.x, cpoint.x, pctx->wc->q, pctx->wc->size );
+  ak_mpzn_rem_q( cpoint.x, cpoint.x, pctx->wc );
 
   if( ak_mpzn_cmp( cpoint.x, r, pctx->wc->size )) {
     ak_ptr_is_equal_with_log( cpoint.x, r, pctx->wc->size*sizeof( ak_uint64 ));
@@ -1047,6 +1526,193 @@
  return ak_true;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                               пакетная проверка электронной подписи                             */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество элементов пакета, которые поток забирает из очереди за одно обращение. */
+ #define ak_verifykey_batch_chunk    (32)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Очередь элементов пакета, обрабатываемая несколькими потоками. */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct verifykey_batch_queue {
+  /*! \brief Массив элементов пакета */
+   ak_verifykey_item items;
+  /*! \brief Количество элементов пакета */
+   size_t count;
+  /*! \brief Номер первого необработанного элемента */
+   size_t next;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  /*! \brief Мьютекс, разграничивающий доступ к очереди */
+   pthread_mutex_t mutex;
+#endif
+} *ak_verifykey_batch_queue;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Проверка подписей для последовательного фрагмента пакета.
+    \details Элементы фрагмента группируются по эллиптическим кривым. Для каждой группы
+    обратные вычеты \f$ v^{-1} \pmod{q} \f$ и обратные значения \f$ z \f$-координат
+    вычисленных точек вычисляются одновременно (прием Монтгомери), то есть для всей группы
+    выполняется только два обращения (функция ak_mpzn_inverse_montgomery_batch() использует
+    алгоритм safegcd, а не возведение в степень). Обрабатываются только элементы,
+    поле `result` которых имеет значение \ref ak_true.                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_verifykey_batch_verify_chunk( ak_verifykey_item items, const size_t count )
+{
+  ak_wcurve wc = NULL;
+  ak_verifykey_item it = NULL;
+  ak_mpzn512 z1, z2, one = ak_mpzn512_one;
+  size_t i, j, m, cnt, size, idx[ak_verifykey_batch_chunk], pos[ak_verifykey_batch_chunk];
+  ak_uint64 r[ak_verifykey_batch_chunk][ak_mpzn512_size],
+            s[ak_verifykey_batch_chunk][ak_mpzn512_size],
+            v[ak_verifykey_batch_chunk*ak_mpzn512_size],
+            t[ak_verifykey_batch_chunk*ak_mpzn512_size];
+  struct wpoint points[ak_verifykey_batch_chunk];
+  bool_t done[ak_verifykey_batch_chunk];
+
+  memset( done, 0, sizeof( done ));
+  for( i = 0; i < count; i++ ) {
+     if( done[i] || ( items[i].result != ak_true )) continue;
+
+    /* выбираем все элементы фрагмента, использующие ту же кривую */
+     wc = items[i].vkey->wc;
+     size = wc->size;
+     for( j = i, cnt = 0; j < count; j++ ) {
+        if( done[j] || ( items[j].result != ak_true ) || ( items[j].vkey->wc != wc )) continue;
+        done[j] = ak_true;
+        idx[cnt++] = j;
+     }
+
+    /* вычисляем v^{-1} (mod q) для всех элементов группы */
+     for( j = 0; j < cnt; j++ ) {
+        it = items + idx[j];
+        ak_verifykey_context_import_sign( it->vkey, it->hash, it->sign, r[j], s[j], v+j*size );
+     }
+     ak_mpzn_inverse_montgomery_batch( v, t, cnt, wc->q, wc->nq, wc->r2q, size );
+
+    /* вычисляем точки C = [z1]P + [z2]Q */
+     for( j = 0, m = 0; j < cnt; j++ ) {
+        it = items + idx[j];
+        ak_verifykey_context_set_multipliers( it->vkey, r[j], s[j], v+j*size, z1, z2 );
+        ak_wpoint_pow_sum( points+j, &wc->point, z1, &it->vkey->qpoint, z2, size, wc );
+        if( ak_mpzn_cmp_ui( points[j].z, size, 0 )) it->result = ak_false;
+          else {
+            ak_mpzn_set( v+m*size, points[j].z, size );
+            pos[m++] = j;
+          }
+     }
+
+    /* одновременно приводим точки к аффинной форме и сравниваем x-координаты с r */
+     ak_mpzn_inverse_montgomery_batch( v, t, m, wc->p, wc->n, wc->r2, size );
+     for( j = 0; j < m; j++ ) {
+        ak_mpzn_mul_montgomery( z1, v+j*size, one, wc->p, wc->n, size );
+        ak_mpzn_mul_montgomery( z1, points[pos[j]].x, z1, wc->p, wc->n, size );
+        ak_mpzn_rem_q( z1, z1, wc );
+        if( ak_mpzn_cmp( z1, r[pos[j]], size )) items[idx[pos[j]]].result = ak_false;
+     }
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция потока, обрабатывающего фрагменты пакета из общей очереди. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_verifykey_batch_thread( void *ptr )
+{
+  size_t first, count;
+  ak_verifykey_batch_queue queue = ( ak_verifykey_batch_queue ) ptr;
+
+  do{
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+     pthread_mutex_lock( &queue->mutex );
+#endif
+     first = queue->next;
+     count = ak_min( ak_verifykey_batch_chunk, queue->count - first );
+     queue->next += count;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+     pthread_mutex_unlock( &queue->mutex );
+#endif
+     if( !count ) break;
+     ak_verifykey_batch_verify_chunk( queue->items + first, count );
+  } while( ak_true );
+
+ return NULL;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция проверяет электронные подписи для каждого элемента массива `items` так же, как это
+    делает функция ak_verifykey_context_verify_hash(). Элементы пакета могут использовать
+    различные открытые ключи и различные эллиптические кривые.
+
+    Пакет разбивается на фрагменты по \ref ak_verifykey_batch_chunk элементов, которые
+    образуют общую очередь заданий; при сборке библиотеки с поддержкой потоков очередь
+    обрабатывается `threads` потоками. Внутри фрагмента все обратные элементы,
+    необходимые для проверки подписей на одной кривой, вычисляются одновременно,
+    а кратные образующей точки кривой вычисляются один раз и используются всеми потоками.
+
+    Результат проверки каждой подписи помещается в поле `result` соответствующего элемента.
+    Для элементов с некорректными параметрами это поле принимает значение \ref ak_false;
+    такие элементы не влияют на обработку остальных элементов.
+
+    @param items Массив элементов пакета.
+    @param count Количество элементов пакета.
+    @param threads Количество потоков; значения 0 и 1 означают обработку в текущем потоке.
+
+    @return Функция возвращает \ref ak_error_ok, если параметры всех элементов корректны
+    (значение не зависит от результатов проверки подписей). В противном случае возвращается
+    код ошибки первого некорректного элемента.                                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_verifykey_context_verify_hash_batch( ak_verifykey_item items, const size_t count,
+                                                                            const size_t threads )
+{
+  size_t idx = 0;
+  int error = ak_error_ok, ierror;
+  struct verifykey_batch_queue queue;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_t *tid = NULL;
+  size_t started = 0;
+#endif
+
+  if( items == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                         "using null pointer to array of items" );
+  if( !count ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                               "using zero length array of items" );
+ /* проверяем параметры каждого элемента */
+  for( idx = 0; idx < count; idx++ ) {
+     ak_verifykey_item it = items+idx;
+     ierror = ak_error_ok;
+     if(( it->vkey == NULL ) || ( it->vkey->wc == NULL )) ierror = ak_error_null_pointer;
+       else if(( it->hash == NULL ) || ( it->sign == NULL )) ierror = ak_error_null_pointer;
+         else if( it->hsize != sizeof( ak_uint64 )*it->vkey->wc->size )
+                ierror = ak_error_wrong_length;
+     it->result = ( ierror == ak_error_ok );
+     if(( ierror != ak_error_ok ) && ( error == ak_error_ok ))
+       error = ak_error_message( ierror, __func__, "using item with wrong parameters" );
+  }
+
+  queue.items = items;
+  queue.count = count;
+  queue.next = 0;
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  if( pthread_mutex_init( &queue.mutex, NULL ) != 0 )
+    return ak_error_message( ak_error_undefined_value, __func__ , "wrong initialization of mutex" );
+ /* потоки, которые не удалось создать, не используются: очередь будет обработана остальными */
+  if(( threads > 1 ) && (( tid = malloc(( threads - 1 )*sizeof( pthread_t ))) != NULL )) {
+    for( started = 0; started < threads - 1; started++ )
+       if( pthread_create( tid+started, NULL, ak_verifykey_batch_thread, &queue ) != 0 ) break;
+  }
+  ak_verifykey_batch_thread( &queue );
+  for( idx = 0; idx < started; idx++ ) pthread_join( tid[idx], NULL );
+  if( tid != NULL ) free( tid );
+  pthread_mutex_destroy( &queue.mutex );
+#else
+  ak_verifykey_batch_thread( &queue );
+  (void)threads;
+#endif
+
+ return error;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! @param pctx контекст открытого ключа.
     @param in область памяти для которой проверяется электронная подпись.
@@ -11,6 +11,11 @@
  #include <ak_hmac.h>
  #include <ak_asn1.h>
 
+/* ----------------------------------------------------------------------------------------------- */
+ struct signkey_pool;
+/*! \brief Пул заранее вычисленных пар \f$ (k, r) \f$, используемых при выработке подписи. */
+ typedef struct signkey_pool *ak_signkey_pool;
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Секретный ключ алгоритма выработки электронной подписи ГОСТ Р 34.10-2012.
 
@@ -31,6 +36,9 @@
   ak_tlv name;
  /*! \brief номер открытого ключа, выработанного из данного секретного ключа. */
   ak_uint8 verifykey_number[32];
+ /*! \brief пул заранее вычисленных пар \f$ (k, r) \f$; если указатель равен NULL,
+    то пара вычисляется при выработке каждой подписи */
+  ak_signkey_pool pool;
 } *ak_signkey;
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -82,6 +90,14 @@
  int ak_signkey_context_sign_ptr( ak_signkey , const ak_pointer , const size_t , ak_pointer , size_t );
 /*! \brief Выработка электронной подписи для заданного файла. */
  int ak_signkey_context_sign_file( ak_signkey , const char * , ak_pointer , size_t );
+/*! \brief Создание пула заранее вычисленных пар, используемых при выработке подписи. */
+ int ak_signkey_context_create_pool( ak_signkey , const size_t , bool_t );
+/*! \brief Пополнение пула заранее вычисленных пар. */
+ int ak_signkey_context_refill_pool( ak_signkey );
+/*! \brief Количество пар, содержащихся в пуле. */
+ size_t ak_signkey_context_get_pool_count( ak_signkey );
+/*! \brief Уничтожение пула заранее вычисленных пар. */
+ int ak_signkey_context_destroy_pool( ak_signkey );
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Открытый ключ алгоритма проверки электронной подписи ГОСТ Р 34.10-2012.
@@ -144,6 +160,25 @@
 /*! \brief Проверка электронной подписи для заданного файла. */
  bool_t ak_verifykey_context_verify_file( ak_verifykey , const char * , ak_pointer );
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Элемент пакета, обрабатываемого функцией ak_verifykey_context_verify_hash_batch(). */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct verifykey_item {
+  /*! \brief Открытый ключ, с помощью которого проверяется подпись. */
+   ak_verifykey vkey;
+  /*! \brief Хеш-код подписанного сообщения. */
+   ak_pointer hash;
+  /*! \brief Размер хеш-кода в октетах. */
+   size_t hsize;
+  /*! \brief Проверяемая электронная подпись. */
+   ak_pointer sign;
+  /*! \brief Результат проверки подписи. */
+   bool_t result;
+} *ak_verifykey_item;
+
+/*! \brief Проверка электронных подписей для набора вычисленных заранее хеш-кодов. */
+ int ak_verifykey_context_verify_hash_batch( ak_verifykey_item , const size_t , const size_t );
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Выполнение тестовых примеров для алгоритмов выработки и проверки электронной подписи */
  bool_t ak_signkey_test( void );
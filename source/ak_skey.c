@@ -31,13 +31,153 @@
 #endif
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! \brief Переменная определяет порядковый номер ключа в рамках одной сессии.
-    Использование этой переменной помогает избежать одновременной генерации ключей при
-    многопоточной реализации. */
- static ak_uint32 session_unique_number = 0;
+/*! \brief Данные, принадлежащие одному потоку исполнения и используемые всеми секретными ключами,
+    создаваемыми или используемыми в этом потоке. */
+/*! \details Каждый поток получает собственный генератор масок и собственный счетчик ключей.
+    Вместе с порядковым номером потока счетчик однозначно определяет ключ в рамках сессии,
+    поэтому выработка уникальных номеров ключей не требует синхронизации потоков.                  */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct skey_thread_data {
+  /*! \brief Генератор масок секретных ключей */
+   struct random generator;
+  /*! \brief Порядковый номер потока в рамках одной сессии */
+   ak_uint32 thread_number;
+  /*! \brief Количество номеров ключей, выработанных в потоке */
+   ak_uint64 counter;
+ } *ak_skey_thread_data;
+
+/*! \brief Переменная определяет порядковый номер очередного потока в рамках одной сессии. */
+ static ak_uint32 session_thread_number = 0;
 #ifdef LIBAKRYPT_HAVE_PTHREAD
- static pthread_mutex_t session_unique_number_mutex = PTHREAD_MUTEX_INITIALIZER;
+ static pthread_mutex_t session_thread_number_mutex = PTHREAD_MUTEX_INITIALIZER;
+ static pthread_once_t skey_thread_data_once = PTHREAD_ONCE_INIT;
+ static pthread_key_t skey_thread_data_key;
+#else
+ static struct skey_thread_data skey_single_thread_data;
+ static ak_skey_thread_data skey_single_thread_data_ptr = NULL;
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция уничтожает данные потока.                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_skey_thread_data_free( ak_pointer ptr )
+{
+  ak_skey_thread_data td = ptr;
+
+  if( td == NULL ) return;
+  ak_random_context_destroy( &td->generator );
+  memset( td, 0, sizeof( struct skey_thread_data ));
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  free( td );
+#endif
+}
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_skey_thread_data_key_create( void )
+{
+  pthread_key_create( &skey_thread_data_key, ak_skey_thread_data_free );
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает данные текущего потока, при первом обращении данные создаются.
+    \return Указатель на данные потока. В случае ошибки возвращается NULL.                         */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_skey_thread_data ak_skey_thread_data_get( void )
+{
+  ak_skey_thread_data td = NULL;
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_once( &skey_thread_data_once, ak_skey_thread_data_key_create );
+  if(( td = pthread_getspecific( skey_thread_data_key )) != NULL ) return td;
+  if(( td = malloc( sizeof( struct skey_thread_data ))) == NULL ) {
+    ak_error_message( ak_error_out_of_memory, __func__ ,
+                                              "incorrect memory allocation for thread local data" );
+    return NULL;
+  }
+#else
+  if(( td = skey_single_thread_data_ptr ) != NULL ) return td;
+  td = &skey_single_thread_data;
 #endif
+  memset( td, 0, sizeof( struct skey_thread_data ));
+  if( ak_random_context_create_lcg( &td->generator ) != ak_error_ok ) {
+    ak_error_message( ak_error_get_value(), __func__ , "wrong creation of random generator" );
+   #ifdef LIBAKRYPT_HAVE_PTHREAD
+    free( td );
+   #endif
+    return NULL;
+  }
+
+ /* порядковый номер потока вырабатывается однократно, при первом обращении потока */
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_lock( &session_thread_number_mutex );
+#endif
+  td->thread_number = ++session_thread_number;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_unlock( &session_thread_number_mutex );
+  pthread_setspecific( skey_thread_data_key, td );
+#else
+  skey_single_thread_data_ptr = td;
+#endif
+ return td;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция уничтожает генератор масок и счетчик ключей вызвавшего ее потока. Для потоков,
+    завершаемых функцией pthread_exit(), данные уничтожаются автоматически; функция
+    вызывается из ak_libakrypt_destroy() для основного потока программы.                           */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_skey_context_thread_data_destroy( void )
+{
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  ak_skey_thread_data td = NULL;
+
+  pthread_once( &skey_thread_data_once, ak_skey_thread_data_key_create );
+  if(( td = pthread_getspecific( skey_thread_data_key )) == NULL ) return;
+  pthread_setspecific( skey_thread_data_key, NULL );
+  ak_skey_thread_data_free( td );
+#else
+  ak_skey_thread_data_free( skey_single_thread_data_ptr );
+  skey_single_thread_data_ptr = NULL;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция выработки масок, использующая генератор текущего потока.                        */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_skey_context_thread_random( ak_random rnd, const ak_pointer ptr, const ssize_t size )
+{
+  ak_skey_thread_data td = NULL;
+
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                      "use a null pointer to a random generator" );
+  if(( td = ak_skey_thread_data_get( )) == NULL ) return ak_error_message(
+                          ak_error_get_value(), __func__ , "thread local data is not available" );
+ return ak_random_context_random( &td->generator, ptr, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Инициализация генератора масок секретного ключа. */
+/*! Генератор не имеет собственного внутреннего состояния и обращается к генератору потока,
+    в котором вызывается функция выработки маски. Тем самым создание ключа не требует
+    инициализации нового генератора, а использование ключа в разных потоках не требует
+    синхронизации.                                                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_skey_context_create_generator( ak_random rnd )
+{
+  ak_skey_thread_data td = NULL;
+  int error = ak_error_ok;
+
+  if(( td = ak_skey_thread_data_get( )) == NULL ) return ak_error_message(
+                          ak_error_get_value(), __func__ , "thread local data is not available" );
+  if(( error = ak_random_context_create( rnd )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "wrong initialization of random generator" );
+
+  rnd->oid = td->generator.oid;
+  rnd->random = ak_skey_context_thread_random;
+ return ak_error_ok;
+}
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \details Функция выделяет массив памяти, достаточный для размещения секретного ключа и
@@ -136,12 +276,15 @@
   ak_uint8 out[64], hm[32];
   ak_uint64 rvalue = 0;
   int error = ak_error_ok;
+  ak_skey_thread_data td = NULL;
   const char *version =  ak_libakrypt_version();
 
   if( data == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                            "using null pointer to result buffer" );
   if( !size ) return ak_error_message( ak_error_zero_length, __func__,
                                                                  "using buffer with zero length" );
+  if(( td = ak_skey_thread_data_get( )) == NULL ) return ak_error_message(
+                          ak_error_get_value(), __func__ , "thread local data is not available" );
   if(( error = ak_hash_context_create_streebog256( &ctx )) != ak_error_ok )
     return ak_error_message( error, __func__ , "wrong creation of hash function context" );
 
@@ -152,18 +295,14 @@
   if(( len = strlen( version )) > sizeof( out )) goto run_point;
   memcpy( out, version, len ); /* сначала версия библиотеки */
 
- /* добавляем уникальный номер ключа в рамках теущей сессии
+ /* добавляем уникальный номер ключа в рамках теущей сессии: номер потока и номер ключа в потоке;
     это не позволит в один интервал времени создать более одного ключа с одинаковым номером */
-  if( len + 2 > sizeof( out )) goto run_point;
-#ifdef LIBAKRYPT_HAVE_PTHREAD
-  pthread_mutex_lock( &session_unique_number_mutex );
-#endif
-  session_unique_number++;
-#ifdef LIBAKRYPT_HAVE_PTHREAD
-  pthread_mutex_unlock( &session_unique_number_mutex );
-#endif
-  memcpy( out+len, &session_unique_number, sizeof( ak_uint32 )); /* потом время генерации номера ключа */
+  if( len + sizeof( ak_uint32 ) + sizeof( ak_uint64 ) > sizeof( out )) goto run_point;
+  memcpy( out+len, &td->thread_number, sizeof( ak_uint32 ));
   len += sizeof( ak_uint32 );
+  td->counter++;
+  memcpy( out+len, &td->counter, sizeof( ak_uint64 ));
+  len += sizeof( ak_uint64 );
 
  /* заполняем стандартное начало вектора: текущее время */
   if( len + sizeof( time_t ) > sizeof( out )) goto run_point;
@@ -177,13 +316,8 @@
   memcpy( out+len, &rvalue, sizeof( ak_uint64 ));
   len += sizeof( ak_uint64 );
 
-  if( len < sizeof( out )) { /* используем генератор, отличный от генератора масок */
-    struct random generator;
-    if( ak_random_context_create_lcg( &generator ) == ak_error_ok ) {
-      ak_random_context_random( &generator, out+len, (ssize_t)( sizeof( out ) - len )); /* добавляем мусор */
-      ak_random_context_destroy( &generator );
-    }
-  }
+  if( len < sizeof( out )) /* добавляем мусор, используя генератор текущего потока */
+    ak_random_context_random( &td->generator, out+len, (ssize_t)( sizeof( out ) - len ));
 
  /* перед хешированием мы имеем вектор
       версия библиотеки || номер в сессии || время || (как бы) случайный мусор
@@ -281,7 +415,7 @@
   memset( &(skey->resource), 0, sizeof( struct resource )); /* ресурс ключа не определен */
 
  /* инициализируем генератор масок */
-  if(( error = ak_random_context_create_lcg( &skey->generator )) != ak_error_ok ) {
+  if(( error = ak_skey_context_create_generator( &skey->generator )) != ak_error_ok ) {
     ak_error_message( error, __func__ , "wrong creation of random generator" );
     ak_skey_context_destroy( skey );
     return error;
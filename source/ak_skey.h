@@ -176,6 +176,8 @@
  int ak_skey_context_destroy( ak_skey );
 /*! \brief Генерация случайного уникального вектора, рассматриваемого как номер ключа. */
  int ak_skey_context_generate_unique_number( ak_pointer , const size_t );
+/*! \brief Уничтожение генератора масок и счетчика ключей текущего потока. */
+ void ak_skey_context_thread_data_destroy( void );
 /*! \brief Присвоение секретному ключу уникального номера. */
  int ak_skey_context_set_unique_number( ak_skey );
 /*! \brief Присвоение секретному ключу заданного номера. */
@@ -50,6 +50,9 @@
 #ifdef LIBAKRYPT_HAVE_SYSSTAT_H
  #include <sys/stat.h>
 #endif
+#ifdef LIBAKRYPT_HAVE_SYSMMAN_H
+ #include <sys/mman.h>
+#endif
 #ifdef LIBAKRYPT_HAVE_TERMIOS_H
  #include <termios.h>
 #endif
@@ -768,6 +771,102 @@
  #endif
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_file_seek( ak_file file, ak_int64 offset )
+{
+ #ifdef LIBAKRYPT_HAVE_WINDOWS_H
+  LARGE_INTEGER li;
+  li.QuadPart = offset;
+  if( SetFilePointerEx( file->hFile, li, NULL, FILE_BEGIN ) == FALSE )
+    return ak_error_message( ak_error_read_data, __func__, "unable to set file position" );
+ #else
+  if( lseek( file->fd, ( off_t )offset, SEEK_SET ) == ( off_t )-1 )
+    return ak_error_message_fmt( ak_error_read_data, __func__,
+                                          "unable to set file position (%s)", strerror( errno ));
+ #endif
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция отображает в память первые `size` октетов файла, открытого с помощью функции
+    ak_file_open_to_read(), и сообщает операционной системе о том, что данные будут считываться
+    последовательно. Это позволяет ядру считывать данные с диска с опережением, одновременно
+    с их обработкой.
+
+    Отображаются только обычные файлы, длина которых в момент вызова функции не меньше `size`.
+    Если после отображения файл будет усечен другим процессом, обращение к отображенной
+    памяти за новой границей файла приводит к сигналу SIGBUS. Поэтому при обработке
+    отображенных данных следует контролировать длину файла с помощью функции
+    ak_file_get_current_size() и переходить к чтению файла с помощью ak_file_read(),
+    если длина файла изменилась.
+
+    @param file Контекст открытого файла.
+    @param size Количество отображаемых октетов (должно быть отлично от нуля).
+    @return Указатель на отображенную область памяти. Если отображение файла в память
+    не поддерживается или невозможно, возвращается NULL; в этом случае данные должны
+    считываться с помощью функции ak_file_read().                                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_pointer ak_file_mmap( ak_file file, const size_t size )
+{
+#if defined( LIBAKRYPT_HAVE_SYSMMAN_H ) && !defined( LIBAKRYPT_HAVE_WINDOWS_H )
+  struct stat st;
+  ak_pointer ptr = NULL;
+
+  if(( file == NULL ) || ( size == 0 )) return NULL;
+ /* каналы, устройства и т.п. не отображаются: их длина не определена или может изменяться */
+  if( fstat( file->fd, &st ) != 0 ) return NULL;
+  if( !S_ISREG( st.st_mode ) || (( ak_uint64 )st.st_size < ( ak_uint64 )size )) return NULL;
+  if(( ptr = mmap( NULL, size, PROT_READ, MAP_PRIVATE, file->fd, 0 )) == MAP_FAILED ) return NULL;
+ #ifdef MADV_SEQUENTIAL
+  madvise( ptr, size, MADV_SEQUENTIAL );
+ #endif
+ return ptr;
+#else
+  ( void )file;
+  ( void )size;
+ return NULL;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция используется для контроля того, что длина файла не изменилась
+    в процессе обработки данных, отображенных в память с помощью функции ak_file_mmap().
+
+    @param file Контекст открытого файла.
+    @return Текущая длина файла в октетах. В случае ошибки возвращается отрицательное значение.    */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_int64 ak_file_get_current_size( ak_file file )
+{
+#ifdef LIBAKRYPT_HAVE_WINDOWS_H
+  LARGE_INTEGER li;
+
+  if( file == NULL ) return -1;
+  if( GetFileSizeEx( file->hFile, &li ) == FALSE ) return -1;
+ return ( ak_int64 )li.QuadPart;
+#else
+  struct stat st;
+
+  if( file == NULL ) return -1;
+  if( fstat( file->fd, &st ) != 0 ) return -1;
+ return ( ak_int64 )st.st_size;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_file_unmap( ak_pointer ptr, const size_t size )
+{
+#if defined( LIBAKRYPT_HAVE_SYSMMAN_H ) && !defined( LIBAKRYPT_HAVE_WINDOWS_H )
+  if( munmap( ptr, size ) != 0 ) return ak_error_message_fmt( ak_error_close_file, __func__,
+                                           "wrong unmapping of file data (%s)", strerror( errno ));
+ return ak_error_ok;
+#else
+  ( void )ptr;
+  ( void )size;
+ return ak_error_message( ak_error_undefined_function, __func__,
+                                                         "memory mapped files are not supported" );
+#endif
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  ssize_t ak_file_write( ak_file file, ak_const_pointer buffer, size_t size )
 {
@@ -52,6 +52,14 @@
  int ak_file_close( ak_file );
 /*! \brief Функция считывает заданное количество байт из файла. */
  ssize_t ak_file_read( ak_file , ak_pointer , size_t );
+/*! \brief Функция устанавливает текущую позицию чтения (записи) в файле. */
+ int ak_file_seek( ak_file , ak_int64 );
+/*! \brief Функция отображает содержимое открытого файла в память (только для чтения). */
+ ak_pointer ak_file_mmap( ak_file , const size_t );
+/*! \brief Функция возвращает текущую длину открытого файла. */
+ ak_int64 ak_file_get_current_size( ak_file );
+/*! \brief Функция освобождает область памяти, в которую был отображен файл. */
+ int ak_file_unmap( ak_pointer , const size_t );
 /*! \brief Функция записывает заданное количество байт в файл. */
  ssize_t ak_file_write( ak_file , ak_const_pointer , size_t );
 
@@ -46,6 +46,11 @@
            if(( oid = ak_oid_context_findnext_by_engine( oid, random_generator )) == NULL )
              oid = ak_oid_context_find_by_engine( random_generator );
        if( oid == NULL ) break;
+      /* пропускаем генераторы, которые не могут быть созданы только по идентификатору */
+       if( oid->func.create == NULL ) {
+         free( ctx );
+         continue;
+       }
 
        if( ak_random_context_create_oid( ctx, oid ) != ak_error_ok ) {
          if( ctx != NULL ) free(ctx);
@@ -0,0 +1,127 @@
+/* Пример иллюстрирует построение дерева хеш-кодов для файла, его сохранение и
+   последующую проверку файла с помощью сохраненного дерева.
+   Проверяется, что корень дерева не зависит от количества потоков,
+   а также то, что искажение одного фрагмента файла обнаруживается при проверке,
+   а файлы с некорректными размерами дерева отвергаются при считывании.
+   Внимание! Используются неэкспортируемые функции.
+
+   test-hash05.c
+*/
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <ak_hash.h>
+ #include <ak_tools.h>
+
+/* сохраняем дерево с измененным заголовком (или длиной) и проверяем, что оно не считывается */
+ static bool_t check_wrong_tree( const char *treename, ak_uint8 *tdata, size_t tsize,
+                                                       size_t offset, ak_uint8 value, size_t cut )
+{
+  FILE *fp = NULL;
+  ak_uint8 old = tdata[offset];
+  struct hash_tree tree;
+  int error = ak_error_ok;
+
+  tdata[offset] = value;
+  if(( fp = fopen( treename, "wb" )) == NULL ) return ak_false;
+  fwrite( tdata, 1, tsize - cut, fp );
+  fclose( fp );
+  tdata[offset] = old;
+  if(( error = ak_hash_tree_context_import_from_file( &tree, treename )) == ak_error_ok ) {
+    ak_hash_tree_context_destroy( &tree );
+    return ak_false;
+  }
+ return ak_true;
+}
+
+ int main( void )
+{
+  FILE *fp = NULL;
+  size_t wrong = 0, tsize = 0, idlen = 0;
+  ak_uint8 *tdata = NULL;
+  struct random generator;
+  struct hash_tree tree, tree2, tree3;
+  ak_uint8 data[100000], root[64], root2[64], root3[64];
+  char *filename = "test-hash05.data", *treename = "test-hash05.aktree";
+  int exitcode = EXIT_FAILURE;
+
+ /* инициализируем библиотеку */
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+
+ /* создаем файл со случайными данными */
+  ak_random_context_create_lcg( &generator );
+  ak_random_context_random( &generator, data, sizeof( data ));
+  ak_random_context_destroy( &generator );
+  if(( fp = fopen( filename, "wb" )) == NULL ) goto labexit;
+  fwrite( data, 1, sizeof( data ), fp );
+  fclose( fp );
+
+ /* строим дерево в одном и в нескольких потоках */
+  if( ak_hash_tree_context_create_file( &tree,
+              ak_oid_context_find_by_name( "streebog512" ), filename, 1000, 1 ) != ak_error_ok )
+    goto labexit;
+  ak_hash_tree_context_get_root( &tree, root, sizeof( root ));
+  printf("leaves: %u, nodes: %u\nroot (1 thread):  %s\n", (unsigned int) tree.leaves,
+      (unsigned int) tree.count, ak_ptr_to_hexstr( root, tree.hsize, ak_false ));
+
+  if( ak_hash_tree_context_create_file( &tree2,
+              ak_oid_context_find_by_name( "streebog512" ), filename, 1000, 7 ) != ak_error_ok )
+    goto labexit;
+  ak_hash_tree_context_get_root( &tree2, root2, sizeof( root2 ));
+  printf("root (7 threads): %s\n", ak_ptr_to_hexstr( root2, tree2.hsize, ak_false ));
+  ak_hash_tree_context_destroy( &tree2 );
+  if( !ak_ptr_is_equal( root, root2, tree.hsize )) goto labtree;
+
+ /* сохраняем дерево, считываем его и проверяем файл */
+  if( ak_hash_tree_context_export_to_file( &tree, treename ) != ak_error_ok ) goto labtree;
+  if( ak_hash_tree_context_import_from_file( &tree3, treename ) != ak_error_ok ) goto labtree;
+  ak_hash_tree_context_get_root( &tree3, root3, sizeof( root3 ));
+  if( !ak_ptr_is_equal( root, root3, tree.hsize )) goto labtree3;
+  if( ak_hash_tree_context_check_file( &tree3, filename, 0, 0, 3, &wrong ) != ak_error_ok )
+    goto labtree3;
+  printf("check of unchanged file: %u wrong chunks\n", (unsigned int) wrong );
+
+ /* нулевой и очень большой размер фрагмента, огромный размер файла и усеченное дерево */
+  if(( fp = fopen( treename, "rb" )) == NULL ) goto labtree3;
+  fseek( fp, 0, SEEK_END );
+  tsize = ( size_t ) ftell( fp );
+  fseek( fp, 0, SEEK_SET );
+  if(( tdata = malloc( tsize )) == NULL ) { fclose( fp ); goto labtree3; }
+  if( fread( tdata, 1, tsize, fp ) != tsize ) { fclose( fp ); goto labdata; }
+  fclose( fp );
+  idlen = tdata[8];
+  if( !check_wrong_tree( treename, tdata, tsize, 9 + idlen + 7, 0x00, 0 )) goto labdata;
+  if( !check_wrong_tree( treename, tdata, tsize, 9 + idlen + 3, 0x01, 0 )) goto labdata;
+  if( !check_wrong_tree( treename, tdata, tsize, 17 + idlen, 0xff, 0 )) goto labdata;
+  if( !check_wrong_tree( treename, tdata, tsize, 0, tdata[0], 1 )) goto labdata;
+  printf("trees with wrong sizes are rejected\n");
+
+ /* искажаем один октет в 43-м фрагменте и проверяем снова */
+  data[42*1000 + 17] ^= 0x01;
+  if(( fp = fopen( filename, "wb" )) == NULL ) goto labtree3;
+  fwrite( data, 1, sizeof( data ), fp );
+  fclose( fp );
+  if( ak_hash_tree_context_check_file( &tree3,
+                           filename, 0, 0, 3, &wrong ) != ak_error_not_equal_data ) goto labtree3;
+  printf("check of changed file: %u wrong chunks\n", (unsigned int) wrong );
+  if( wrong != 1 ) goto labtree3;
+
+ /* проверка только тех фрагментов, которые не изменялись */
+  if( ak_hash_tree_context_check_file( &tree3, filename, 43, 0, 2, &wrong ) != ak_error_ok )
+    goto labtree3;
+  printf("Ok\n");
+  exitcode = EXIT_SUCCESS;
+
+ /* завершаем работу */
+  labdata:
+   if( tdata != NULL ) free( tdata );
+  labtree3:
+   ak_hash_tree_context_destroy( &tree3 );
+  labtree:
+   ak_hash_tree_context_destroy( &tree );
+  labexit:
+   remove( filename );
+   remove( treename );
+   ak_libakrypt_destroy();
+ return exitcode;
+}
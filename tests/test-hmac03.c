@@ -0,0 +1,98 @@
+/* Пример иллюстрирует эквивалентность реализации функции ak_hmac_context_pbkdf2_streebog512(),
+   использующей предвычисленные состояния функции хеширования, и непосредственного вычисления
+   алгоритма PBKDF2 с помощью последовательности вызовов ak_hmac_context_clean()
+                                                          _update()
+                                                          _finalize()
+   Проверяются пароли и инициализационные векторы различной длины,
+   а также ключевые векторы длины, превышающей 64 октета.
+   Внимание! Используются неэкспортируемые функции.
+
+   test-hmac03.c
+*/
+ #include <time.h>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <ak_hmac.h>
+
+/* непосредственное вычисление алгоритма PBKDF2 с использованием контекста hmac */
+ static int pbkdf2( ak_uint8 *pass, size_t pass_size, ak_uint8 *salt, size_t salt_size,
+                                                      size_t cnt, size_t dklen, ak_uint8 *out )
+{
+  struct hmac hctx;
+  size_t i, j, k, len;
+  ak_uint8 u[64], t[64], ind[4];
+
+  ak_hmac_context_create_streebog512( &hctx );
+  ak_hmac_context_set_key( &hctx, pass, pass_size );
+  for( i = 1; ( i-1 )*64 < dklen; i++ ) {
+     ind[0] = 0; ind[1] = 0; ind[2] = 0; ind[3] = ( ak_uint8 )i;
+     ak_hmac_context_clean( &hctx );
+     ak_hmac_context_update( &hctx, salt, salt_size );
+     ak_hmac_context_finalize( &hctx, ind, 4, u, sizeof( u ));
+     memcpy( t, u, 64 );
+     for( j = 1; j < cnt; j++ ) {
+        ak_hmac_context_ptr( &hctx, u, 64, u, sizeof( u ));
+        for( k = 0; k < 64; k++ ) t[k] ^= u[k];
+     }
+    /* короткий ключ - старшие октеты T_1, длинный - первые октеты последнего блока */
+     len = ak_min( 64, dklen - ( i-1 )*64 );
+     memcpy( out + ( i-1 )*64, dklen > 64 ? t : t + 64 - len, len );
+  }
+  ak_hmac_context_destroy( &hctx );
+ return ak_error_ok;
+}
+
+ int main( void )
+{
+  clock_t time;
+  size_t idx = 0;
+  struct random generator;
+  int exitcode = EXIT_FAILURE;
+  ak_uint8 pass[100], salt[150], out1[300], out2[300];
+  size_t tests[4][4] = { /* длина пароля, длина вектора, число итераций, длина ключа */
+    {  8,  16, 2000,  64 },
+    { 64,  59,  100, 100 },
+    { 65,  60,   50, 256 },
+    { 99, 150,   10, 300 }
+  };
+
+ /* инициализируем библиотеку */
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+
+ /* вырабатываем случайные данные */
+  ak_random_context_create_lcg( &generator );
+  ak_random_context_random( &generator, pass, sizeof( pass ));
+  ak_random_context_random( &generator, salt, sizeof( salt ));
+  ak_random_context_destroy( &generator );
+
+  for( idx = 0; idx < 4; idx++ ) {
+     memset( out1, 0, sizeof( out1 ));
+     memset( out2, 0, sizeof( out2 ));
+
+     time = clock();
+     ak_hmac_context_pbkdf2_streebog512( pass, tests[idx][0],
+                                    salt, tests[idx][1], tests[idx][2], tests[idx][3], out1 );
+     time = clock() - time;
+     printf("pbkdf2: %s (%fs)\n",
+       ak_ptr_to_hexstr( out1, tests[idx][3], ak_false ), (double) time / (double) CLOCKS_PER_SEC );
+
+     time = clock();
+     pbkdf2( pass, tests[idx][0], salt, tests[idx][1], tests[idx][2], tests[idx][3], out2 );
+     time = clock() - time;
+     printf("hmac:   %s (%fs)\n",
+       ak_ptr_to_hexstr( out2, tests[idx][3], ak_false ), (double) time / (double) CLOCKS_PER_SEC );
+
+     if( !ak_ptr_is_equal( out1, out2, tests[idx][3] )) {
+       printf("Wrong (test %u)\n", (unsigned int) idx );
+       goto label_exit;
+     }
+  }
+  printf("Ok\n");
+  exitcode = EXIT_SUCCESS;
+
+ /* завершаем работу */
+  label_exit:
+   ak_libakrypt_destroy();
+ return exitcode;
+}
@@ -0,0 +1,84 @@
+/* Пример иллюстрирует пакетную выработку ключевых векторов из паролей
+   с помощью функции ak_hmac_context_pbkdf2_streebog512_batch().
+   Результаты сравниваются с результатами последовательных вызовов
+   функции ak_hmac_context_pbkdf2_streebog512(); элементы пакета имеют различные
+   длины паролей, инициализационных векторов, количество итераций и длины ключевых векторов.
+   Один элемент пакета намеренно содержит некорректные параметры.
+   Внимание! Используются неэкспортируемые функции.
+
+   test-hmac04.c
+*/
+ #include <time.h>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <ak_hmac.h>
+
+ #define items_count (11)
+
+ int main( void )
+{
+  clock_t time;
+  size_t idx = 0, threads = 0;
+  struct random generator;
+  int error, exitcode = EXIT_FAILURE;
+  struct pbkdf2_item items[items_count];
+  ak_uint8 pass[items_count][80], salt[items_count][70],
+                                                 out1[items_count][200], out2[items_count][200];
+
+ /* инициализируем библиотеку */
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+
+ /* вырабатываем случайные данные */
+  ak_random_context_create_lcg( &generator );
+  ak_random_context_random( &generator, pass, sizeof( pass ));
+  ak_random_context_random( &generator, salt, sizeof( salt ));
+  ak_random_context_destroy( &generator );
+
+ /* вычисляем эталонные значения */
+  memset( out2, 0, sizeof( out2 ));
+  for( idx = 0; idx < items_count; idx++ ) {
+     items[idx].pass = pass[idx];
+     items[idx].pass_size = 8 + 7*idx;
+     items[idx].salt = salt[idx];
+     items[idx].salt_size = 6*idx;
+     items[idx].cnt = 1 + 37*idx;
+     items[idx].dklen = 32 + 16*idx;
+     ak_hmac_context_pbkdf2_streebog512( items[idx].pass, items[idx].pass_size, items[idx].salt,
+                            items[idx].salt_size, items[idx].cnt, items[idx].dklen, out2[idx] );
+  }
+
+  for( threads = 1; threads < 5; threads += 3 ) {
+     memset( out1, 0, sizeof( out1 ));
+     for( idx = 0; idx < items_count; idx++ ) items[idx].out = out1[idx];
+     items[3].dklen = 16; /* некорректный элемент пакета */
+
+     time = clock();
+     error = ak_hmac_context_pbkdf2_streebog512_batch( items, items_count, threads );
+     time = clock() - time;
+     printf("batch (threads: %u, %fs)\n",
+                        (unsigned int) threads, (double) time / (double) CLOCKS_PER_SEC );
+     items[3].dklen = 32 + 16*3;
+
+     if(( error != ak_error_wrong_length ) || ( items[3].result != ak_error_wrong_length )) {
+       printf("Wrong error code: %d\n", error );
+       goto label_exit;
+     }
+     for( idx = 0; idx < items_count; idx++ ) {
+        if( idx == 3 ) continue;
+        printf(" %2u: %s\n", (unsigned int) idx, ak_ptr_to_hexstr( out1[idx], 32, ak_false ));
+        if(( items[idx].result != ak_error_ok ) ||
+                                  !ak_ptr_is_equal( out1[idx], out2[idx], items[idx].dklen )) {
+          printf("Wrong (item %u)\n", (unsigned int) idx );
+          goto label_exit;
+        }
+     }
+  }
+  printf("Ok\n");
+  exitcode = EXIT_SUCCESS;
+
+ /* завершаем работу */
+  label_exit:
+   ak_libakrypt_destroy();
+ return exitcode;
+}
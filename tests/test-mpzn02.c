@@ -0,0 +1,159 @@
+/* Пример иллюстрирует умножение вычетов в представлении Монтгомери.
+   Для модулей всех эллиптических кривых, доступных через механизм OID, сравниваются результаты
+   переносимой реализации и реализации, использующей команды mulx, adcx и adox
+   (если процессор их поддерживает), а также проверяются коммутативность, ассоциативность
+   и дистрибутивность умножения, полная приведенность результата, совпадение возведения
+   в квадрат с умножением и преобразование в представление Монтгомери и обратно.
+   Обращение вычетов по модулям p и q сравнивается с возведением в степень p-2 и q-2.
+   Для кривых с модулем специального вида результаты умножения с приведением, заданным
+   в контексте кривой, сравниваются с результатами умножения Монтгомери общего вида.
+   Приведение по модулю q методом Барретта сравнивается с функцией ak_mpzn_rem() и умножением
+   Монтгомери.
+   Внимание! Используются неэкспортируемые функции.
+
+   test-mpzn02.c
+*/
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <ak_oid.h>
+ #include <ak_curves.h>
+
+/* проверяем свойства умножения для трех вычетов */
+ static bool_t check( ak_uint64 *x, ak_uint64 *y, ak_uint64 *w, ak_wcurve ec, bool_t extensions )
+{
+  ak_mpzn512 a, b, c, d, one = ak_mpzn512_one;
+  size_t size = ec->size;
+  bool_t result = ak_true;
+
+  ak_mpzn_set_montgomery_functions( ak_false );
+  ak_mpzn_mul_montgomery( a, x, y, ec->p, ec->n, size );
+  if( extensions ) {
+    ak_mpzn_set_montgomery_functions( ak_true );
+    ak_mpzn_mul_montgomery( b, x, y, ec->p, ec->n, size );
+    result &= ( ak_mpzn_cmp( a, b, size ) == 0 );
+    ak_mpzn_sqr_montgomery( b, x, ec->p, ec->n, size );
+    ak_mpzn_mul_montgomery( c, x, x, ec->p, ec->n, size );
+    result &= ( ak_mpzn_cmp( b, c, size ) == 0 );
+    ak_wcurve_mul_montgomery( b, x, y, ec );
+    result &= ( ak_mpzn_cmp( a, b, size ) == 0 );
+    ak_wcurve_sqr_montgomery( b, x, ec );
+    result &= ( ak_mpzn_cmp( b, c, size ) == 0 );
+    ak_mpzn_set_montgomery_functions( ak_false );
+  }
+ /* умножение с приведением, заданным в контексте кривой */
+  ak_wcurve_mul_montgomery( b, x, y, ec );
+  result &= ( ak_mpzn_cmp( a, b, size ) == 0 );
+  ak_wcurve_sqr_montgomery( b, x, ec );
+  ak_mpzn_mul_montgomery( c, x, x, ec->p, ec->n, size );
+  result &= ( ak_mpzn_cmp( b, c, size ) == 0 );
+ /* возведение в квадрат */
+  ak_mpzn_sqr_montgomery( b, x, ec->p, ec->n, size );
+  ak_mpzn_mul_montgomery( c, x, x, ec->p, ec->n, size );
+  result &= ( ak_mpzn_cmp( b, c, size ) == 0 );
+  ak_mpzn_set( b, x, size );
+  ak_mpzn_sqr_montgomery( b, b, ec->p, ec->n, size );
+  result &= ( ak_mpzn_cmp( b, c, size ) == 0 );
+ /* результат полностью приведен */
+  result &= ( ak_mpzn_cmp( a, ec->p, size ) < 0 );
+ /* коммутативность */
+  ak_mpzn_mul_montgomery( b, y, x, ec->p, ec->n, size );
+  result &= ( ak_mpzn_cmp( a, b, size ) == 0 );
+ /* ассоциативность: (xy)w = x(yw) */
+  ak_mpzn_mul_montgomery( b, a, w, ec->p, ec->n, size );
+  ak_mpzn_mul_montgomery( c, y, w, ec->p, ec->n, size );
+  ak_mpzn_mul_montgomery( c, x, c, ec->p, ec->n, size );
+  result &= ( ak_mpzn_cmp( b, c, size ) == 0 );
+ /* дистрибутивность: x(y + w) = xy + xw */
+  ak_mpzn_add_montgomery( c, y, w, ec->p, size );
+  ak_mpzn_mul_montgomery( c, x, c, ec->p, ec->n, size );
+  ak_mpzn_mul_montgomery( d, x, w, ec->p, ec->n, size );
+  ak_mpzn_add_montgomery( d, a, d, ec->p, size );
+  result &= ( ak_mpzn_cmp( c, d, size ) == 0 );
+ /* переход в представление Монтгомери и обратно */
+  ak_mpzn_mul_montgomery( c, x, ec->r2, ec->p, ec->n, size );
+  ak_mpzn_mul_montgomery( c, c, one, ec->p, ec->n, size );
+  result &= ( ak_mpzn_cmp( c, x, size ) == 0 );
+ /* обращение: сравнение с возведением в степень p-2 (и q-2 для порядка подгруппы) */
+  ak_mpzn_set_ui( d, size, 2 );
+  ak_mpzn_sub( d, ec->p, d, size );
+  ak_mpzn_modpow_montgomery( b, x, d, ec->p, ec->n, size, modpow_fixed_window );
+  ak_mpzn_inverse_montgomery( c, x, ec->p, ec->n, ec->r2, size );
+  result &= ( ak_mpzn_cmp( b, c, size ) == 0 );
+  ak_mpzn_modpow_montgomery( b, x, d, ec->p, ec->n, size, modpow_sliding_window );
+  result &= ( ak_mpzn_cmp( b, c, size ) == 0 );
+  ak_mpzn_set_ui( d, size, 2 );
+  ak_mpzn_sub( d, ec->q, d, size );
+  ak_mpzn_rem( a, y, ec->q, size );
+ /* приведение по модулю q методом Барретта: сравнение с ak_mpzn_rem()
+    и с двукратным умножением Монтгомери */
+  ak_mpzn_rem_q( b, y, ec );
+  result &= ( ak_mpzn_cmp( b, ec->q, size ) < 0 );
+  if( ak_mpzn_cmp( a, ec->q, size ) < 0 ) result &= ( ak_mpzn_cmp( a, b, size ) == 0 );
+  ak_mpzn_mul_montgomery( c, y, ec->r2q, ec->q, ec->nq, size );
+  ak_mpzn_mul_montgomery( c, c, one, ec->q, ec->nq, size );
+  result &= ( ak_mpzn_cmp( b, c, size ) == 0 );
+  ak_mpzn_set( a, b, size );
+ /* умножение по модулю q: сравнение с умножением Монтгомери */
+  ak_mpzn_mulmod_q( b, x, y, ec );
+  ak_mpzn_mul_montgomery( c, x, ec->r2q, ec->q, ec->nq, size );
+  ak_mpzn_mul_montgomery( c, c, a, ec->q, ec->nq, size );
+  result &= ( ak_mpzn_cmp( b, c, size ) == 0 );
+  ak_mpzn_modpow_montgomery( b, a, d, ec->q, ec->nq, size, modpow_sliding_window );
+  ak_mpzn_inverse_montgomery( c, a, ec->q, ec->nq, ec->r2q, size );
+  result &= ( ak_mpzn_cmp( b, c, size ) == 0 );
+  ak_mpzn_modpow_montgomery( b, a, d, ec->q, ec->nq, size, modpow_fixed_window );
+  result &= ( ak_mpzn_cmp( b, c, size ) == 0 );
+ /* возведение в произвольную степень двумя способами */
+  ak_mpzn_modpow_montgomery( b, x, y, ec->p, ec->n, size, modpow_fixed_window );
+  ak_mpzn_modpow_montgomery( c, x, y, ec->p, ec->n, size, modpow_sliding_window );
+  result &= ( ak_mpzn_cmp( b, c, size ) == 0 );
+
+ return result;
+}
+
+ int main( void )
+{
+  int i;
+  ak_mpzn512 x, y, w;
+  bool_t extensions;
+  struct random generator;
+  int exitcode = EXIT_SUCCESS;
+  ak_oid oid = NULL;
+
+ /* инициализируем библиотеку */
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+  ak_random_context_create_lcg( &generator );
+  extensions = ak_mpzn_set_montgomery_functions( ak_true );
+  printf("mulx, adcx and adox commands: %s\n", extensions ? "used" : "not used" );
+
+  oid = ak_oid_context_find_by_engine( identifier );
+  while( oid != NULL ) {
+    if( oid->mode == wcurve_params ) {
+      ak_wcurve ec = ( ak_wcurve ) oid->data;
+      bool_t result = ak_true;
+
+     /* граничные значения */
+      ak_mpzn_set_ui( x, ec->size, 1 );
+      ak_mpzn_sub( x, ec->p, x, ec->size );
+      result &= check( x, x, x, ec, extensions );
+      ak_mpzn_set_ui( y, ec->size, 0 );
+      result &= check( x, y, x, ec, extensions );
+     /* случайные значения */
+      for( i = 0; i < 1000; i++ ) {
+         ak_mpzn_set_random_modulo( x, ec->p, ec->size, &generator );
+         ak_mpzn_set_random_modulo( y, ec->p, ec->size, &generator );
+         ak_mpzn_set_random_modulo( w, ec->p, ec->size, &generator );
+         result &= check( x, y, w, ec, extensions );
+      }
+      printf("%s: %s\n", oid->names[0], result ? "Ok" : "Wrong" );
+      if( !result ) exitcode = EXIT_FAILURE;
+    }
+    oid = ak_oid_context_findnext_by_engine( oid, identifier );
+  }
+
+  ak_mpzn_set_montgomery_functions( ak_true );
+  ak_random_context_destroy( &generator );
+  ak_libakrypt_destroy();
+ return exitcode;
+}
@@ -36,6 +36,12 @@
   while( oid != NULL ) { /* генератор найден - тестируем его */
     struct random generator;
 
+   /* генераторы, для создания которых требуются дополнительные параметры
+      (например, путь к сокету сервера) пропускаются */
+    if( oid->func.create == NULL ) {
+      oid = ak_oid_context_findnext_by_engine( oid, random_generator );
+      continue;
+    }
    /* используя oid, создаем объект и вырабатываем случайные данные */
     ak_random_context_create_oid( &generator, oid );
     ak_random_context_random( &generator, data, 32 );
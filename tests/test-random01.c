@@ -10,6 +10,10 @@
  #include <string.h>
  #include <stdlib.h>
  #include <ak_random.h>
+#ifdef LIBAKRYPT_HAVE_SYSRANDOM_H
+ #include <unistd.h>
+ #include <sys/wait.h>
+#endif
 
 /* основная тестирующая функция */
  int test_function( ak_function_random create, const char *result )
@@ -47,6 +51,53 @@
  return retval;
 }
 
+#ifdef LIBAKRYPT_HAVE_SYSRANDOM_H
+/* проверка буффера генератора getrandom: запросы различной длины, пересекающие границы
+   заполнения буффера, и выработка значений родительским и дочерним процессами после fork() */
+ int test_getrandom_buffer( void )
+{
+  pid_t pid;
+  size_t i, len, off = 0;
+  int fd[2], status = 0, retval = ak_true;
+  struct random generator;
+  ak_uint8 buffer[3*4096+100], parent[64], child[64];
+
+  printf("getrandom buffer: "); fflush( stdout );
+  if( ak_random_context_create_getrandom( &generator ) != ak_error_ok ) return ak_false;
+  memset( buffer, 0, sizeof( buffer ));
+  for( i = 0; off < sizeof( buffer ); i++ ) {
+     len = ak_min( 1 + ( i*37 )%150, sizeof( buffer ) - off );
+     if( ak_random_context_random( &generator, buffer+off, ( ssize_t )len ) != ak_error_ok )
+       retval = ak_false;
+     off += len;
+  }
+ /* последовательно выданные фрагменты не должны совпадать */
+  for( off = 32; off + 32 <= sizeof( buffer ); off += 32 )
+     if( memcmp( buffer + off - 32, buffer + off, 32 ) == 0 ) retval = ak_false;
+
+ /* после fork() дочерний процесс не должен выдавать значения из буффера родителя */
+  if( pipe( fd ) != 0 ) { ak_random_context_destroy( &generator ); return ak_false; }
+  if(( pid = fork()) == -1 ) { ak_random_context_destroy( &generator ); return ak_false; }
+  if( pid == 0 ) {
+    close( fd[0] );
+    ak_random_context_random( &generator, child, sizeof( child ));
+    if( write( fd[1], child, sizeof( child )) != ( ssize_t )sizeof( child )) _exit( EXIT_FAILURE );
+    _exit( EXIT_SUCCESS );
+  }
+  close( fd[1] );
+  ak_random_context_random( &generator, parent, sizeof( parent ));
+  if( read( fd[0], child, sizeof( child )) != ( ssize_t )sizeof( child )) retval = ak_false;
+  close( fd[0] );
+  waitpid( pid, &status, 0 );
+  if( !WIFEXITED( status ) || ( WEXITSTATUS( status ) != EXIT_SUCCESS )) retval = ak_false;
+  if( memcmp( parent, child, sizeof( parent )) == 0 ) retval = ak_false;
+
+  ak_random_context_destroy( &generator );
+  if( retval ) printf("Ok\n"); else printf("Wrong\n");
+ return retval;
+}
+#endif
+
  int main( void )
 {
  int error = EXIT_SUCCESS;
@@ -65,11 +116,20 @@
 #if defined(__unix__) || defined(__APPLE__)
  if( test_function( ak_random_context_create_urandom, NULL ) != ak_true ) error = EXIT_FAILURE;
 #endif
+#ifdef LIBAKRYPT_HAVE_SYSRANDOM_H
+ if( test_function( ak_random_context_create_getrandom, NULL ) != ak_true ) error = EXIT_FAILURE;
+ if( test_function( ak_random_context_create_getrandom_unbuffered, NULL ) != ak_true )
+   error = EXIT_FAILURE;
+ if( test_getrandom_buffer( ) != ak_true ) error = EXIT_FAILURE;
+#endif
 
 #ifdef LIBAKRYPT_CRYPTO_FUNCTIONS
  if( test_function( ak_random_context_create_hashrnd,
       "1c48e724f9a72c5889d5b98f2efd54fb7272ca77a056fe1d015a6d7a2ec90cb3" ) != ak_true )
      error = EXIT_FAILURE;
+ if( test_function( ak_random_context_create_ctrrnd,
+      "8c56444a288a35e1ca13b080ee212968968f631dfb9f7d456e5b14b90683c104" ) != ak_true )
+     error = EXIT_FAILURE;
 #endif
 
  ak_libakrypt_destroy();
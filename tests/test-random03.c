@@ -0,0 +1,177 @@
+/* Пример иллюстрирует работу генератора, получающего значения от сервера,
+   доступного через сокет домена unix.
+
+   Программа содержит простейший сервер: на каждый запрос, состоящий из четырех октетов
+   длины (старший октет передается первым), сервер возвращает запрошенное количество
+   октетов последовательности x_k = k mod 251. Поскольку последовательность известна заранее,
+   проверяется, что клиент выдает значения без пропусков и повторов.
+
+   Запуск без параметров: программа запускает сервер в дочернем процессе и тестирует клиента.
+   Запуск с параметром --server <путь>: программа работает только как сервер.
+
+   Внимание! Используются неэкспортируемые функции.
+
+   test-random03.c
+*/
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <signal.h>
+ #include <unistd.h>
+ #include <sys/un.h>
+ #include <sys/wait.h>
+ #include <sys/socket.h>
+ #include <ak_random.h>
+
+/* сервер: обрабатывает клиентов последовательно */
+ static int serve( const char *path )
+{
+  int sd, fd;
+  ak_uint64 k;
+  ssize_t result;
+  struct sockaddr_un addr;
+  ak_uint8 request[4], buffer[4096];
+  size_t size, i, count;
+
+  memset( &addr, 0, sizeof( addr ));
+  addr.sun_family = AF_UNIX;
+  strncpy( addr.sun_path, path, sizeof( addr.sun_path ) - 1 );
+  signal( SIGPIPE, SIG_IGN ); /* клиент может закрыть соединение, не дождавшись ответа */
+  unlink( path );
+  if(( sd = socket( AF_UNIX, SOCK_STREAM, 0 )) == -1 ) return EXIT_FAILURE;
+  if( bind( sd, ( struct sockaddr *)&addr, sizeof( addr )) == -1 ) return EXIT_FAILURE;
+  if( listen( sd, 4 ) == -1 ) return EXIT_FAILURE;
+
+  while(( fd = accept( sd, NULL, NULL )) != -1 ) {
+    k = 0;
+    while( read( fd, request, sizeof( request )) == sizeof( request )) {
+      size = ( (size_t)request[0] << 24 )|( (size_t)request[1] << 16 )|
+                                                     ( (size_t)request[2] << 8 )|request[3];
+      while( size > 0 ) {
+        count = size < sizeof( buffer ) ? size : sizeof( buffer );
+        for( i = 0; i < count; i++, k++ ) buffer[i] = ( ak_uint8 )( k%251 );
+        if(( result = write( fd, buffer, count )) != ( ssize_t )count ) break;
+        size -= count;
+      }
+    }
+    close( fd );
+  }
+  close( sd );
+ return EXIT_SUCCESS;
+}
+
+/* клиент в процессе, порожденном с помощью fork(): значения, полученные родительским процессом,
+   не должны выдаваться повторно; дочерний процесс устанавливает собственное соединение,
+   поэтому получает последовательность с начала */
+ static int test_fork( const char *path )
+{
+  pid_t pid;
+  size_t j;
+  int status = 0, result = ak_true;
+  struct random generator;
+  ak_uint8 buffer[64];
+
+  if( ak_random_context_create_unix_domain_socket( &generator, path, 4096 ) != ak_error_ok )
+    return ak_false;
+  if(( generator.oid == NULL ) || strcmp( generator.oid->names[0], "unix-domain-socket" )) {
+    printf("wrong oid of unix domain socket generator\n");
+    result = ak_false;
+  }
+  if( ak_random_context_random( &generator, buffer, 32 ) != ak_error_ok ) {
+    ak_random_context_destroy( &generator );
+    return ak_false;
+  }
+  if(( pid = fork()) == -1 ) {
+    ak_random_context_destroy( &generator );
+    return ak_false;
+  }
+  if( pid == 0 ) {
+    if( ak_random_context_random( &generator, buffer, sizeof( buffer )) != ak_error_ok )
+      _exit( EXIT_FAILURE );
+    for( j = 0; j < sizeof( buffer ); j++ )
+       if( buffer[j] != ( ak_uint8 )( j%251 )) _exit( EXIT_FAILURE );
+    ak_random_context_destroy( &generator );
+    _exit( EXIT_SUCCESS );
+  }
+
+ /* сервер обслуживает клиентов последовательно: закрываем соединение родительского процесса */
+  ak_random_context_destroy( &generator );
+  waitpid( pid, &status, 0 );
+  if( !WIFEXITED( status ) || ( WEXITSTATUS( status ) != EXIT_SUCCESS )) result = ak_false;
+  printf("generator after fork: ");
+  if( result ) printf("Ok\n"); else printf("Wrong\n");
+ return result;
+}
+
+/* клиент: получает значения запросами разной длины и сравнивает их с ожидаемыми */
+ static int test_client( const char *path, ssize_t bufsize )
+{
+  ak_uint64 k = 0;
+  size_t i, j, len;
+  struct random generator;
+  ak_uint8 buffer[10000];
+  int result = ak_true;
+
+  if( ak_random_context_create_unix_domain_socket( &generator, path, bufsize ) != ak_error_ok )
+    return ak_false;
+  for( i = 0; ( i < 5000 ) && result; i++ ) {
+     len = 1 + ( i*i*7 + 13*i )%sizeof( buffer );
+     if( i%100 == 0 ) len = 32; /* короткие запросы, типичные для выработки масок */
+     if( ak_random_context_random( &generator, buffer, ( ssize_t )len ) != ak_error_ok ) {
+       result = ak_false;
+       break;
+     }
+     for( j = 0; j < len; j++, k++ )
+        if( buffer[j] != ( ak_uint8 )( k%251 )) {
+          printf("wrong value at offset %llu\n", (unsigned long long) k );
+          result = ak_false;
+          break;
+        }
+  }
+  printf("buffer size %d: %llu octets received ", (int) bufsize, (unsigned long long) k );
+  if( result ) printf("Ok\n"); else printf("Wrong\n");
+  ak_random_context_destroy( &generator );
+ return result;
+}
+
+ int main( int argc, char *argv[] )
+{
+  pid_t pid;
+  struct random generator;
+  char path[128];
+  int exitcode = EXIT_SUCCESS, attempts = 0;
+
+  if(( argc == 3 ) && ( strcmp( argv[1], "--server" ) == 0 )) return serve( argv[2] );
+
+  ak_snprintf( path, sizeof( path ), "/tmp/test-random03-%d.socket", (int) getpid( ));
+  if(( pid = fork()) == -1 ) return EXIT_FAILURE;
+  if( pid == 0 ) _exit( serve( path ));
+
+  if( !ak_libakrypt_create( ak_function_log_stderr )) {
+    kill( pid, SIGTERM );
+    return ak_libakrypt_destroy();
+  }
+
+ /* ожидаем запуска сервера */
+  ak_log_set_level( ak_log_none );
+  while( ak_random_context_create_unix_domain_socket( &generator, path, 0 ) != ak_error_ok ) {
+    if( ++attempts > 100 ) { exitcode = EXIT_FAILURE; goto labexit; }
+    usleep( 10000 );
+  }
+  ak_random_context_destroy( &generator );
+  ak_log_set_level( ak_log_standard );
+
+ /* проверяем клиента для буфферов различной длины */
+  if( test_client( path, 0 ) != ak_true ) exitcode = EXIT_FAILURE;
+  if( test_client( path, 4096 ) != ak_true ) exitcode = EXIT_FAILURE;
+  if( test_client( path, 1000 ) != ak_true ) exitcode = EXIT_FAILURE;
+  if( test_fork( path ) != ak_true ) exitcode = EXIT_FAILURE;
+
+  labexit:
+   kill( pid, SIGTERM );
+   waitpid( pid, NULL, 0 );
+   unlink( path );
+   ak_libakrypt_destroy();
+
+ return exitcode;
+}
@@ -0,0 +1,83 @@
+/* Тестовый пример, иллюстрирующий выработку генератором hashrnd последовательностей,
+   длина которых превышает размер внутреннего буфера генератора.
+   Выработанные значения сравниваются с непосредственным вычислением хеш-кодов
+   Стрибог512 от последовательных значений счетчика.
+   Пример использует неэкспортируемые функции.
+
+   test-random04.c
+*/
+
+ #include <stdio.h>
+ #include <string.h>
+ #include <stdlib.h>
+ #include <ak_hash.h>
+ #include <ak_random.h>
+
+/* непосредственное вычисление последовательности, вырабатываемой генератором hashrnd:
+   счетчик представляет собой 64-х октетное число (младшие октеты располагаются первыми),
+   старший октет которого всегда равен нулю */
+ static void hashrnd( ak_uint8 *seed, size_t seed_size, ak_uint8 *out, size_t size )
+{
+  size_t i = 0, len = 0;
+  ak_uint8 counter[64], block[64];
+  struct hash hctx;
+
+  ak_hash_context_create_streebog512( &hctx );
+  ak_hash_context_ptr( &hctx, seed, seed_size, counter, sizeof( counter ));
+  counter[63] = 0;
+  while( size > 0 ) {
+    i = 0;
+    while(( ++counter[i] == 0 ) && ( ++i < 64 ));
+    counter[63] = 0;
+    ak_hash_context_ptr( &hctx, counter, sizeof( counter ), block, sizeof( block ));
+    len = ak_min( size, sizeof( block ));
+    memcpy( out, block, len );
+    out += len;
+    size -= len;
+  }
+  ak_hash_context_destroy( &hctx );
+}
+
+ int main( void )
+{
+  size_t off = 0;
+  int result = EXIT_SUCCESS;
+  struct random rnd;
+  ak_uint8 seed[128], buffer[2526], buffer2[2526], buffer3[2526];
+
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+
+ /* 1. вырабатываем значения эталонным способом */
+  memset( seed, ak_random_value()&0xFF, sizeof( seed ));
+  hashrnd( seed, sizeof( seed ), buffer, sizeof( buffer ));
+
+ /* 2. вырабатываем весь массив за один вызов */
+  if( ak_random_context_create_hashrnd( &rnd ) != ak_error_ok ) goto bad;
+  ak_random_context_randomize( &rnd, seed, sizeof( seed ));
+  ak_random_context_random( &rnd, buffer2, sizeof( buffer2 ));
+  ak_random_context_destroy( &rnd );
+
+ /* 3. вырабатываем тот же массив фрагментами случайной длины */
+  if( ak_random_context_create_hashrnd( &rnd ) != ak_error_ok ) goto bad;
+  ak_random_context_randomize( &rnd, seed, sizeof( seed ));
+  while( off < sizeof( buffer3 )) {
+    size_t len = ak_min( 1 + ak_random_value()%200, sizeof( buffer3 ) - off );
+    ak_random_context_random( &rnd, buffer3+off, ( ssize_t )len );
+    off += len;
+  }
+  ak_random_context_destroy( &rnd );
+
+  printf("one call: ");
+  if( ak_ptr_is_equal( buffer, buffer2, sizeof( buffer ))) printf("Ok\n");
+    else { printf("Wrong\n"); result = EXIT_FAILURE; }
+  printf("chunks:   ");
+  if( ak_ptr_is_equal( buffer, buffer3, sizeof( buffer ))) printf("Ok\n");
+    else { printf("Wrong\n"); result = EXIT_FAILURE; }
+
+  ak_libakrypt_destroy();
+ return result;
+
+ bad:
+  ak_libakrypt_destroy();
+ return EXIT_FAILURE;
+}
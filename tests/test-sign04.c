@@ -0,0 +1,128 @@
+/* Пример иллюстрирует вычисление кратных точек для образующих точек эллиптических кривых
+   с использованием заранее вычисленных таблиц. Для всех кривых, доступных через механизм OID,
+   результат сравнивается с результатом вычислений с помощью лесенки Монтгомери.
+   Также проверяется вычисление суммы кратных двух точек, используемое при проверке подписи,
+   и совпадение небольших кратных точек с результатом последовательного сложения
+   в проективных координатах.
+   Внимание! Используются неэкспортируемые функции.
+
+   test-sign04.c
+*/
+ #include <time.h>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <ak_oid.h>
+ #include <ak_curves.h>
+
+/* сравниваем [k]P, вычисленные двумя способами */
+ static bool_t compare( ak_uint64 *k, ak_wcurve ec )
+{
+  struct wpoint wp, wq;
+
+  ak_wpoint_pow( &wp, &ec->point, k, ec->size, ec );
+  ak_wpoint_reduce( &wp, ec );
+  ak_wpoint_pow_base( &wq, k, ec );
+  ak_wpoint_reduce( &wq, ec );
+  if( ak_mpzn_cmp( wp.x, wq.x, ec->size ) || ak_mpzn_cmp( wp.y, wq.y, ec->size ) ||
+      ak_mpzn_cmp( wp.z, wq.z, ec->size )) return ak_false;
+ return ak_true;
+}
+
+/* сравниваем [k]P + [l]Q, вычисленные двумя способами; в качестве Q берется [k+l]P */
+ static bool_t compare_sum( ak_uint64 *k, ak_uint64 *l, ak_wcurve ec )
+{
+  ak_mpzn512 m;
+  struct wpoint wp, wq, wr;
+
+  ak_mpzn_add( m, k, l, ec->size );
+  ak_wpoint_pow( &wq, &ec->point, m, ec->size, ec );
+  ak_wpoint_reduce( &wq, ec );
+  ak_wpoint_pow_sum( &wr, &ec->point, k, &wq, l, ec->size, ec );
+  ak_wpoint_reduce( &wr, ec );
+
+  ak_wpoint_pow( &wp, &ec->point, k, ec->size, ec );
+  ak_wpoint_pow( &wq, &wq, l, ec->size, ec );
+  ak_wpoint_add( &wp, &wq, ec );
+  ak_wpoint_reduce( &wp, ec );
+  if( ak_mpzn_cmp( wp.x, wr.x, ec->size ) || ak_mpzn_cmp( wp.y, wr.y, ec->size ) ||
+      ak_mpzn_cmp( wp.z, wr.z, ec->size )) return ak_false;
+ return ak_true;
+}
+
+/* сравниваем [k]P, k = 1, ..., 64, с результатом последовательного сложения точек */
+ static bool_t compare_small( ak_wcurve ec )
+{
+  ak_uint64 i;
+  ak_mpzn512 k;
+  struct wpoint wp, wq, wr;
+
+  ak_wpoint_set_as_unit( &wr, ec );
+  for( i = 1; i <= 64; i++ ) {
+     ak_wpoint_add( &wr, &ec->point, ec );
+     ak_wpoint_set_wpoint( &wq, &wr, ec );
+     ak_wpoint_reduce( &wq, ec );
+     ak_mpzn_set_ui( k, ec->size, i );
+     ak_wpoint_pow( &wp, &ec->point, k, ec->size, ec );
+     ak_wpoint_reduce( &wp, ec );
+     if( ak_mpzn_cmp( wp.x, wq.x, ec->size ) || ak_mpzn_cmp( wp.y, wq.y, ec->size ) ||
+         ak_mpzn_cmp( wp.z, wq.z, ec->size )) return ak_false;
+     if( !compare( k, ec )) return ak_false;
+  }
+ return ak_true;
+}
+
+ int main( void )
+{
+  int i;
+  clock_t timea;
+  ak_mpzn512 k, l;
+  struct random generator;
+  int exitcode = EXIT_SUCCESS;
+  ak_oid oid = NULL;
+
+ /* инициализируем библиотеку */
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+  ak_random_context_create_lcg( &generator );
+
+  oid = ak_oid_context_find_by_engine( identifier );
+  while( oid != NULL ) {
+    if( oid->mode == wcurve_params ) {
+      ak_wcurve ec = ( ak_wcurve ) oid->data;
+      bool_t result = ak_true;
+
+     /* первый вызов приводит к вычислению таблицы */
+      timea = clock();
+      ak_mpzn_set_ui( k, ec->size, 1 );
+      result &= compare( k, ec );
+      printf("%s: table created in %.3fs, ", oid->names[0],
+                                                   (double)( clock() - timea )/CLOCKS_PER_SEC );
+     /* небольшие кратные */
+      result &= compare_small( ec );
+     /* граничные значения */
+      ak_mpzn_set_ui( k, ec->size, 0 );
+      result &= compare( k, ec );
+      ak_mpzn_set_ui( k, ec->size, 1 );
+      ak_mpzn_sub( k, ec->q, k, ec->size );
+      result &= compare( k, ec );
+     /* случайные значения */
+      for( i = 0; i < 16; i++ ) {
+         ak_mpzn_set_random_modulo( k, ec->q, ec->size, &generator );
+         result &= compare( k, ec );
+         ak_mpzn_set_random_modulo( l, ec->q, ec->size, &generator );
+         result &= compare_sum( k, l, ec );
+      }
+     /* суммы с нулевой степенью */
+      ak_mpzn_set_ui( l, ec->size, 0 );
+      result &= compare_sum( k, l, ec );
+      result &= compare_sum( l, k, ec );
+      if( result ) printf("Ok\n");
+        else { printf("Wrong\n"); exitcode = EXIT_FAILURE; }
+    }
+    oid = ak_oid_context_findnext_by_engine( oid, identifier );
+  }
+
+  ak_random_context_destroy( &generator );
+  ak_libakrypt_destroy();
+ return exitcode;
+}
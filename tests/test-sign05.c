@@ -0,0 +1,100 @@
+/* Пример иллюстрирует пакетную проверку электронных подписей.
+   Пакет содержит подписи, выработанные несколькими ключами на разных эллиптических кривых;
+   часть подписей искажается. Проверяется, что результаты пакетной проверки совпадают
+   с результатами последовательной проверки и не зависят от количества потоков.
+   Внимание! Используются неэкспортируемые функции.
+
+   test-sign05.c
+*/
+ #include <time.h>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <ak_sign.h>
+ #include <ak_parameters.h>
+
+ #define keys_count     (3)
+ #define items_count  (300)
+
+ int main( void )
+{
+  size_t i, threads, wrong = 0;
+  clock_t timea;
+  struct random generator;
+  struct signkey sk[keys_count];
+  struct verifykey vk[keys_count];
+  struct verifykey_item items[items_count];
+  ak_uint8 key[64], hash[items_count][64], sign[items_count][128];
+  bool_t expected[items_count];
+  int exitcode = EXIT_SUCCESS;
+  ak_wcurve curves[keys_count] = {
+    (ak_wcurve) &id_tc26_gost_3410_2012_256_paramSetA,
+    (ak_wcurve) &id_tc26_gost_3410_2012_512_paramSetA,
+    (ak_wcurve) &id_tc26_gost_3410_2012_256_paramSetA };
+
+ /* инициализируем библиотеку */
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+  ak_random_context_create_lcg( &generator );
+
+ /* создаем ключи */
+  for( i = 0; i < keys_count; i++ ) {
+     ak_random_context_random( &generator, key, sizeof( key ));
+     ak_signkey_context_create( sk+i, curves[i] );
+     ak_signkey_context_set_key( sk+i, key, sizeof( ak_uint64 )*curves[i]->size );
+     ak_verifykey_context_create_from_signkey( vk+i, sk+i );
+  }
+
+ /* вырабатываем подписи, каждую двадцать пятую подпись искажаем */
+  for( i = 0; i < items_count; i++ ) {
+     ak_verifykey_item it = items+i;
+     size_t k = i%keys_count, hsize = sizeof( ak_uint64 )*curves[k]->size;
+
+     ak_random_context_random( &generator, hash[i], hsize );
+     ak_signkey_context_sign_hash( sk+k, hash[i], hsize, sign[i], sizeof( sign[i] ));
+     if( i%25 == 3 ) sign[i][i%( 2*hsize )] ^= 0x01;
+     it->vkey = vk+k;
+     it->hash = hash[i];
+     it->hsize = hsize;
+     it->sign = sign[i];
+  }
+  timea = clock();
+  ak_log_set_level( ak_log_none );
+  for( i = 0; i < items_count; i++ ) {
+     expected[i] = ak_verifykey_context_verify_hash( items[i].vkey,
+                                                  items[i].hash, items[i].hsize, items[i].sign );
+     if( expected[i] != ( i%25 != 3 )) wrong++;
+  }
+  printf("sequential verification: %.3fs, %u wrong results\n",
+                               (double)( clock() - timea )/CLOCKS_PER_SEC, (unsigned int) wrong );
+  if( wrong ) exitcode = EXIT_FAILURE;
+
+ /* пакетная проверка */
+  for( threads = 1; threads < 5; threads += 2 ) {
+     timea = clock();
+     if( ak_verifykey_context_verify_hash_batch( items, items_count, threads ) != ak_error_ok )
+       exitcode = EXIT_FAILURE;
+     for( i = 0, wrong = 0; i < items_count; i++ ) if( items[i].result != expected[i] ) wrong++;
+     printf("batch verification (%u threads): %.3fs, %u wrong results\n", (unsigned int) threads,
+                               (double)( clock() - timea )/CLOCKS_PER_SEC, (unsigned int) wrong );
+     if( wrong ) exitcode = EXIT_FAILURE;
+  }
+
+ /* элемент с некорректными параметрами не влияет на остальные */
+  items[5].hsize = 13;
+  if( ak_verifykey_context_verify_hash_batch( items, items_count, 2 ) != ak_error_wrong_length )
+    exitcode = EXIT_FAILURE;
+  for( i = 0, wrong = 0; i < items_count; i++ )
+     if( items[i].result != ( i == 5 ? ak_false : expected[i] )) wrong++;
+  printf("batch verification with wrong item: %u wrong results\n", (unsigned int) wrong );
+  if( wrong ) exitcode = EXIT_FAILURE;
+  ak_log_set_level( ak_log_standard );
+
+  for( i = 0; i < keys_count; i++ ) {
+     ak_signkey_context_destroy( sk+i );
+     ak_verifykey_context_destroy( vk+i );
+  }
+  ak_random_context_destroy( &generator );
+  if( exitcode == EXIT_SUCCESS ) printf("Ok\n");
+  ak_libakrypt_destroy();
+ return exitcode;
+}
@@ -0,0 +1,100 @@
+/* Пример иллюстрирует вычисления с точками эллиптических кривых в искривленной форме Эдвардса.
+   Для кривых, имеющих форму Эдвардса, проверяется, что переход от формы Вейерштрасса
+   к форме Эдвардса и обратно не изменяет точку, а удвоение и сложение точек в форме Эдвардса
+   дают те же результаты, что и в форме Вейерштрасса.
+   Внимание! Используются неэкспортируемые функции.
+
+   test-sign06.c
+*/
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <ak_curves.h>
+ #include <ak_parameters.h>
+
+/* сравниваем две точки в форме Вейерштрасса */
+ static bool_t is_equal( ak_wpoint wp, ak_wpoint wq, ak_wcurve ec )
+{
+  ak_wpoint_reduce( wp, ec );
+  ak_wpoint_reduce( wq, ec );
+  if( ak_mpzn_cmp( wp->x, wq->x, ec->size ) || ak_mpzn_cmp( wp->y, wq->y, ec->size ) ||
+      ak_mpzn_cmp( wp->z, wq->z, ec->size )) return ak_false;
+ return ak_true;
+}
+
+ static bool_t test_curve( const char *name, ak_wcurve ec )
+{
+  int i;
+  struct epoint ep, eq, eg;
+  struct wpoint wp, wq, wr;
+  bool_t result = ak_true;
+
+  printf("%s: ", name );
+  if( !ak_wcurve_is_edwards( ec )) { printf("no Edwards form, Wrong\n"); return ak_false; }
+  if( ak_wcurve_is_ok( ec ) != ak_error_ok ) { printf("wrong parameters\n"); return ak_false; }
+
+ /* нейтральный элемент */
+  ak_wpoint_set_as_unit( &wp, ec );
+  ak_epoint_set_wpoint( &ep, &wp, ec );
+  ak_wpoint_set_epoint( &wq, &ep, ec );
+  result &= ak_mpzn_cmp_ui( wq.z, ec->size, 0 );
+
+ /* последовательно вычисляем точки [2^i]P и [2^i+1]P двумя способами */
+  ak_wpoint_set( &wp, ec );
+  ak_epoint_set_wpoint( &ep, &wp, ec );
+  ak_epoint_set_wpoint( &eg, &ec->point, ec );
+  for( i = 0; i < 64; i++ ) {
+    /* переход туда и обратно */
+     ak_wpoint_set_epoint( &wq, &ep, ec );
+     ak_wpoint_set_wpoint( &wr, &wp, ec );
+     result &= is_equal( &wr, &wq, ec );
+
+    /* сложение с образующей точкой */
+     ak_wpoint_set_wpoint( &wr, &wp, ec );
+     ak_wpoint_add( &wr, &ec->point, ec );
+     memcpy( &eq, &ep, sizeof( struct epoint ));
+     ak_epoint_add( &eq, &eg, ec );
+     ak_wpoint_set_epoint( &wq, &eq, ec );
+     result &= is_equal( &wr, &wq, ec );
+
+    /* сложение точки с собой и удвоение */
+     memcpy( &eq, &ep, sizeof( struct epoint ));
+     ak_epoint_add( &eq, &ep, ec );
+     ak_epoint_double( &ep, ec );
+     ak_wpoint_double( &wp, ec );
+     ak_wpoint_set_epoint( &wq, &eq, ec );
+     ak_wpoint_set_wpoint( &wr, &wp, ec );
+     result &= is_equal( &wr, &wq, ec );
+     ak_wpoint_set_epoint( &wq, &ep, ec );
+     ak_wpoint_set_wpoint( &wr, &wp, ec );
+     result &= is_equal( &wr, &wq, ec );
+  }
+
+ /* кривая без формы Эдвардса */
+  ak_log_set_level( ak_log_none );
+  if( ak_epoint_set_wpoint( &ep, &wp,
+    ( ak_wcurve ) &id_tc26_gost_3410_2012_512_paramSetA ) != ak_error_curve_not_supported )
+    result = ak_false;
+  ak_log_set_level( ak_log_standard );
+
+  if( result ) printf("Ok\n"); else printf("Wrong\n");
+ return result;
+}
+
+ int main( void )
+{
+  int exitcode = EXIT_SUCCESS;
+
+ /* инициализируем библиотеку */
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+
+  if( !test_curve( "id-tc26-gost-3410-2012-256-paramSetA",
+                      ( ak_wcurve ) &id_tc26_gost_3410_2012_256_paramSetA )) exitcode = EXIT_FAILURE;
+  if( !test_curve( "id-tc26-gost-3410-2012-512-paramSetC",
+                      ( ak_wcurve ) &id_tc26_gost_3410_2012_512_paramSetC )) exitcode = EXIT_FAILURE;
+  if( ak_wcurve_is_edwards(( ak_wcurve ) &id_tc26_gost_3410_2012_512_paramSetA ))
+    exitcode = EXIT_FAILURE;
+
+  ak_libakrypt_destroy();
+ return exitcode;
+}
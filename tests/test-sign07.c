@@ -0,0 +1,90 @@
+/* Пример иллюстрирует выработку электронной подписи с использованием пула заранее
+   вычисленных пар (k, r). Для кривых разных размеров пул пополняется явным вызовом функции
+   и отдельным потоком; проверяется, что все выработанные подписи верны, а пары
+   из пула используются только один раз.
+   Внимание! Используются неэкспортируемые функции.
+
+   test-sign07.c
+*/
+ #include <time.h>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <ak_sign.h>
+ #include <ak_parameters.h>
+
+ #define pool_size     (32)
+ #define signs_count   (96)
+
+ static bool_t test_curve( ak_wcurve wc, bool_t background, ak_random generator )
+{
+  size_t i, wrong = 0, repeated = 0;
+  clock_t timea;
+  struct signkey sk;
+  struct verifykey vk;
+  ak_uint8 key[64], hash[64], sign[signs_count][128];
+  const size_t hsize = sizeof( ak_uint64 )*wc->size;
+
+  ak_random_context_random( generator, key, sizeof( key ));
+  ak_signkey_context_create( &sk, wc );
+  ak_signkey_context_set_key( &sk, key, hsize );
+  ak_verifykey_context_create_from_signkey( &vk, &sk );
+
+  if( ak_signkey_context_create_pool( &sk, pool_size, background ) != ak_error_ok ) {
+    ak_signkey_context_destroy( &sk );
+    ak_verifykey_context_destroy( &vk );
+    return ak_false;
+  }
+  if( !background ) {
+    ak_signkey_context_refill_pool( &sk );
+    if( ak_signkey_context_get_pool_count( &sk ) != pool_size ) wrong++;
+  }
+
+ /* количество подписей превышает размер пула: часть подписей вырабатывается без пула */
+  timea = clock();
+  for( i = 0; i < signs_count; i++ ) {
+     ak_random_context_random( generator, hash, hsize );
+     ak_signkey_context_sign_hash( &sk, hash, hsize, sign[i], sizeof( sign[i] ));
+     if( !ak_verifykey_context_verify_hash( &vk, hash, hsize, sign[i] )) wrong++;
+     if( !background && ( i == pool_size - 1 ) && ak_signkey_context_get_pool_count( &sk ))
+       wrong++;
+  }
+ /* значения r не повторяются */
+  for( i = 1; i < signs_count; i++ )
+     if( !memcmp( sign[i]+hsize, sign[i-1]+hsize, hsize )) repeated++;
+
+  printf("%s (%s): %.3fs, %u wrong, %u repeated\n", wc == ( ak_wcurve )
+         &id_tc26_gost_3410_2012_256_paramSetA ? "256" : "512",
+         background ? "thread" : "refill", (double)( clock() - timea )/CLOCKS_PER_SEC,
+                                                   (unsigned int) wrong, (unsigned int) repeated );
+  ak_signkey_context_destroy( &sk );
+  ak_verifykey_context_destroy( &vk );
+
+ return ( wrong == 0 ) && ( repeated == 0 );
+}
+
+ int main( void )
+{
+  struct random generator;
+  int exitcode = EXIT_SUCCESS;
+
+ /* инициализируем библиотеку */
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+  ak_random_context_create_lcg( &generator );
+
+  if( !test_curve(( ak_wcurve ) &id_tc26_gost_3410_2012_256_paramSetA,
+                                                    ak_false, &generator )) exitcode = EXIT_FAILURE;
+  if( !test_curve(( ak_wcurve ) &id_tc26_gost_3410_2012_512_paramSetA,
+                                                    ak_false, &generator )) exitcode = EXIT_FAILURE;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  if( !test_curve(( ak_wcurve ) &id_tc26_gost_3410_2012_256_paramSetA,
+                                                     ak_true, &generator )) exitcode = EXIT_FAILURE;
+  if( !test_curve(( ak_wcurve ) &id_tc26_gost_3410_2012_512_paramSetA,
+                                                     ak_true, &generator )) exitcode = EXIT_FAILURE;
+#endif
+
+  ak_random_context_destroy( &generator );
+  if( exitcode == EXIT_SUCCESS ) printf("Ok\n");
+  ak_libakrypt_destroy();
+ return exitcode;
+}
@@ -0,0 +1,136 @@
+/* Пример иллюстрирует одновременную выработку электронных подписей в нескольких потоках
+   с использованием пулов заранее вычисленных пар (k, r). Каждый пул пополняется своим
+   фоновым потоком и, одновременно с ним, отдельным потоком, вызывающим функцию
+   ak_signkey_context_refill_pool(). Проверяется, что все выработанные подписи верны,
+   а значения r всех подписей различны.
+   Внимание! Используются неэкспортируемые функции.
+
+   test-sign08.c
+*/
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <ak_sign.h>
+ #include <ak_parameters.h>
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #include <pthread.h>
+#endif
+
+ #define threads_count   (4)
+ #define pool_size       (8)
+ #define signs_count   (100)
+ #define refill_count   (25)
+ #define hsize          (32)
+
+ static struct signkey sk[threads_count];
+ static struct verifykey vk[threads_count];
+ static ak_uint8 sign[threads_count*signs_count][2*hsize];
+
+/* функция потока: вырабатываем подписи и сразу проверяем их */
+ static void *sign_hashes( void *ptr )
+{
+  size_t i, idx = *( size_t *)ptr;
+  ak_uint8 hash[hsize];
+  static int result[threads_count];
+
+  result[idx] = ak_error_ok;
+  for( i = 0; i < signs_count; i++ ) {
+     memset( hash, 0, sizeof( hash ));
+     hash[0] = ( ak_uint8 )i; hash[1] = ( ak_uint8 )idx; hash[2] = 0x5a;
+     if( ak_signkey_context_sign_hash( &sk[idx], hash, hsize,
+                          sign[idx*signs_count + i], 2*hsize ) != ak_error_ok )
+       result[idx] = ak_error_get_value();
+     else
+       if( !ak_verifykey_context_verify_hash( &vk[idx], hash, hsize, sign[idx*signs_count + i] ))
+         result[idx] = ak_error_not_equal_data;
+  }
+ return &result[idx];
+}
+
+/* функция потока: пополняем пул одновременно с фоновым потоком и выработкой подписей */
+ static void *refill_pool( void *ptr )
+{
+  size_t i, idx = *( size_t *)ptr;
+  static int result[threads_count];
+
+  result[idx] = ak_error_ok;
+  for( i = 0; i < refill_count; i++ )
+     if( ak_signkey_context_refill_pool( &sk[idx] ) != ak_error_ok )
+       result[idx] = ak_error_get_value();
+ return &result[idx];
+}
+
+ int main( void )
+{
+  size_t i, j, idx[threads_count];
+  ak_uint8 key[hsize];
+  struct random generator;
+  int exitcode = EXIT_SUCCESS;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_t tid[2*threads_count];
+  void *res = NULL;
+#endif
+
+ /* инициализируем библиотеку */
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+  ak_random_context_create_lcg( &generator );
+
+ /* создаем ключи и пулы */
+  for( i = 0; i < threads_count; i++ ) {
+     idx[i] = i;
+     ak_random_context_random( &generator, key, sizeof( key ));
+     ak_signkey_context_create( &sk[i], ( ak_wcurve ) &id_tc26_gost_3410_2012_256_paramSetA );
+     ak_signkey_context_set_key( &sk[i], key, sizeof( key ));
+     ak_verifykey_context_create_from_signkey( &vk[i], &sk[i] );
+    #ifdef LIBAKRYPT_HAVE_PTHREAD
+     if( ak_signkey_context_create_pool( &sk[i], pool_size, ak_true ) != ak_error_ok )
+    #else
+     if( ak_signkey_context_create_pool( &sk[i], pool_size, ak_false ) != ak_error_ok )
+    #endif
+       exitcode = EXIT_FAILURE;
+  }
+  ak_random_context_destroy( &generator );
+
+ /* запускаем потоки */
+  for( i = 0; i < threads_count; i++ ) {
+    #ifdef LIBAKRYPT_HAVE_PTHREAD
+     if( pthread_create( &tid[2*i], NULL, sign_hashes, &idx[i] ) != 0 ) {
+       printf("thread creation error\n");
+       exitcode = EXIT_FAILURE;
+       tid[2*i] = pthread_self();
+     }
+     if( pthread_create( &tid[2*i+1], NULL, refill_pool, &idx[i] ) != 0 ) {
+       printf("thread creation error\n");
+       exitcode = EXIT_FAILURE;
+       tid[2*i+1] = pthread_self();
+     }
+    #else
+     if( *( int *)refill_pool( &idx[i] ) != ak_error_ok ) exitcode = EXIT_FAILURE;
+     if( *( int *)sign_hashes( &idx[i] ) != ak_error_ok ) exitcode = EXIT_FAILURE;
+    #endif
+  }
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  for( i = 0; i < 2*threads_count; i++ ) {
+     if( pthread_equal( tid[i], pthread_self( ))) continue;
+     pthread_join( tid[i], &res );
+     if( *( int *)res != ak_error_ok ) exitcode = EXIT_FAILURE;
+  }
+#endif
+  printf("signs created: %u\n", threads_count*signs_count );
+
+ /* проверяем, что все значения r различны */
+  for( i = 0; i < threads_count*signs_count; i++ )
+     for( j = i+1; j < threads_count*signs_count; j++ )
+        if( memcmp( sign[i]+hsize, sign[j]+hsize, hsize ) == 0 ) {
+          printf("equal values r for signs %u and %u\n", (unsigned int)i, (unsigned int)j );
+          exitcode = EXIT_FAILURE;
+        }
+
+  for( i = 0; i < threads_count; i++ ) {
+     ak_signkey_context_destroy( &sk[i] );
+     ak_verifykey_context_destroy( &vk[i] );
+  }
+  if( exitcode == EXIT_SUCCESS ) printf("Ok\n");
+  ak_libakrypt_destroy();
+ return exitcode;
+}
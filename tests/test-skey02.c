@@ -0,0 +1,91 @@
+/* Пример иллюстрирует одновременное создание секретных ключей в нескольких потоках.
+   Проверяется, что номера всех созданных ключей различны, а маскирование ключей
+   выполняется генераторами потоков корректно.
+   Внимание! Используются неэкспортируемые функции.
+
+   test-skey02.c
+*/
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <ak_skey.h>
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #include <pthread.h>
+#endif
+
+ #define threads_count  (4)
+ #define keys_count   (500)
+
+ static ak_uint8 numbers[threads_count*keys_count][32];
+ static ak_uint8 testkey[32] = {
+    0xef, 0xcd, 0xab, 0x89, 0x67, 0x45, 0x27, 0x01, 0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe,
+    0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11, 0x00, 0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa, 0x99, 0x28 };
+
+/* функция потока: создаем ключи, меняем их маску и проверяем контрольную сумму */
+ static void *create_keys( void *ptr )
+{
+  struct skey key;
+  size_t i, idx = *( size_t *)ptr;
+  static int result[threads_count];
+
+  result[idx] = ak_error_ok;
+  for( i = 0; i < keys_count; i++ ) {
+     if( ak_skey_context_create( &key, 32 ) != ak_error_ok ) result[idx] = ak_error_get_value();
+     else {
+       if( ak_skey_context_set_key( &key, testkey, 32 ) != ak_error_ok )
+         result[idx] = ak_error_get_value();
+       key.set_mask( &key );
+       if( key.check_icode( &key ) != ak_true ) result[idx] = ak_error_wrong_key_icode;
+       memcpy( numbers[idx*keys_count + i], key.number, 32 );
+       ak_skey_context_destroy( &key );
+     }
+  }
+ return &result[idx];
+}
+
+ int main( void )
+{
+  size_t i, j, idx[threads_count];
+  int exitcode = EXIT_SUCCESS;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_t tid[threads_count];
+  void *res = NULL;
+#endif
+
+ /* инициализируем библиотеку */
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+
+ /* запускаем потоки */
+  for( i = 0; i < threads_count; i++ ) {
+     idx[i] = i;
+    #ifdef LIBAKRYPT_HAVE_PTHREAD
+     if( pthread_create( &tid[i], NULL, create_keys, &idx[i] ) != 0 ) {
+       printf("thread creation error\n");
+       exitcode = EXIT_FAILURE;
+       tid[i] = pthread_self();
+     }
+    #else
+     if( *( int *)create_keys( &idx[i] ) != ak_error_ok ) exitcode = EXIT_FAILURE;
+    #endif
+  }
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  for( i = 0; i < threads_count; i++ ) {
+     if( pthread_equal( tid[i], pthread_self( ))) continue;
+     pthread_join( tid[i], &res );
+     if( *( int *)res != ak_error_ok ) exitcode = EXIT_FAILURE;
+  }
+#endif
+  printf("keys created: %u\n", threads_count*keys_count );
+
+ /* проверяем, что все номера ключей различны */
+  for( i = 0; i < threads_count*keys_count; i++ )
+     for( j = i+1; j < threads_count*keys_count; j++ )
+        if( memcmp( numbers[i], numbers[j], 32 ) == 0 ) {
+          printf("equal numbers for keys %u and %u\n", (unsigned int)i, (unsigned int)j );
+          exitcode = EXIT_FAILURE;
+        }
+
+  if( exitcode == EXIT_SUCCESS ) printf("Ok\n");
+  ak_libakrypt_destroy();
+ return exitcode;
+}